@@ -0,0 +1,266 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark_main.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Benchmarks of the Actuator mixer, one operation is one pass of
+ *             actuatorTask() from an ActuatorDesired update to the servo outputs.
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include <setjmp.h>
+
+#include "openpilot.h"
+#include "actuator.h"
+#include "actuatorcommand.h"
+#include "actuatorsettings.h"
+#include "actuatordesired.h"
+#include "cameradesired.h"
+#include "flightmodesettings.h"
+#include "flightstatus.h"
+#include "manualcontrolcommand.h"
+#include "mixersettings.h"
+#include "mixerstatus.h"
+#include "systemsettings.h"
+#include "sanitycheck.h"
+#include "benchmark.h"
+
+/* Stabilization runs at 500Hz on most targets */
+#define UPDATE_PERIOD_MS 2
+#define NUM_INPUTS       64
+
+/* MODULE_INITCALL() registers it on the flight controller */
+int32_t ActuatorStart();
+
+static pdTASK_CODE actuator_task;
+static jmp_buf task_exit;
+static uint32_t remaining_updates;
+static portTickType ticks;
+static FrameType_t frame_type;
+static ActuatorDesiredData inputs[NUM_INPUTS];
+static uint16_t servo_out[ACTUATORCOMMAND_CHANNEL_NUMELEM];
+
+int32_t EventCallbackDispatch(UAVObjEvent *ev, UAVObjEventCallback cb)
+{
+    // The settings callbacks of the module run right away
+    cb(ev);
+    return pdTRUE;
+}
+
+int xTaskCreate(pdTASK_CODE pvTaskCode, __attribute__((unused)) const char *pcName, __attribute__((unused)) uint16_t usStackDepth,
+                __attribute__((unused)) void *pvParameters, __attribute__((unused)) unsigned int uxPriority, xTaskHandle *pxCreatedTask)
+{
+    actuator_task  = pvTaskCode;
+    *pxCreatedTask = (xTaskHandle)1;
+    return pdTRUE;
+}
+
+/* Every receive is a new ActuatorDesired, the task is left once the run is over */
+int xQueueReceive(__attribute__((unused)) xQueueHandle xQueue, __attribute__((unused)) void *pvBuffer, __attribute__((unused)) portTickType xTicksToWait)
+{
+    if (remaining_updates == 0) {
+        longjmp(task_exit, 1);
+    }
+    ActuatorDesiredSet(&inputs[remaining_updates-- % NUM_INPUTS]);
+    ticks += UPDATE_PERIOD_MS / portTICK_RATE_MS;
+    return pdTRUE;
+}
+
+portTickType xTaskGetTickCount(void)
+{
+    return ticks;
+}
+
+int32_t PIOS_TASK_MONITOR_RegisterTask(__attribute__((unused)) uint16_t task_id, __attribute__((unused)) xTaskHandle handle)
+{
+    return 0;
+}
+
+FrameType_t GetCurrentFrameType()
+{
+    return frame_type;
+}
+
+int32_t AlarmsSet(__attribute__((unused)) SystemAlarmsAlarmElem alarm, __attribute__((unused)) SystemAlarmsAlarmOptions severity)
+{
+    return 0;
+}
+
+SystemAlarmsAlarmOptions AlarmsGet(__attribute__((unused)) SystemAlarmsAlarmElem alarm)
+{
+    return SYSTEMALARMS_ALARM_OK;
+}
+
+int32_t AlarmsClear(__attribute__((unused)) SystemAlarmsAlarmElem alarm)
+{
+    return 0;
+}
+
+void PIOS_Servo_SetHz(__attribute__((unused)) const uint16_t *speeds, __attribute__((unused)) const uint32_t *clock, __attribute__((unused)) uint8_t banks) {}
+
+void PIOS_Servo_Set(uint8_t Servo, uint16_t Position)
+{
+    servo_out[Servo] = Position;
+}
+
+void PIOS_Servo_Update() {}
+
+void PIOS_Servo_SetBankMode(__attribute__((unused)) uint8_t bank, __attribute__((unused)) uint8_t mode) {}
+
+/* two pins per bank, like the 12 outputs of the Revolution */
+uint8_t PIOS_Servo_GetPinBank(uint8_t pin)
+{
+    return pin / 2;
+}
+
+static void set_channels(ActuatorSettingsData *settings, uint8_t first, uint8_t last, int16_t min, int16_t neutral, int16_t max)
+{
+    for (uint8_t i = first; i <= last; i++) {
+        settings->ChannelMin[i]     = min;
+        settings->ChannelNeutral[i] = neutral;
+        settings->ChannelMax[i]     = max;
+        settings->ChannelType[i]    = ACTUATORSETTINGS_CHANNELTYPE_PWM;
+        settings->ChannelAddr[i]    = i;
+    }
+}
+
+static void set_mixer(MixerSettingsData *mixer, uint8_t index, MixerSettingsMixer1TypeOptions type, int8_t curve1, int8_t roll, int8_t pitch, int8_t yaw)
+{
+    // Mixer1Type and Mixer1Vector repeat for each mixer, as actuatorTask() expects
+    MixerSettingsMixer1TypeOptions *types = &mixer->Mixer1Type + index * (sizeof(MixerSettingsMixer1TypeOptions) + sizeof(MixerSettingsMixer1VectorData));
+    MixerSettingsMixer1VectorData *vector  = (MixerSettingsMixer1VectorData *)(types + 1);
+
+    *types = type;
+    vector->ThrottleCurve1 = curve1;
+    vector->ThrottleCurve2 = 0;
+    vector->Roll  = roll;
+    vector->Pitch = pitch;
+    vector->Yaw   = yaw;
+}
+
+/* A quad X on OneShot125 ESCs, armed and flying */
+static void configure_multirotor(void)
+{
+    ActuatorSettingsData settings = { 0 };
+    MixerSettingsData mixer = { 0 };
+
+    set_channels(&settings, 0, ACTUATORCOMMAND_CHANNEL_NUMELEM - 1, 1000, 1000, 1000);
+    set_channels(&settings, 0, 3, 1000, 1000, 2000);
+    for (uint8_t i = 0; i < ACTUATORSETTINGS_BANKMODE_NUMELEM; i++) {
+        settings.BankMode[i] = ACTUATORSETTINGS_BANKMODE_ONESHOT125;
+        settings.BankUpdateFreq[i] = 400;
+    }
+    settings.MotorsSpinWhileArmed = ACTUATORSETTINGS_MOTORSSPINWHILEARMED_TRUE;
+
+    for (uint8_t i = 0; i < MIXERSETTINGS_THROTTLECURVE1_NUMELEM; i++) {
+        mixer.ThrottleCurve1[i] = i * 0.225f;
+        mixer.ThrottleCurve2[i] = i * 0.25f;
+    }
+    mixer.Curve2Source = MIXERSETTINGS_CURVE2SOURCE_THROTTLE;
+    set_mixer(&mixer, 0, MIXERSETTINGS_MIXER1TYPE_MOTOR, 127, 64, 64, -64);
+    set_mixer(&mixer, 1, MIXERSETTINGS_MIXER1TYPE_MOTOR, 127, -64, 64, 64);
+    set_mixer(&mixer, 2, MIXERSETTINGS_MIXER1TYPE_MOTOR, 127, -64, -64, -64);
+    set_mixer(&mixer, 3, MIXERSETTINGS_MIXER1TYPE_MOTOR, 127, 64, -64, 64);
+
+    frame_type = FRAME_TYPE_MULTIROTOR;
+    SystemSettingsData system = { .ThrustControl = SYSTEMSETTINGS_THRUSTCONTROL_THROTTLE };
+    SystemSettingsSet(&system);
+    ActuatorSettingsSet(&settings);
+    MixerSettingsSet(&mixer);
+}
+
+/* A plane with split ailerons and roll differential, on plain PWM */
+static void configure_fixed_wing(void)
+{
+    ActuatorSettingsData settings = { 0 };
+    MixerSettingsData mixer = { 0 };
+
+    set_channels(&settings, 0, ACTUATORCOMMAND_CHANNEL_NUMELEM - 1, 1000, 1000, 1000);
+    set_channels(&settings, 0, 0, 1000, 1000, 2000);
+    set_channels(&settings, 1, 4, 1000, 1500, 2000);
+    for (uint8_t i = 0; i < ACTUATORSETTINGS_BANKMODE_NUMELEM; i++) {
+        settings.BankMode[i] = ACTUATORSETTINGS_BANKMODE_PWM;
+        settings.BankUpdateFreq[i] = 50;
+    }
+    settings.LowThrottleZeroAxis.Roll  = ACTUATORSETTINGS_LOWTHROTTLEZEROAXIS_FALSE;
+    settings.LowThrottleZeroAxis.Pitch = ACTUATORSETTINGS_LOWTHROTTLEZEROAXIS_FALSE;
+    settings.LowThrottleZeroAxis.Yaw   = ACTUATORSETTINGS_LOWTHROTTLEZEROAXIS_FALSE;
+
+    for (uint8_t i = 0; i < MIXERSETTINGS_THROTTLECURVE1_NUMELEM; i++) {
+        mixer.ThrottleCurve1[i] = i * 0.25f;
+        mixer.ThrottleCurve2[i] = i * 0.25f;
+    }
+    mixer.Curve2Source     = MIXERSETTINGS_CURVE2SOURCE_THROTTLE;
+    mixer.RollDifferential = 20;
+    mixer.FirstRollServo   = 2;
+    set_mixer(&mixer, 0, MIXERSETTINGS_MIXER1TYPE_MOTOR, 127, 0, 0, 0);
+    set_mixer(&mixer, 1, MIXERSETTINGS_MIXER1TYPE_SERVO, 0, 127, 0, 0);
+    set_mixer(&mixer, 2, MIXERSETTINGS_MIXER1TYPE_SERVO, 0, 127, 0, 0);
+    set_mixer(&mixer, 3, MIXERSETTINGS_MIXER1TYPE_SERVO, 0, 0, 127, 0);
+    set_mixer(&mixer, 4, MIXERSETTINGS_MIXER1TYPE_SERVO, 0, 0, 0, 127);
+
+    frame_type = FRAME_TYPE_FIXED_WING;
+    SystemSettingsData system = { .ThrustControl = SYSTEMSETTINGS_THRUSTCONTROL_THROTTLE };
+    SystemSettingsSet(&system);
+    ActuatorSettingsSet(&settings);
+    MixerSettingsSet(&mixer);
+}
+
+static void actuator_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    remaining_updates = iterations;
+    // actuatorTask() reads the settings and goes to failsafe once per run before its loop
+    if (!setjmp(task_exit)) {
+        actuator_task(NULL);
+    }
+    bench_consume(servo_out[0]);
+    // Throttle is never cut, the first motor must be above its minimum
+    PIOS_Assert(servo_out[0] > 1000);
+}
+
+int main(void)
+{
+    UAVObjInitialize();
+    // Objects the module reads but other modules register
+    FlightStatusInitialize();
+    FlightModeSettingsInitialize();
+    ManualControlCommandInitialize();
+    MixerStatusInitialize();
+    CameraDesiredInitialize();
+    ActuatorInitialize();
+
+    FlightStatusData status = { .Armed = FLIGHTSTATUS_ARMED_ARMED };
+    FlightStatusSet(&status);
+
+    // Stick inputs sweeping the full range of every axis
+    for (uint32_t i = 0; i < NUM_INPUTS; i++) {
+        float phase = (float)i / NUM_INPUTS;
+        inputs[i].Roll   = 2.0f * phase - 1.0f;
+        inputs[i].Pitch  = 1.0f - 2.0f * phase;
+        inputs[i].Yaw    = (i % 2) ? 0.5f * phase : -0.5f * phase;
+        inputs[i].Thrust = 0.2f + 0.6f * phase;
+    }
+
+    configure_multirotor();
+    ActuatorStart();
+    bench_run("actuatorTask multirotor", actuator_bench, NULL, NULL);
+
+    configure_fixed_wing();
+    bench_run("actuatorTask fixed wing", actuator_bench, NULL, NULL);
+
+    return 0;
+}
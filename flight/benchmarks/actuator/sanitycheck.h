@@ -0,0 +1,38 @@
+/**
+ ******************************************************************************
+ *
+ * @file       sanitycheck.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      sanitycheck.h stand-in for the actuator benchmark, the frame type is set by
+ *             benchmark_main.c
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef SANITYCHECK_H
+#define SANITYCHECK_H
+
+typedef enum {
+    FRAME_TYPE_MULTIROTOR,
+    FRAME_TYPE_HELI,
+    FRAME_TYPE_FIXED_WING,
+    FRAME_TYPE_GROUND,
+    FRAME_TYPE_CUSTOM,
+} FrameType_t;
+
+extern FrameType_t GetCurrentFrameType();
+
+#endif /* SANITYCHECK_H */
@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ *
+ * @file       FreeRTOS.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      FreeRTOS stand-ins shared by the single threaded benchmarks
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#define pvPortMalloc(xSize) (malloc(xSize))
+#define vPortFree(pv)       (free(pv))
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define portMAX_DELAY       0xffffffff
+#define portTICK_RATE_MS    1
+#define tskIDLE_PRIORITY    0
+
+typedef void *xQueueHandle;
+typedef void *xSemaphoreHandle;
+typedef void *xTaskHandle;
+typedef uint32_t portTickType;
+typedef void (*pdTASK_CODE)(void *pvParameters);
+
+/* the benchmarks are single threaded, locking always succeeds */
+static inline xSemaphoreHandle xSemaphoreCreateRecursiveMutex(void)
+{
+    return (xSemaphoreHandle)1;
+}
+static inline int xSemaphoreTakeRecursive(__attribute__((unused)) xSemaphoreHandle xMutex, __attribute__((unused)) unsigned int xBlockTime)
+{
+    return pdTRUE;
+}
+static inline int xSemaphoreGiveRecursive(__attribute__((unused)) xSemaphoreHandle xMutex)
+{
+    return pdTRUE;
+}
+#define vSemaphoreCreateBinary(xSemaphore) ((xSemaphore) = (xSemaphoreHandle)1)
+static inline int xSemaphoreTake(__attribute__((unused)) xSemaphoreHandle xSemaphore, __attribute__((unused)) unsigned int xBlockTime)
+{
+    return pdTRUE;
+}
+static inline int xSemaphoreGive(__attribute__((unused)) xSemaphoreHandle xSemaphore)
+{
+    return pdTRUE;
+}
+static inline xQueueHandle xQueueCreate(__attribute__((unused)) unsigned int uxQueueLength, __attribute__((unused)) unsigned int uxItemSize)
+{
+    return (xQueueHandle)1;
+}
+static inline int xQueueSend(__attribute__((unused)) xQueueHandle xQueue, __attribute__((unused)) const void *pvItemToQueue, __attribute__((unused)) unsigned int xTicksToWait)
+{
+    return pdTRUE;
+}
+
+/* benchmark_main.c drives the tasks and the clock of the benchmark */
+int xTaskCreate(pdTASK_CODE pvTaskCode, const char *pcName, uint16_t usStackDepth, void *pvParameters, unsigned int uxPriority, xTaskHandle *pxCreatedTask);
+int xQueueReceive(xQueueHandle xQueue, void *pvBuffer, portTickType xTicksToWait);
+portTickType xTaskGetTickCount(void);
+
+#endif /* FREERTOS_H */
@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Minimal harness to time flight code natively on the host
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "benchmark.h"
+
+// A timed run must last at least this long to be reported
+#define BENCH_MIN_RUN_NS     200000000ULL
+#define BENCH_MAX_ITERATIONS (1UL << 30)
+
+volatile float bench_sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_run(const char *name, bench_fn_t fn, void (*setup)(void *ctx), void *ctx)
+{
+    uint32_t iterations = 1;
+    uint64_t elapsed;
+
+    for (;;) {
+        if (setup) {
+            setup(ctx);
+        }
+        uint64_t start = now_ns();
+        fn(ctx, iterations);
+        elapsed = now_ns() - start;
+        if (elapsed >= BENCH_MIN_RUN_NS || iterations >= BENCH_MAX_ITERATIONS) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    double ns_per_op = (double)elapsed / iterations;
+    printf("{\"benchmark\": \"%s\", \"iterations\": %u, \"ns_per_op\": %.3f, \"ops_per_s\": %.0f}\n",
+           name, iterations, ns_per_op, ns_per_op > 0.0 ? 1e9 / ns_per_op : 0.0);
+    fflush(stdout);
+}
@@ -0,0 +1,54 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Minimal harness to time flight code natively on the host
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+
+/**
+ * Benchmarked operation, runs the operation iterations times.
+ * The result of the operations should be passed to bench_consume() so the
+ * compiler cannot optimize them away.
+ */
+typedef void (*bench_fn_t)(void *ctx, uint32_t iterations);
+
+/**
+ * Time fn, doubling the iteration count until a run lasts long enough to be
+ * measured, and print the result on stdout as a single line JSON object:
+ *   {"benchmark": "<name>", "iterations": N, "ns_per_op": X, "ops_per_s": Y}
+ * setup is called before each timed run to reset ctx, it may be NULL.
+ */
+void bench_run(const char *name, bench_fn_t fn, void (*setup)(void *ctx), void *ctx);
+
+/**
+ * Keep a value alive.
+ */
+extern volatile float bench_sink;
+static inline void bench_consume(float value)
+{
+    bench_sink = value;
+}
+
+#endif /* BENCHMARK_H */
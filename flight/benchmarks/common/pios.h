@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      pios.h stand-in shared by the benchmarks, the benchmark selects the
+ *             optional PiOS headers in its pios_config.h
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef PIOS_H
+#define PIOS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* PIOS Feature Selection */
+#include <pios_config.h>
+
+#include <FreeRTOS.h>
+#include <pios_helpers.h>
+#include <pios_math.h>
+#include <pios_crc.h>
+
+#define PIOS_Assert(x) \
+    if (!(x)) { while (1) {; } \
+    }
+#define PIOS_DEBUG_Assert(x) PIOS_Assert(x)
+#define PIOS_STATIC_ASSERT(test) ((void)sizeof(int[1 - 2 * !(test)]))
+
+#define pios_malloc(size) (malloc(size))
+
+/* the benchmarks call the initialization of the module themselves */
+#define MODULE_INITCALL(ifn, sfn)
+
+#ifdef PIOS_INCLUDE_TASK_MONITOR
+#include <pios_task_monitor.h>
+#endif
+
+#ifdef PIOS_INCLUDE_CALLBACKSCHEDULER
+#include <pios_callbackscheduler.h>
+#endif
+
+#ifdef PIOS_INCLUDE_DELAY
+#include <pios_delay.h>
+#include <pios_deltatime.h>
+#endif
+
+#ifdef PIOS_INCLUDE_SERVO
+#include <pios_servo.h>
+#endif
+
+#endif /* PIOS_H */
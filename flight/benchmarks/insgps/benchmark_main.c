@@ -0,0 +1,111 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark_main.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Benchmarks of the 13 state INS/GPS EKF used by the state estimation.
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "benchmark.h"
+#include <insgps.h>
+
+// Reset the covariance this often while only predicting, so it does not diverge
+#define COVARIANCE_RESET_ITERATIONS 4096
+
+static float gyro[3]  = { 0.01f, -0.02f, 0.005f };
+static float accel[3] = { 0.1f, -0.05f, -9.81f };
+static float mag[3]   = { 1.0f, 0.0f, 0.0f };
+static float pos[3]   = { 0.0f, 0.0f, 0.0f };
+static float vel[3]   = { 0.0f, 0.0f, 0.0f };
+static float pDiag[13] = { 25.0f, 25.0f, 25.0f, 5.0f, 5.0f, 5.0f, 1e-5f, 1e-5f, 1e-5f, 1e-5f, 1e-9f, 1e-9f, 1e-9f };
+
+static void ins_setup(__attribute__((unused)) void *ctx)
+{
+    INSGPSInit();
+}
+
+static void state_prediction_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        INSStatePrediction(gyro, accel, 0.002f);
+    }
+    bench_consume(Nav.q[0]);
+}
+
+static void covariance_prediction_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (i % COVARIANCE_RESET_ITERATIONS == 0) {
+            INSResetP(pDiag);
+        }
+        INSCovariancePrediction(0.002f);
+    }
+    INSGetP(pDiag);
+    bench_consume(pDiag[0]);
+}
+
+static void correction_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        INSCorrection(mag, pos, vel, 0.0f, FULL_SENSORS);
+    }
+    bench_consume(Nav.Pos[0]);
+}
+
+static void mag_correction_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        INSCorrection(mag, pos, vel, 0.0f, MAG_SENSORS);
+    }
+    bench_consume(Nav.q[0]);
+}
+
+static void gps_baro_correction_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        INSCorrection(mag, pos, vel, 0.0f, HORIZ_SENSORS | VERT_SENSORS | BARO_SENSOR);
+    }
+    bench_consume(Nav.Pos[0]);
+}
+
+static void filter_cycle_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        INSStatePrediction(gyro, accel, 0.002f);
+        INSCovariancePrediction(0.002f);
+        INSCorrection(mag, pos, vel, 0.0f, FULL_SENSORS);
+    }
+    bench_consume(Nav.Pos[0]);
+}
+
+int main(void)
+{
+    bench_run("INSStatePrediction", state_prediction_bench, ins_setup, NULL);
+    bench_run("INSCovariancePrediction", covariance_prediction_bench, ins_setup, NULL);
+    bench_run("INSCorrection", correction_bench, ins_setup, NULL);
+    bench_run("INSCorrectionMag", mag_correction_bench, ins_setup, NULL);
+    bench_run("INSCorrectionGpsBaro", gps_baro_correction_bench, ins_setup, NULL);
+    bench_run("INSFilterCycle", filter_cycle_bench, ins_setup, NULL);
+
+    return 0;
+}
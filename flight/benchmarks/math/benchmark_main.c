@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark_main.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Benchmarks of the math library: the PID controllers used by the
+ *             stabilization and path follower loops and the Butterworth filter.
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "openpilot.h"
+#include "benchmark.h"
+
+#include <math.h>
+#include <pid.h>
+#include <butterworth.h>
+
+#define NUM_INPUTS 1024
+
+static float inputs[NUM_INPUTS];
+
+struct pid_ctx {
+    struct pid pid;
+    pid_scaler scaler;
+};
+
+static void pid_setup(void *ctx)
+{
+    struct pid_ctx *c = ctx;
+
+    pid_configure(&c->pid, 0.003f, 0.003f, 0.00002f, 0.3f);
+    pid_zero(&c->pid);
+    c->scaler.p = 1.0f;
+    c->scaler.i = 1.0f;
+    c->scaler.d = 1.0f;
+}
+
+static void pid_apply_setpoint_bench(void *ctx, uint32_t iterations)
+{
+    struct pid_ctx *c = ctx;
+    float out = 0.0f;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        out += pid_apply_setpoint(&c->pid, &c->scaler, inputs[i % NUM_INPUTS], inputs[(i + 7) % NUM_INPUTS], 0.002f, true);
+    }
+    bench_consume(out);
+}
+
+static void pid2_setup(void *ctx)
+{
+    struct pid2 *pid = ctx;
+
+    pid2_configure(pid, 0.25f, 0.01f, 0.0f, 0.05f, 0.1f, 0.002f, 0.8f, 0.5f, 0.0f, 1.0f);
+}
+
+static void pid2_apply_bench(void *ctx, uint32_t iterations)
+{
+    struct pid2 *pid = ctx;
+    float out = 0.0f;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        out += pid2_apply(pid, inputs[i % NUM_INPUTS], inputs[(i + 7) % NUM_INPUTS], 0.0f, 1.0f);
+    }
+    bench_consume(out);
+}
+
+struct butterworth_ctx {
+    struct ButterWorthDF2Filter filter;
+    float wn1;
+    float wn2;
+};
+
+static void butterworth_setup(void *ctx)
+{
+    struct butterworth_ctx *c = ctx;
+
+    InitButterWorthDF2Filter(0.05f, &c->filter);
+    InitButterWorthDF2Values(0.0f, &c->filter, &c->wn1, &c->wn2);
+}
+
+static void butterworth_bench(void *ctx, uint32_t iterations)
+{
+    struct butterworth_ctx *c = ctx;
+    float out = 0.0f;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        out += FilterButterWorthDF2(inputs[i % NUM_INPUTS], &c->filter, &c->wn1, &c->wn2);
+    }
+    bench_consume(out);
+}
+
+int main(void)
+{
+    struct pid_ctx pid;
+    struct pid2 pid2;
+    struct butterworth_ctx butterworth;
+
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        inputs[i] = sinf(i * 0.05f) * 100.0f;
+    }
+
+    pid_configure_derivative(0.0f, 1.0f);
+    bench_run("pid_apply_setpoint", pid_apply_setpoint_bench, pid_setup, &pid);
+    bench_run("pid2_apply", pid2_apply_bench, pid2_setup, &pid2);
+    bench_run("FilterButterWorthDF2", butterworth_bench, butterworth_setup, &butterworth);
+
+    return 0;
+}
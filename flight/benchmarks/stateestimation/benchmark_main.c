@@ -0,0 +1,235 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark_main.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Benchmarks of the StateEstimation filter chains, one operation is
+ *             one sensor update followed by one pass of StateEstimationCb().
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "openpilot.h"
+#include "stateestimation.h"
+#include "accelsensor.h"
+#include "altitudefiltersettings.h"
+#include "attitudesettings.h"
+#include "attitudestate.h"
+#include "barosensor.h"
+#include "ekfconfiguration.h"
+#include "flightstatus.h"
+#include "gpssettings.h"
+#include "gyrosensor.h"
+#include "homelocation.h"
+#include "magsensor.h"
+#include "revocalibration.h"
+#include "revosettings.h"
+#include <pios_notify.h>
+#include "benchmark.h"
+
+/* The gyros and accels of the Revolution run at 500Hz */
+#define UPDATE_PERIOD_US 2000
+#define MAG_DIVIDER      5
+#define BARO_DIVIDER     10
+#define NUM_INPUTS       64
+/* covers the boot delay of the callback and the gyro calibration of filtercf */
+#define WARMUP_UPDATES   6000
+
+/* MODULE_INITCALL() registers them on the flight controller */
+int32_t StateEstimationInitialize(void);
+int32_t StateEstimationStart(void);
+
+static DelayedCallback state_estimation_cb;
+static uint32_t now_us;
+static uint32_t update_count;
+static GyroSensorData gyro_inputs[NUM_INPUTS];
+
+int32_t EventCallbackDispatch(UAVObjEvent *ev, UAVObjEventCallback cb)
+{
+    // sensorUpdatedCb() and the settings callbacks run right away
+    cb(ev);
+    return pdTRUE;
+}
+
+DelayedCallbackInfo *PIOS_CALLBACKSCHEDULER_Create(DelayedCallback cb, __attribute__((unused)) DelayedCallbackPriority priority,
+                                                   __attribute__((unused)) DelayedCallbackPriorityTask priorityTask,
+                                                   __attribute__((unused)) int16_t callbackID, __attribute__((unused)) uint32_t stacksize)
+{
+    state_estimation_cb = cb;
+    return (DelayedCallbackInfo *)1;
+}
+
+/* sensor_update() runs the callback once per update */
+int32_t PIOS_CALLBACKSCHEDULER_Schedule(__attribute__((unused)) DelayedCallbackInfo *cbinfo, __attribute__((unused)) int32_t milliseconds,
+                                        __attribute__((unused)) DelayedCallbackUpdateMode updatemode)
+{
+    return 1;
+}
+
+int32_t PIOS_CALLBACKSCHEDULER_Dispatch(__attribute__((unused)) DelayedCallbackInfo *cbinfo)
+{
+    return 1;
+}
+
+uint32_t PIOS_DELAY_GetRaw()
+{
+    return now_us;
+}
+
+uint32_t PIOS_DELAY_DiffuS(uint32_t raw)
+{
+    return now_us - raw;
+}
+
+portTickType xTaskGetTickCount(void)
+{
+    return now_us / 1000 / portTICK_RATE_MS;
+}
+
+void PIOS_NOTIFY_StartNotification(__attribute__((unused)) pios_notify_notification notification, __attribute__((unused)) pios_notify_priority priority) {}
+
+int32_t AlarmsSet(__attribute__((unused)) SystemAlarmsAlarmElem alarm, __attribute__((unused)) SystemAlarmsAlarmOptions severity)
+{
+    return 0;
+}
+
+SystemAlarmsAlarmOptions AlarmsGet(__attribute__((unused)) SystemAlarmsAlarmElem alarm)
+{
+    return SYSTEMALARMS_ALARM_OK;
+}
+
+int32_t AlarmsClear(__attribute__((unused)) SystemAlarmsAlarmElem alarm)
+{
+    return 0;
+}
+
+/* A level board at rest, gyros last as the filters expect */
+static void sensor_update(void)
+{
+    update_count++;
+    now_us += UPDATE_PERIOD_US;
+
+    AccelSensorData accel = { .x = 0.0f, .y = 0.0f, .z = -9.81f, .temperature = 25.0f };
+    AccelSensorSet(&accel);
+    if (update_count % MAG_DIVIDER == 0) {
+        float be[3];
+        HomeLocationBeGet(be);
+        MagSensorData mag = { .x = be[0], .y = be[1], .z = be[2], .temperature = 25.0f };
+        MagSensorSet(&mag);
+    }
+    if (update_count % BARO_DIVIDER == 0) {
+        BaroSensorData baro = { .Altitude = 100.0f, .Temperature = 25.0f, .Pressure = 100.1f };
+        BaroSensorSet(&baro);
+    }
+    GyroSensorData *gyro = &gyro_inputs[update_count % NUM_INPUTS];
+    gyro->SensorReadTimestamp = now_us;
+    GyroSensorSet(gyro);
+
+    state_estimation_cb();
+}
+
+static void state_estimation_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) {
+        sensor_update();
+    }
+    AttitudeStateData attitude;
+    AttitudeStateGet(&attitude);
+    bench_consume(attitude.q1);
+    // The board is level and points north, the attitude must have converged
+    PIOS_Assert(attitude.q1 > 0.9f && fabsf(attitude.Roll) < 5.0f && fabsf(attitude.Pitch) < 5.0f);
+}
+
+static void select_fusion_algorithm(RevoSettingsFusionAlgorithmOptions algorithm)
+{
+    RevoSettingsData settings;
+
+    RevoSettingsGet(&settings);
+    settings.FusionAlgorithm = algorithm;
+    RevoSettingsSet(&settings);
+    for (uint32_t i = 0; i < WARMUP_UPDATES; i++) {
+        sensor_update();
+    }
+}
+
+int main(void)
+{
+    UAVObjInitialize();
+    // Objects the module reads but other modules register
+    AccelSensorInitialize();
+    AttitudeSettingsInitialize();
+    FlightStatusInitialize();
+    SystemAlarmsInitialize();
+    StateEstimationInitialize();
+
+    // Defaults of the object definitions
+    RevoSettingsData revo = {
+        .BaroGPSOffsetCorrectionAlpha       = 0.99993f,
+        .MagnetometerMaxDeviation           = { .Warning = 0.05f, .Error = 0.15f },
+        .VelocityPostProcessingLowPassAlpha = 0.3f,
+        .FusionAlgorithm = REVOSETTINGS_FUSIONALGORITHM_NONE,
+    };
+    RevoSettingsSet(&revo);
+    HomeLocationData home = { .Be = { 22000.0f, 1000.0f, 42000.0f }, .g_e = 9.81f, .Set = HOMELOCATION_SET_TRUE };
+    HomeLocationSet(&home);
+    AttitudeSettingsData attitude = {
+        .AccelKp = 0.05f,
+        .AccelKi = 0.0001f,
+        .MagKp   = 0.01f,
+        .MagKi   = 0.000001f,
+        .AccelTau = 0.1f,
+        .YawBiasRate = 0.000001f,
+        .BoardSteadyMaxVariance = 5.0f,
+        .ZeroDuringArming = ATTITUDESETTINGS_ZERODURINGARMING_TRUE,
+        .InitialZeroWhenBoardSteady = ATTITUDESETTINGS_INITIALZEROWHENBOARDSTEADY_TRUE,
+    };
+    AttitudeSettingsSet(&attitude);
+    AltitudeFilterSettingsData altitude = { .AccelLowPassKp = 0.04f, .AccelDriftKi = 0.0005f, .InitializationAccelDriftKi = 0.0f, .BaroKp = 0.04f };
+    AltitudeFilterSettingsSet(&altitude);
+    RevoCalibrationData calibration = { .MagBiasNullingRate = 0.0f };
+    RevoCalibrationSet(&calibration);
+    EKFConfigurationData ekf = {
+        .P     = { 10.0f, 10.0f, 10.0f, 1.0f, 1.0f, 1.0f, 0.007f, 0.007f, 0.007f, 0.007f, 1e-6f, 1e-6f, 1e-6f },
+        .Q     = { 0.01f, 0.01f, 0.01f, 0.01f, 0.01f, 0.01f, 1e-6f, 1e-6f, 1e-6f },
+        .R     = { 1.0f, 1.0f, 1e6f, 0.001f, 0.001f, 0.001f, 10.0f, 10.0f, 10.0f, 0.01f },
+        .FakeR = { 10.0f, 1.0f, 1000.0f },
+    };
+    EKFConfigurationSet(&ekf);
+    GPSSettingsData gps = { .MaxPDOP = 3.5f, .MinSatellites = 7 };
+    GPSSettingsSet(&gps);
+    // filterekf ignores the mags until they are reported good
+    SystemAlarmsAlarmData alarms = { .Magnetometer = SYSTEMALARMS_ALARM_OK };
+    SystemAlarmsAlarmSet(&alarms);
+
+    // Gyro noise of a board at rest
+    for (uint32_t i = 0; i < NUM_INPUTS; i++) {
+        float phase = (float)i / NUM_INPUTS;
+        gyro_inputs[i].x = 0.2f * phase - 0.1f;
+        gyro_inputs[i].y = 0.1f - 0.2f * phase;
+        gyro_inputs[i].z = (i % 2) ? 0.05f : -0.05f;
+        gyro_inputs[i].temperature = 25.0f;
+    }
+
+    StateEstimationStart();
+
+    select_fusion_algorithm(REVOSETTINGS_FUSIONALGORITHM_BASICCOMPLEMENTARY);
+    bench_run("StateEstimationCb complementary", state_estimation_bench, NULL, NULL);
+
+    select_fusion_algorithm(REVOSETTINGS_FUSIONALGORITHM_INS13INDOOR);
+    bench_run("StateEstimationCb INS13 indoor", state_estimation_bench, NULL, NULL);
+
+    return 0;
+}
@@ -0,0 +1,33 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios_config.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      pios_config.h stand-in for the StateEstimation benchmark, the
+ *             sensor options of Revolution
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef PIOS_CONFIG_H
+#define PIOS_CONFIG_H
+
+#define PIOS_INCLUDE_CALLBACKSCHEDULER
+#define PIOS_INCLUDE_DELAY
+#define PIOS_INCLUDE_HMC5X83
+#define PIOS_SENSOR_RATE 500.0f
+
+#endif /* PIOS_CONFIG_H */
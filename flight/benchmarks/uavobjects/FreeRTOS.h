@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ *
+ * @file       FreeRTOS.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      FreeRTOS stand-ins for the uavobjects benchmark, backed by pthreads
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include <stdlib.h>
+#include <pthread.h>
+#define pvPortMalloc(xSize) (malloc(xSize))
+#define vPortFree(pv)       (free(pv))
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define portMAX_DELAY       0xffffffff
+#define portTICK_RATE_MS    1
+
+typedef void *xQueueHandle;
+typedef pthread_mutex_t *xSemaphoreHandle;
+typedef uint32_t portTickType;
+
+/* the object manager lock is a real recursive mutex, the benchmark tasks are threads */
+static inline xSemaphoreHandle xSemaphoreCreateRecursiveMutex(void)
+{
+    pthread_mutexattr_t attr;
+    xSemaphoreHandle mutex = malloc(sizeof(pthread_mutex_t));
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    // FreeRTOS mutexes use priority inheritance
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return mutex;
+}
+static inline int xSemaphoreTakeRecursive(xSemaphoreHandle xMutex, __attribute__((unused)) unsigned int xBlockTime)
+{
+    return pthread_mutex_lock(xMutex) == 0 ? pdTRUE : pdFALSE;
+}
+static inline int xSemaphoreGiveRecursive(xSemaphoreHandle xMutex)
+{
+    return pthread_mutex_unlock(xMutex) == 0 ? pdTRUE : pdFALSE;
+}
+static inline int xQueueSend(__attribute__((unused)) xQueueHandle xQueue, __attribute__((unused)) const void *pvItemToQueue, __attribute__((unused)) unsigned int xTicksToWait)
+{
+    return pdTRUE;
+}
+static inline portTickType xTaskGetTickCount(void)
+{
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark_main.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Lock wait seen by the StabilizationDesired -> ActuatorDesired chain
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "openpilot.h"
+#include "uavobjectsinit.h"
+#include "uavobjectprivate.h"
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Models the single core flight controller: the stabilization task runs at
+ * the highest priority, wakes up periodically, reads StabilizationDesired and
+ * writes and reads back ActuatorDesired (as the actuator task does). Two lower
+ * priority tasks keep writing objects meanwhile, one updating
+ * StabilizationDesired like manualcontrol does and one unpacking and packing
+ * a large settings object like telemetry does. Every read of the chain is
+ * timed, the time above the uncontended copy is the lock wait.
+ *
+ * The "locked" variant takes the object manager lock around the reads, which
+ * is what UAVObjGetData() did before the seqlock reads.
+ */
+
+#define BENCH_NUM_HANDLES     (NELEMENTS(object_ids) + 2)
+#define CHAIN_ITERATIONS      20000
+#define CHAIN_PERIOD_NS       100000
+#define STABDESIRED_NUMBYTES  20
+#define ACTDESIRED_NUMBYTES   24
+#define SETTINGS_NUMBYTES     UAVOBJECTS_LARGEST
+
+static const uint32_t object_ids[] = { 0x1B2C3D10, 0x2C3D4E20, 0x3D4E5F30, 0x4E5F6040 };
+
+UAVObjHandle bench_handles[BENCH_NUM_HANDLES] __attribute__((section("_uavo_handles")));
+
+static UAVObjHandle stabDesired;
+static UAVObjHandle actDesired;
+static UAVObjHandle settings;
+static volatile bool running;
+static uint64_t samples[2 * CHAIN_ITERATIONS];
+
+int32_t EventCallbackDispatch(__attribute__((unused)) UAVObjEvent *ev, __attribute__((unused)) UAVObjEventCallback cb)
+{
+    return pdTRUE;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void *manualcontrol_task(__attribute__((unused)) void *arg)
+{
+    uint8_t data[STABDESIRED_NUMBYTES] = { 0 };
+
+    while (running) {
+        data[0]++;
+        UAVObjSetData(stabDesired, data);
+    }
+    return NULL;
+}
+
+static void *telemetry_task(__attribute__((unused)) void *arg)
+{
+    uint8_t data[SETTINGS_NUMBYTES] = { 0 };
+
+    while (running) {
+        data[0]++;
+        UAVObjUnpack(settings, 0, data);
+        UAVObjPack(settings, 0, data);
+    }
+    return NULL;
+}
+
+static void read_object(UAVObjHandle obj, void *data, bool locked)
+{
+    if (locked) {
+        lockInstanceData();
+        UAVObjGetData(obj, data);
+        unlockInstanceData();
+    } else {
+        UAVObjGetData(obj, data);
+    }
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void chain_bench(const char *name, bool locked)
+{
+    uint8_t stab[STABDESIRED_NUMBYTES];
+    uint8_t act[ACTDESIRED_NUMBYTES] = { 0 };
+    pthread_t tasks[2];
+    pthread_attr_t attr;
+    struct timespec wakeup;
+    uint32_t n = 0;
+
+    // The writers run at normal priority, below the stabilization task
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    running = true;
+    pthread_create(&tasks[0], &attr, manualcontrol_task, NULL);
+    pthread_create(&tasks[1], &attr, telemetry_task, NULL);
+    pthread_attr_destroy(&attr);
+
+    clock_gettime(CLOCK_MONOTONIC, &wakeup);
+    for (uint32_t i = 0; i < CHAIN_ITERATIONS; i++) {
+        wakeup.tv_nsec += CHAIN_PERIOD_NS;
+        if (wakeup.tv_nsec >= 1000000000L) {
+            wakeup.tv_nsec -= 1000000000L;
+            wakeup.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
+
+        // stabilization
+        uint64_t start = now_ns();
+        read_object(stabDesired, stab, locked);
+        samples[n++] = now_ns() - start;
+        act[0] = stab[0];
+        UAVObjSetData(actDesired, act);
+
+        // actuator
+        start = now_ns();
+        read_object(actDesired, act, locked);
+        samples[n++] = now_ns() - start;
+    }
+
+    running = false;
+    pthread_join(tasks[0], NULL);
+    pthread_join(tasks[1], NULL);
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    qsort(samples, n, sizeof(samples[0]), compare_samples);
+    printf("{\"benchmark\": \"%s\", \"iterations\": %u, \"mean_ns\": %.1f, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}\n",
+           name, n, (double)sum / n, (unsigned long long)samples[n * 99 / 100],
+           (unsigned long long)samples[n * 999 / 1000], (unsigned long long)samples[n - 1]);
+    fflush(stdout);
+}
+
+int main(void)
+{
+    struct sched_param param = { .sched_priority = sched_get_priority_max(SCHED_FIFO) };
+
+    UAVObjInitialize();
+    stabDesired = UAVObjRegister(object_ids[0], true, false, false, STABDESIRED_NUMBYTES, NULL);
+    actDesired  = UAVObjRegister(object_ids[1], true, false, false, ACTDESIRED_NUMBYTES, NULL);
+    settings    = UAVObjRegister(object_ids[2], true, true, false, SETTINGS_NUMBYTES, NULL);
+
+    // The main thread is the stabilization task, it preempts the others
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        fprintf(stderr, "warning: no realtime priority, the waits include scheduling noise\n");
+    }
+
+    chain_bench("StabilizationDesired->ActuatorDesired locked reads", true);
+    chain_bench("StabilizationDesired->ActuatorDesired seqlock reads", false);
+    bench_consume(0.0f);
+
+    return 0;
+}
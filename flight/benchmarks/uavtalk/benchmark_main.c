@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark_main.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Benchmarks of the UAVTalk packet encoder and parser, with the object manager
+ *             backing the objects like on the flight controller.
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "openpilot.h"
+#include "uavobjectsinit.h"
+#include "benchmark.h"
+
+static const uint32_t object_ids[] = {
+    0x0A1B2C00, 0x1B2C3D10, 0x2C3D4E20, 0x3D4E5F30, 0x4E5F6040, 0x5F607150, 0x60718260, 0x71829370,
+};
+/* a mix of small state objects and larger settings objects */
+static const uint32_t object_sizes[] = { 12, 16, 24, 36, 48, 64, 128, UAVOBJECTS_LARGEST };
+
+#define BENCH_NUM_OBJECTS NELEMENTS(object_ids)
+#define BENCH_NUM_HANDLES (BENCH_NUM_OBJECTS + 2)
+#define STREAM_SIZE       4096
+#define RX_CHUNK_SIZE     64
+
+UAVObjHandle bench_handles[BENCH_NUM_HANDLES] __attribute__((section("_uavo_handles")));
+
+static UAVTalkConnection connection;
+static uint8_t stream[STREAM_SIZE];
+static uint32_t stream_length;
+
+int32_t EventCallbackDispatch(__attribute__((unused)) UAVObjEvent *ev, __attribute__((unused)) UAVObjEventCallback cb)
+{
+    return pdTRUE;
+}
+
+/* the ack and request timeouts never expire */
+portTickType xTaskGetTickCount(void)
+{
+    return 0;
+}
+
+static int32_t discard_output(__attribute__((unused)) uint8_t *data, int32_t length)
+{
+    return length;
+}
+
+static int32_t capture_output(uint8_t *data, int32_t length)
+{
+    if (stream_length + length > STREAM_SIZE) {
+        return -1;
+    }
+    memcpy(&stream[stream_length], data, length);
+    stream_length += length;
+    return length;
+}
+
+static void uavtalk_setup(__attribute__((unused)) void *ctx)
+{
+    uint8_t data[UAVOBJECTS_LARGEST];
+
+    UAVObjInitialize();
+    for (uint32_t i = 0; i < BENCH_NUM_OBJECTS; i++) {
+        bench_handles[i] = UAVObjRegister(object_ids[i], true, false, false, object_sizes[i], NULL);
+        for (uint32_t j = 0; j < object_sizes[i]; j++) {
+            data[j] = (uint8_t)(i + j);
+        }
+        UAVObjSetData(bench_handles[i], data);
+    }
+
+    // Record one packet per object as the input of the parser benchmark
+    connection    = UAVTalkInitialize(capture_output);
+    stream_length = 0;
+    for (uint32_t i = 0; i < BENCH_NUM_OBJECTS; i++) {
+        UAVTalkSendObject(connection, bench_handles[i], 0, false, 0);
+    }
+}
+
+static void send_object_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    UAVTalkSetOutputStream(connection, discard_output);
+    for (uint32_t i = 0; i < iterations; i++) {
+        UAVTalkSendObject(connection, bench_handles[i % BENCH_NUM_OBJECTS], 0, false, 0);
+    }
+}
+
+static void process_stream_bench(__attribute__((unused)) void *ctx, uint32_t iterations)
+{
+    UAVTalkStats stats;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t pos = 0; pos < stream_length; pos += RX_CHUNK_SIZE) {
+            uint32_t length = stream_length - pos;
+            UAVTalkProcessInputStream(connection, &stream[pos], length < RX_CHUNK_SIZE ? length : RX_CHUNK_SIZE);
+        }
+    }
+    UAVTalkGetStats(connection, &stats, true);
+    bench_consume((float)stats.rxObjects);
+    PIOS_Assert(stats.rxErrors == 0 && stats.rxCrcErrors == 0);
+}
+
+int main(void)
+{
+    bench_run("UAVTalkSendObject", send_object_bench, uavtalk_setup, NULL);
+    // One operation is the parsing and unpacking of one packet of every object
+    bench_run("UAVTalkProcessInputStream", process_stream_bench, uavtalk_setup, NULL);
+
+    return 0;
+}
@@ -40,25 +40,33 @@
 #define NUMW 9 // number of plant noise inputs, w is disturbance noise vector
 #define NUMV 10 // number of measurements, v is the measurement noise vector
 #define NUMU 6 // number of deterministic inputs, U is the input vector
+#define NUMP (NUMX * (NUMX + 1) / 2) // number of stored elements of the symmetric P
+// index of P[i][j] in the upper triangle storage of P, i <= j
+#define PIDX(i, j) ((i) * (2 * NUMX - (i) + 1) / 2 + (j) - (i))
 #pragma GCC optimize "O3"
 // Private functions
-void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
-                          float Q[NUMW], float dT, float P[NUMX][NUMX]);
+static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
+                                 float Q[NUMW], float dT, float P[NUMP]);
 static void SerialUpdate(float H[NUMV][NUMX], float R[NUMV], float Z[NUMV],
-                         float Y[NUMV], float P[NUMX][NUMX], float X[NUMX],
+                         float Y[NUMV], float P[NUMP], float X[NUMX],
                          uint16_t SensorsUsed);
 static void RungeKutta(float X[NUMX], float U[NUMU], float dT);
 static void StateEq(float X[NUMX], float U[NUMU], float Xdot[NUMX]);
 static void LinearizeFG(float X[NUMX], float U[NUMU], float F[NUMX][NUMX],
                         float G[NUMX][NUMW]);
-static void MeasurementEq(float X[NUMX], float Be[3], float Y[NUMV]);
+static void MeasurementEq(float X[NUMX], float H[NUMV][NUMX], float Y[NUMV],
+                          uint16_t SensorsUsed);
 static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX]);
 
 // Private variables
 
 // speed optimizations, describe matrix sparsity
 // derived from state equations in
-// LinearizeFG() and LinearizeH():
+// LinearizeFG() and LinearizeH().
+// The sparsity of F and G is built into CovariancePrediction()
+// by insgps13state_gen.py, keep it in sync with LinearizeFG().
+// The sparsity of H is built into SerialUpdate(): rows 0-5 pick
+// a single state, row 9 is -Pz, only rows 6-8 (mag) are stored:
 //
 // usage F:        usage G:   usage H:
 // -0123456789abc  012345678  0123456789abc
@@ -76,15 +84,6 @@ static void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX]);
 // b.............  ......oXo
 // c.............  ......ooX
 
-static int8_t FrowMin[NUMX] = { 3, 4, 5, 6, 6, 6, 5, 5, 5, 5, 13, 13, 13 };
-static int8_t FrowMax[NUMX] = { 3, 4, 5, 9, 9, 9, 12, 12, 12, 12, -1, -1, -1 };
-
-static int8_t GrowMin[NUMX] = { 9, 9, 9, 3, 3, 3, 0, 0, 0, 0, 6, 7, 8 };
-static int8_t GrowMax[NUMX] = { -1, -1, -1, 5, 5, 5, 2, 2, 2, 2, 6, 7, 8 };
-
-static int8_t HrowMin[NUMV] = { 0, 1, 2, 3, 4, 5, 6, 6, 6, 2 };
-static int8_t HrowMax[NUMV] = { 0, 1, 2, 3, 4, 5, 9, 9, 9, 2 };
-
 static struct EKFData {
     // linearized system matrices
     float F[NUMX][NUMX];
@@ -92,8 +91,8 @@ static struct EKFData {
     float H[NUMV][NUMX];
     // local magnetic unit vector in NED frame
     float Be[3];
-    // covariance matrix and state vector
-    float P[NUMX][NUMX];
+    // covariance matrix, upper triangle only, see PIDX(), and state vector
+    float P[NUMP];
     float X[NUMX];
     // input noise and measurement noise variances
     float Q[NUMW];
@@ -119,8 +118,7 @@ void INSGPSInit() // pretty much just a place holder for now
 
     for (int i = 0; i < NUMX; i++) {
         for (int j = 0; j < NUMX; j++) {
-            ekf.P[i][j] = 0.0f; // zero all terms
-            ekf.F[i][j] = 0.0f;
+            ekf.F[i][j] = 0.0f; // zero all terms
         }
 
         for (int j = 0; j < NUMW; j++) {
@@ -139,12 +137,14 @@ void INSGPSInit() // pretty much just a place holder for now
     for (int i = 0; i < NUMV; i++) {
         ekf.R[i] = 0.0f;
     }
+    for (int i = 0; i < NUMP; i++) {
+        ekf.P[i] = 0.0f;
+    }
 
-
-    ekf.P[0][0]   = ekf.P[1][1] = ekf.P[2][2] = 25.0f;            // initial position variance (m^2)
-    ekf.P[3][3]   = ekf.P[4][4] = ekf.P[5][5] = 5.0f;             // initial velocity variance (m/s)^2
-    ekf.P[6][6]   = ekf.P[7][7] = ekf.P[8][8] = ekf.P[9][9] = 1e-5f;  // initial quaternion variance
-    ekf.P[10][10] = ekf.P[11][11] = ekf.P[12][12] = 1e-9f; // initial gyro bias variance (rad/s)^2
+    ekf.P[PIDX(0, 0)]   = ekf.P[PIDX(1, 1)] = ekf.P[PIDX(2, 2)] = 25.0f;            // initial position variance (m^2)
+    ekf.P[PIDX(3, 3)]   = ekf.P[PIDX(4, 4)] = ekf.P[PIDX(5, 5)] = 5.0f;             // initial velocity variance (m/s)^2
+    ekf.P[PIDX(6, 6)]   = ekf.P[PIDX(7, 7)] = ekf.P[PIDX(8, 8)] = ekf.P[PIDX(9, 9)] = 1e-5f;  // initial quaternion variance
+    ekf.P[PIDX(10, 10)] = ekf.P[PIDX(11, 11)] = ekf.P[PIDX(12, 12)] = 1e-9f; // initial gyro bias variance (rad/s)^2
 
     ekf.X[0]  = ekf.X[1] = ekf.X[2] = ekf.X[3] = ekf.X[4] = ekf.X[5] = 0.0f; // initial pos and vel (m)
     ekf.X[6]  = 1.0f;
@@ -170,10 +170,10 @@ void INSResetP(float PDiag[NUMX])
     // if PDiag[i] nonzero then clear row and column and set diagonal element
     for (i = 0; i < NUMX; i++) {
         if (PDiag != 0) {
-            for (j = 0; j < NUMX; j++) {
-                ekf.P[i][j] = ekf.P[j][i] = 0.0f;
+            for (j = i; j < NUMX; j++) {
+                ekf.P[PIDX(i, j)] = 0.0f;
             }
-            ekf.P[i][i] = PDiag[i];
+            ekf.P[PIDX(i, i)] = PDiag[i];
         }
     }
 }
@@ -185,7 +185,7 @@ void INSGetP(float PDiag[NUMX])
     // retrieve diagonal elements (aka state variance)
     if (PDiag != 0) {
         for (i = 0; i < NUMX; i++) {
-            PDiag[i] = ekf.P[i][i];
+            PDiag[i] = ekf.P[PIDX(i, i)];
         }
     }
 }
@@ -212,13 +212,12 @@ void INSPosVelReset(float pos[3], float vel[3])
 {
     for (int i = 0; i < 6; i++) {
         for (int j = i; j < NUMX; j++) {
-            ekf.P[i][j] = 0; // zero the first 6 rows and columns
-            ekf.P[j][i] = 0;
+            ekf.P[PIDX(i, j)] = 0; // zero the first 6 rows and columns
         }
     }
 
-    ekf.P[0][0] = ekf.P[1][1] = ekf.P[2][2] = 25; // initial position variance (m^2)
-    ekf.P[3][3] = ekf.P[4][4] = ekf.P[5][5] = 5; // initial velocity variance (m/s)^2
+    ekf.P[PIDX(0, 0)] = ekf.P[PIDX(1, 1)] = ekf.P[PIDX(2, 2)] = 25; // initial position variance (m^2)
+    ekf.P[PIDX(3, 3)] = ekf.P[PIDX(4, 4)] = ekf.P[PIDX(5, 5)] = 5; // initial velocity variance (m/s)^2
 
     ekf.X[0]    = pos[0];
     ekf.X[1]    = pos[1];
@@ -399,9 +398,11 @@ void INSCorrection(float mag_data[3], float Pos[3], float Vel[3],
     // barometric altimeter in meters and in local NED frame
     Z[9] = BaroAlt;
 
-    // EKF correction step
-    LinearizeH(ekf.X, ekf.Be, ekf.H);
-    MeasurementEq(ekf.X, ekf.Be, Y);
+    // EKF correction step, only the magnetometer needs a linearization
+    if (SensorsUsed & MAG_SENSORS) {
+        LinearizeH(ekf.X, ekf.Be, ekf.H);
+    }
+    MeasurementEq(ekf.X, ekf.H, Y, SensorsUsed);
     SerialUpdate(ekf.H, ekf.R, Z, Y, ekf.P, ekf.X, SensorsUsed);
 
     float invqmag = invsqrtf(ekf.X[6] * ekf.X[6] + ekf.X[7] * ekf.X[7] + ekf.X[8] * ekf.X[8] + ekf.X[9] * ekf.X[9]);
@@ -425,96 +426,7 @@ void INSCorrection(float mag_data[3], float Pos[3], float Vel[3],
     Nav.gyro_bias[2] = ekf.X[12];
 }
 
-// *************  CovariancePrediction *************
-// Does the prediction step of the Kalman filter for the covariance matrix
-// Output, Pnew, overwrites P, the input covariance
-// Pnew = (I+F*T)*P*(I+F*T)' + T^2*G*Q*G'
-// Q is the discrete time covariance of process noise
-// Q is vector of the diagonal for a square matrix with
-// dimensions equal to the number of disturbance noise variables
-// The General Method is very inefficient,not taking advantage of the sparse F and G
-// The first Method is very specific to this implementation
-// ************************************************
-
-void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
-                          float Q[NUMW], float dT, float P[NUMX][NUMX])
-{
-    // Pnew = (I+F*T)*P*(I+F*T)' + (T^2)*G*Q*G' = (T^2)[(P/T + F*P)*(I/T + F') + G*Q*G')]
-
-    const float dT1  = 1.0f / dT; // multiplication is faster than division on fpu.
-    const float dTsq = dT * dT;
-
-    float Dummy[NUMX][NUMX];
-    int8_t i;
-    int8_t k;
-
-    for (i = 0; i < NUMX; i++) { // Calculate Dummy = (P/T +F*P)
-        float *Firow = F[i];
-        float *Pirow = P[i];
-        float *Dirow = Dummy[i];
-        const int8_t Fistart = FrowMin[i];
-        const int8_t Fiend   = FrowMax[i];
-        int8_t j;
-
-        for (j = 0; j < NUMX; j++) {
-            Dirow[j] = Pirow[j] * dT1; // Dummy = P / T ...
-        }
-        for (k = Fistart; k <= Fiend; k++) {
-            for (j = 0; j < NUMX; j++) {
-                Dirow[j] += Firow[k] * P[k][j]; // [] + F * P
-            }
-        }
-    }
-    for (i = 0; i < NUMX; i++) { // Calculate Pnew = (T^2) [Dummy/T + Dummy*F' + G*Qw*G']
-        float *Dirow = Dummy[i];
-        float *Girow = G[i];
-        float *Pirow = P[i];
-        const int8_t Gistart = GrowMin[i];
-        const int8_t Giend   = GrowMax[i];
-        int8_t j;
-
-
-        for (j = i; j < NUMX; j++) { // Use symmetry, ie only find upper triangular
-            float Ptmp         = Dirow[j] * dT1; // Pnew = Dummy / T ...
-
-            const float *Fjrow = F[j];
-            int8_t Fjstart     = FrowMin[j];
-            int8_t Fjend       = FrowMax[j];
-            k = Fjstart;
-
-            while (k <= Fjend - 3) {
-                Ptmp += Dirow[k] * Fjrow[k]; // [] + Dummy*F' ...
-                Ptmp += Dirow[k + 1] * Fjrow[k + 1];
-                Ptmp += Dirow[k + 2] * Fjrow[k + 2];
-                Ptmp += Dirow[k + 3] * Fjrow[k + 3];
-                k    += 4;
-            }
-            while (k <= Fjend) {
-                Ptmp += Dirow[k] * Fjrow[k];
-                k++;
-            }
-
-            float *Gjrow = G[j];
-            const int8_t Gjstart = MAX(Gistart, GrowMin[j]);
-            const int8_t Gjend   = MIN(Giend, GrowMax[j]);
-            k = Gjstart;
-            while (k <= Gjend - 2) {
-                Ptmp += Q[k] * Girow[k] * Gjrow[k]; // [] + G*Q*G' ...
-                Ptmp += Q[k + 1] * Girow[k + 1] * Gjrow[k + 1];
-                Ptmp += Q[k + 2] * Girow[k + 2] * Gjrow[k + 2];
-                k    += 3;
-            }
-            if (k <= Gjend) {
-                Ptmp += Q[k] * Girow[k] * Gjrow[k];
-                if (k <= Gjend - 1) {
-                    Ptmp += Q[k + 1] * Girow[k + 1] * Gjrow[k + 1];
-                }
-            }
-
-            P[j][i] = Pirow[j] = Ptmp * dTsq; // [] * (T^2)
-        }
-    }
-}
+#include "insgps13state_kernels.h"
 
 // *************  SerialUpdate *******************
 // Does the update step of the Kalman filter for the covariance and estimate
@@ -530,46 +442,93 @@ void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
 // - or see Simon, "Optimal State Estimation," 1st Ed, p.150
 // The SensorsUsed variable is a bitwise mask indicating which sensors
 // should be used in the update.
+// Every measurement type has its own kernel for H*P and H*P*H':
+// GPS position and velocity and the altimeter observe a single state,
+// so H*P is a row of P, only the magnetometer rows of H are dense.
 // ************************************************
+
+// Copy row k of the symmetric P out of its upper triangle storage
+static inline void GetProw(const float P[NUMP], uint8_t k, float Prow[NUMX])
+{
+    const float *Pkrow = &P[PIDX(k, k)];
+    uint8_t j;
+
+    for (j = 0; j < k; j++) {
+        Prow[j] = P[PIDX(j, k)];
+    }
+    for (j = k; j < NUMX; j++) {
+        Prow[j] = Pkrow[j - k];
+    }
+}
+
+// Update P and X with one scalar measurement, HP = H*P, HPHR = H*P*H' + R
+static inline void ScalarUpdate(float *restrict P, float *restrict X, const float *restrict HP,
+                                float HPHR, float Error)
+{
+    const float invHPHR = 1.0f / HPHR;
+    float Km[NUMX];
+    float *Pij = P;
+    uint8_t i, j;
+
+    for (i = 0; i < NUMX; i++) {
+        Km[i] = HP[i] * invHPHR; // find K = HP/HPHR
+    }
+    for (i = 0; i < NUMX; i++) { // Find P(m)= P(m-1) + K*HP
+        for (j = i; j < NUMX; j++) {
+            *Pij++ -= Km[i] * HP[j];
+        }
+    }
+    for (i = 0; i < NUMX; i++) { // Find X(m)= X(m-1) + K*Error
+        X[i] += Km[i] * Error;
+    }
+}
+
 void SerialUpdate(float H[NUMV][NUMX], float R[NUMV], float Z[NUMV],
-                  float Y[NUMV], float P[NUMX][NUMX], float X[NUMX],
+                  float Y[NUMV], float P[NUMP], float X[NUMX],
                   uint16_t SensorsUsed)
 {
-    float HP[NUMX], HPHR, Error;
-    uint8_t i, j, k, m;
-    float Km[NUMX];
+    float HP[NUMX];
+    uint8_t j, k, m;
+
+    // GPS position and velocity, H[m][m] = 1
+    for (m = 0; m < 6; m++) {
+        if (SensorsUsed & (0x01 << m)) {
+            GetProw(P, m, HP);
+            ScalarUpdate(P, X, HP, HP[m] + R[m], Z[m] - Y[m]);
+        }
+    }
 
-    for (m = 0; m < NUMV; m++) {
-        if (SensorsUsed & (0x01 << m)) { // use this sensor for update
-            for (j = 0; j < NUMX; j++) { // Find Hp = H*P
-                HP[j] = 0;
+    // magnetometer, H[m][6..9]
+    for (m = 6; m < 9; m++) {
+        if (SensorsUsed & (0x01 << m)) {
+            float HPHR = R[m];
+
+            for (j = 0; j < NUMX; j++) {
+                HP[j] = 0.0f;
             }
+            for (k = 6; k <= 9; k++) {
+                const float Hmk    = H[m][k];
+                const float *Pkrow = &P[PIDX(k, k)];
 
-            for (k = HrowMin[m]; k <= HrowMax[m]; k++) {
-                for (j = 0; j < NUMX; j++) { // Find Hp = H*P
-                    HP[j] += H[m][k] * P[k][j];
+                for (j = 0; j < k; j++) { // Find Hp = H*P, P[k][j] = P[j][k] below the diagonal
+                    HP[j] += Hmk * P[PIDX(j, k)];
                 }
-            }
-            HPHR = R[m]; // Find  HPHR = H*P*H' + R
-            for (k = HrowMin[m]; k <= HrowMax[m]; k++) {
-                HPHR += HP[k] * H[m][k];
-            }
-            float invHPHR = 1.0f / HPHR;
-            for (k = 0; k < NUMX; k++) {
-                Km[k] = HP[k] * invHPHR; // find K = HP/HPHR
-            }
-            for (i = 0; i < NUMX; i++) { // Find P(m)= P(m-1) + K*HP
-                for (j = i; j < NUMX; j++) {
-                    P[i][j] = P[j][i] = P[i][j] - Km[i] * HP[j];
+                for (j = k; j < NUMX; j++) {
+                    HP[j] += Hmk * Pkrow[j - k];
                 }
             }
-
-            Error = Z[m] - Y[m];
-            for (i = 0; i < NUMX; i++) { // Find X(m)= X(m-1) + K*Error
-                X[i] = X[i] + Km[i] * Error;
+            for (k = 6; k <= 9; k++) { // Find  HPHR = H*P*H' + R
+                HPHR += HP[k] * H[m][k];
             }
+            ScalarUpdate(P, X, HP, HPHR, Z[m] - Y[m]);
         }
     }
+
+    // altimeter, H[9][2] = -1: HP = -P[2], the sign cancels in K*HP
+    if (SensorsUsed & BARO_SENSOR) {
+        GetProw(P, 2, HP);
+        ScalarUpdate(P, X, HP, HP[2] + R[9], Y[9] - Z[9]);
+    }
 }
 
 // *************  RungeKutta **********************
@@ -625,8 +584,8 @@ void RungeKutta(float X[NUMX], float U[NUMU], float dT)
 // MagFields are unit vectors
 // Xdot is output of StateEq()
 // F and G are outputs of LinearizeFG(), all elements not set should be zero
-// y is output of OutputEq()
-// H is output of LinearizeH(), all elements not set should be zero
+// y is output of MeasurementEq()
+// H is output of LinearizeH(), only the magnetometer rows are used
 // ************************************************
 
 static void StateEq(float X[NUMX], float U[NUMU], float Xdot[NUMX])
@@ -776,15 +735,11 @@ void LinearizeFG(float X[NUMX], float U[NUMU], float F[NUMX][NUMX],
     // G[13][9]=G[14][10]=G[15][11]=1;  // NO BIAS STATES ON ACCELS
 }
 
-void MeasurementEq(float X[NUMX], float Be[3], float Y[NUMV])
+// The magnetometer rows of Y are quadratic forms in q, so Y = (H*q)/2
+// and the products already in H are reused
+void MeasurementEq(float X[NUMX], float H[NUMV][NUMX], float Y[NUMV],
+                   uint16_t SensorsUsed)
 {
-    float q0, q1, q2, q3;
-
-    q0   = X[6];
-    q1   = X[7];
-    q2   = X[8];
-    q3   = X[9];
-
     // first six outputs are P and V
     Y[0] = X[0];
     Y[1] = X[1];
@@ -794,23 +749,18 @@ void MeasurementEq(float X[NUMX], float Be[3], float Y[NUMV])
     Y[5] = X[5];
 
     // Bb=Rbe*Be
-    Y[6] =
-        (q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * Be[0] +
-        2.0f * (q1 * q2 + q0 * q3) * Be[1] + 2.0f * (q1 * q3 -
-                                                     q0 * q2) * Be[2];
-    Y[7] =
-        2.0f * (q1 * q2 - q0 * q3) * Be[0] + (q0 * q0 - q1 * q1 +
-                                              q2 * q2 - q3 * q3) * Be[1] +
-        2.0f * (q2 * q3 + q0 * q1) * Be[2];
-    Y[8] =
-        2.0f * (q1 * q3 + q0 * q2) * Be[0] + 2.0f * (q2 * q3 -
-                                                     q0 * q1) * Be[1] +
-        (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3) * Be[2];
+    if (SensorsUsed & MAG_SENSORS) {
+        for (uint8_t m = 6; m < 9; m++) {
+            Y[m] = 0.5f * (H[m][6] * X[6] + H[m][7] * X[7] + H[m][8] * X[8] + H[m][9] * X[9]);
+        }
+    }
 
     // Alt = -Pz
     Y[9] = -1.0f * X[2];
 }
 
+// Only the magnetometer rows, the others are built into SerialUpdate().
+// They share four distinct elements, dBb/dq is a signed permutation of them
 void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX])
 {
     float q0, q1, q2, q3;
@@ -820,27 +770,24 @@ void LinearizeH(float X[NUMX], float Be[3], float H[NUMV][NUMX])
     q2 = X[8];
     q3 = X[9];
 
-    // dP/dP=I;
-    H[0][0] = H[1][1] = H[2][2] = 1.0f;
-    // dV/dV=I;
-    H[3][3] = H[4][4] = H[5][5] = 1.0f;
-
     // dBb/dq
-    H[6][6] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
-    H[6][7] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
-    H[6][8] = 2.0f * (-q2 * Be[0] + q1 * Be[1] - q0 * Be[2]);
-    H[6][9] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
-    H[7][6] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
-    H[7][7] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
-    H[7][8] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
-    H[7][9] = 2.0f * (-q0 * Be[0] - q3 * Be[1] + q2 * Be[2]);
-    H[8][6] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
-    H[8][7] = 2.0f * (q3 * Be[0] - q0 * Be[1] - q1 * Be[2]);
-    H[8][8] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
-    H[8][9] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
-
-    // dAlt/dPz = -1
-    H[9][2] = -1.0f;
+    const float a = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
+    const float b = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+    const float c = 2.0f * (-q2 * Be[0] + q1 * Be[1] - q0 * Be[2]);
+    const float d = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
+
+    H[6][6] = a;
+    H[6][7] = b;
+    H[6][8] = c;
+    H[6][9] = d;
+    H[7][6] = d;
+    H[7][7] = -c;
+    H[7][8] = b;
+    H[7][9] = -a;
+    H[8][6] = -c;
+    H[8][7] = -d;
+    H[8][8] = a;
+    H[8][9] = b;
 }
 
 /**
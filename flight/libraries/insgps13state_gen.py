@@ -0,0 +1,186 @@
+#!/usr/bin/env python
+#
+# Generates insgps13state_kernels.h, the unrolled linear algebra kernels of
+# the 13 state INS/GPS EKF in insgps13state.c.
+#
+# The kernels are specialized to the sparsity of the F, G and H matrices as
+# filled in by LinearizeFG() and LinearizeH(). Any change to the state model
+# there must be reflected in the tables below and the header regenerated:
+#
+#   python flight/libraries/insgps13state_gen.py > flight/libraries/insgps13state_kernels.h
+#
+# (C) 2016, The LibrePilot Project, http://www.librepilot.org
+# See also: The GNU Public License (GPL) Version 3
+#
+
+import sys
+
+NUMX = 13  # number of states
+NUMW = 9   # number of plant noise inputs
+
+# Nonzero elements of F, (row, col): 1 marks elements that are always 1.0
+F = {}
+for i in range(3):
+    F[(i, i + 3)] = 1                  # dPos/dVel
+for i in range(3, 6):
+    for k in range(6, 10):
+        F[(i, k)] = 0                  # dVdot/dq
+for i in range(6, 10):
+    for k in range(6, 13):
+        if k != i:
+            F[(i, k)] = 0              # dqdot/dq, diagonal is zero, and dqdot/dwbias
+
+# Nonzero elements of G, same convention
+G = {}
+for i in range(3, 6):
+    for k in range(3, 6):
+        G[(i, k)] = 0                  # dVdot/dna
+for i in range(6, 10):
+    for k in range(3):
+        G[(i, k)] = 0                  # dqdot/dnw
+for i in range(3):
+    G[(10 + i, 6 + i)] = 1             # dwbias = random walk noise
+
+
+def fcols(i):
+    return [k for k in range(NUMX) if (i, k) in F]
+
+
+def gcols(i):
+    return [k for k in range(NUMW) if (i, k) in G]
+
+
+def p(i, j):
+    """Element of the symmetric covariance, only the upper triangle is stored"""
+    if i > j:
+        i, j = j, i
+    return "P[PIDX(%d, %d)]" % (i, j)
+
+
+def f(i, k):
+    return "F[%d][%d]" % (i, k)
+
+
+def gq(i, k):
+    return "GQ%d_%d" % (i, k)
+
+
+def product(coef, one, term):
+    return term if one else "%s * %s" % (coef, term)
+
+
+def wrap(terms, pad):
+    """Join terms with +, four terms per line, continuation lines start at pad"""
+    lines = []
+    for n in range(0, len(terms), 4):
+        lines.append(" + ".join(terms[n:n + 4]))
+    return ("\n%s+ " % pad).join(lines)
+
+
+def emit_sum(out, lhs, terms):
+    """Emit lhs = sum of terms"""
+    head = "    %s = " % lhs
+    out.append(head + wrap(terms, " " * (len(head) - 2)) + ";")
+
+
+def covariance_prediction():
+    out = []
+    frows = [i for i in range(NUMX) if fcols(i)]
+
+    # D = F*P is only needed where it enters P*F' + F*P or F*P*F'
+    needed = set()
+    for i in range(NUMX):
+        for j in range(i, NUMX):
+            if i in frows:
+                needed.add((i, j))
+                for k in fcols(j):
+                    needed.add((i, k))
+            if j in frows:
+                needed.add((j, i))
+
+    out.append("// *************  CovariancePrediction *************")
+    out.append("// Does the prediction step of the Kalman filter for the covariance matrix")
+    out.append("// Output, Pnew, overwrites P, the input covariance")
+    out.append("// Pnew = (I+F*T)*P*(I+F*T)' + T^2*G*Q*G'")
+    out.append("//      = P + T*(F*P + P*F') + T^2*(F*P*F' + G*Q*G')")
+    out.append("// Q is the discrete time covariance of process noise")
+    out.append("// Q is vector of the diagonal for a square matrix with")
+    out.append("// dimensions equal to the number of disturbance noise variables")
+    out.append("// Only the upper triangle of the symmetric P is stored and updated,")
+    out.append("// every product is unrolled over the nonzero elements of F and G")
+    out.append("// ************************************************")
+    out.append("")
+    out.append("static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],")
+    out.append("                                 float Q[NUMW], float dT, float P[NUMP])")
+    out.append("{")
+    out.append("    const float dTsq = dT * dT;")
+    out.append("    float D[%d][NUMX]; // D = F*P, the remaining rows of F are zero" % (max(frows) + 1))
+    out.append("")
+    out.append("    // D = F*P")
+    for i in frows:
+        for j in range(NUMX):
+            if (i, j) in needed:
+                terms = [product(f(i, k), F[(i, k)], p(k, j)) for k in fcols(i)]
+                emit_sum(out, "D[%d][%d]" % (i, j), terms)
+    out.append("")
+    out.append("    // GQ = G*Q")
+    for i in range(NUMX):
+        for k in gcols(i):
+            if not G[(i, k)]:
+                out.append("    const float %s = G[%d][%d] * Q[%d];" % (gq(i, k), i, k, k))
+    out.append("")
+    out.append("    // Pnew = P + T*(D + D') + T^2*(D*F' + GQ*G')")
+    for i in range(NUMX):
+        for j in range(i, NUMX):
+            first = []
+            if i == j and i in frows:
+                first.append("2.0f * D[%d][%d]" % (i, i))
+            else:
+                if i in frows:
+                    first.append("D[%d][%d]" % (i, j))
+                if j in frows:
+                    first.append("D[%d][%d]" % (j, i))
+            second = []
+            if i in frows:
+                second += [product(f(j, k), F[(j, k)], "D[%d][%d]" % (i, k)) for k in fcols(j)]
+            for k in gcols(i):
+                if (j, k) in G:
+                    gqik = "Q[%d]" % k if G[(i, k)] else gq(i, k)
+                    second.append(product("G[%d][%d]" % (j, k), G[(j, k)], gqik))
+            if not first and not second:
+                continue
+            head = "    %s += " % p(i, j)
+            pad  = " " * len(head)
+            text = head
+            if first:
+                text += "dT * (%s)" % " + ".join(first)
+                if second:
+                    text += "\n%s  + " % pad[:-2]
+            if second:
+                if len(second) > 1:
+                    text += "dTsq * (" + wrap(second, pad + " " * 6) + ")"
+                else:
+                    text += "dTsq * %s" % second[0]
+            out += (text + ";").split("\n")
+    out.append("}")
+    return out
+
+
+def main():
+    out = []
+    out.append("/*")
+    out.append(" * Generated by insgps13state_gen.py, do not edit.")
+    out.append(" * Unrolled kernels of the 13 state INS/GPS EKF, included by insgps13state.c")
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef INSGPS13STATE_KERNELS_H")
+    out.append("#define INSGPS13STATE_KERNELS_H")
+    out.append("")
+    out += covariance_prediction()
+    out.append("")
+    out.append("#endif /* INSGPS13STATE_KERNELS_H */")
+    sys.stdout.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,430 @@
+/*
+ * Generated by insgps13state_gen.py, do not edit.
+ * Unrolled kernels of the 13 state INS/GPS EKF, included by insgps13state.c
+ */
+
+#ifndef INSGPS13STATE_KERNELS_H
+#define INSGPS13STATE_KERNELS_H
+
+// *************  CovariancePrediction *************
+// Does the prediction step of the Kalman filter for the covariance matrix
+// Output, Pnew, overwrites P, the input covariance
+// Pnew = (I+F*T)*P*(I+F*T)' + T^2*G*Q*G'
+//      = P + T*(F*P + P*F') + T^2*(F*P*F' + G*Q*G')
+// Q is the discrete time covariance of process noise
+// Q is vector of the diagonal for a square matrix with
+// dimensions equal to the number of disturbance noise variables
+// Only the upper triangle of the symmetric P is stored and updated,
+// every product is unrolled over the nonzero elements of F and G
+// ************************************************
+
+static void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
+                                 float Q[NUMW], float dT, float P[NUMP])
+{
+    const float dTsq = dT * dT;
+    float D[10][NUMX]; // D = F*P, the remaining rows of F are zero
+
+    // D = F*P
+    D[0][0] = P[PIDX(0, 3)];
+    D[0][1] = P[PIDX(1, 3)];
+    D[0][2] = P[PIDX(2, 3)];
+    D[0][3] = P[PIDX(3, 3)];
+    D[0][4] = P[PIDX(3, 4)];
+    D[0][5] = P[PIDX(3, 5)];
+    D[0][6] = P[PIDX(3, 6)];
+    D[0][7] = P[PIDX(3, 7)];
+    D[0][8] = P[PIDX(3, 8)];
+    D[0][9] = P[PIDX(3, 9)];
+    D[0][10] = P[PIDX(3, 10)];
+    D[0][11] = P[PIDX(3, 11)];
+    D[0][12] = P[PIDX(3, 12)];
+    D[1][0] = P[PIDX(0, 4)];
+    D[1][1] = P[PIDX(1, 4)];
+    D[1][2] = P[PIDX(2, 4)];
+    D[1][3] = P[PIDX(3, 4)];
+    D[1][4] = P[PIDX(4, 4)];
+    D[1][5] = P[PIDX(4, 5)];
+    D[1][6] = P[PIDX(4, 6)];
+    D[1][7] = P[PIDX(4, 7)];
+    D[1][8] = P[PIDX(4, 8)];
+    D[1][9] = P[PIDX(4, 9)];
+    D[1][10] = P[PIDX(4, 10)];
+    D[1][11] = P[PIDX(4, 11)];
+    D[1][12] = P[PIDX(4, 12)];
+    D[2][0] = P[PIDX(0, 5)];
+    D[2][1] = P[PIDX(1, 5)];
+    D[2][2] = P[PIDX(2, 5)];
+    D[2][3] = P[PIDX(3, 5)];
+    D[2][4] = P[PIDX(4, 5)];
+    D[2][5] = P[PIDX(5, 5)];
+    D[2][6] = P[PIDX(5, 6)];
+    D[2][7] = P[PIDX(5, 7)];
+    D[2][8] = P[PIDX(5, 8)];
+    D[2][9] = P[PIDX(5, 9)];
+    D[2][10] = P[PIDX(5, 10)];
+    D[2][11] = P[PIDX(5, 11)];
+    D[2][12] = P[PIDX(5, 12)];
+    D[3][0] = F[3][6] * P[PIDX(0, 6)] + F[3][7] * P[PIDX(0, 7)] + F[3][8] * P[PIDX(0, 8)] + F[3][9] * P[PIDX(0, 9)];
+    D[3][1] = F[3][6] * P[PIDX(1, 6)] + F[3][7] * P[PIDX(1, 7)] + F[3][8] * P[PIDX(1, 8)] + F[3][9] * P[PIDX(1, 9)];
+    D[3][2] = F[3][6] * P[PIDX(2, 6)] + F[3][7] * P[PIDX(2, 7)] + F[3][8] * P[PIDX(2, 8)] + F[3][9] * P[PIDX(2, 9)];
+    D[3][3] = F[3][6] * P[PIDX(3, 6)] + F[3][7] * P[PIDX(3, 7)] + F[3][8] * P[PIDX(3, 8)] + F[3][9] * P[PIDX(3, 9)];
+    D[3][4] = F[3][6] * P[PIDX(4, 6)] + F[3][7] * P[PIDX(4, 7)] + F[3][8] * P[PIDX(4, 8)] + F[3][9] * P[PIDX(4, 9)];
+    D[3][5] = F[3][6] * P[PIDX(5, 6)] + F[3][7] * P[PIDX(5, 7)] + F[3][8] * P[PIDX(5, 8)] + F[3][9] * P[PIDX(5, 9)];
+    D[3][6] = F[3][6] * P[PIDX(6, 6)] + F[3][7] * P[PIDX(6, 7)] + F[3][8] * P[PIDX(6, 8)] + F[3][9] * P[PIDX(6, 9)];
+    D[3][7] = F[3][6] * P[PIDX(6, 7)] + F[3][7] * P[PIDX(7, 7)] + F[3][8] * P[PIDX(7, 8)] + F[3][9] * P[PIDX(7, 9)];
+    D[3][8] = F[3][6] * P[PIDX(6, 8)] + F[3][7] * P[PIDX(7, 8)] + F[3][8] * P[PIDX(8, 8)] + F[3][9] * P[PIDX(8, 9)];
+    D[3][9] = F[3][6] * P[PIDX(6, 9)] + F[3][7] * P[PIDX(7, 9)] + F[3][8] * P[PIDX(8, 9)] + F[3][9] * P[PIDX(9, 9)];
+    D[3][10] = F[3][6] * P[PIDX(6, 10)] + F[3][7] * P[PIDX(7, 10)] + F[3][8] * P[PIDX(8, 10)] + F[3][9] * P[PIDX(9, 10)];
+    D[3][11] = F[3][6] * P[PIDX(6, 11)] + F[3][7] * P[PIDX(7, 11)] + F[3][8] * P[PIDX(8, 11)] + F[3][9] * P[PIDX(9, 11)];
+    D[3][12] = F[3][6] * P[PIDX(6, 12)] + F[3][7] * P[PIDX(7, 12)] + F[3][8] * P[PIDX(8, 12)] + F[3][9] * P[PIDX(9, 12)];
+    D[4][0] = F[4][6] * P[PIDX(0, 6)] + F[4][7] * P[PIDX(0, 7)] + F[4][8] * P[PIDX(0, 8)] + F[4][9] * P[PIDX(0, 9)];
+    D[4][1] = F[4][6] * P[PIDX(1, 6)] + F[4][7] * P[PIDX(1, 7)] + F[4][8] * P[PIDX(1, 8)] + F[4][9] * P[PIDX(1, 9)];
+    D[4][2] = F[4][6] * P[PIDX(2, 6)] + F[4][7] * P[PIDX(2, 7)] + F[4][8] * P[PIDX(2, 8)] + F[4][9] * P[PIDX(2, 9)];
+    D[4][3] = F[4][6] * P[PIDX(3, 6)] + F[4][7] * P[PIDX(3, 7)] + F[4][8] * P[PIDX(3, 8)] + F[4][9] * P[PIDX(3, 9)];
+    D[4][4] = F[4][6] * P[PIDX(4, 6)] + F[4][7] * P[PIDX(4, 7)] + F[4][8] * P[PIDX(4, 8)] + F[4][9] * P[PIDX(4, 9)];
+    D[4][5] = F[4][6] * P[PIDX(5, 6)] + F[4][7] * P[PIDX(5, 7)] + F[4][8] * P[PIDX(5, 8)] + F[4][9] * P[PIDX(5, 9)];
+    D[4][6] = F[4][6] * P[PIDX(6, 6)] + F[4][7] * P[PIDX(6, 7)] + F[4][8] * P[PIDX(6, 8)] + F[4][9] * P[PIDX(6, 9)];
+    D[4][7] = F[4][6] * P[PIDX(6, 7)] + F[4][7] * P[PIDX(7, 7)] + F[4][8] * P[PIDX(7, 8)] + F[4][9] * P[PIDX(7, 9)];
+    D[4][8] = F[4][6] * P[PIDX(6, 8)] + F[4][7] * P[PIDX(7, 8)] + F[4][8] * P[PIDX(8, 8)] + F[4][9] * P[PIDX(8, 9)];
+    D[4][9] = F[4][6] * P[PIDX(6, 9)] + F[4][7] * P[PIDX(7, 9)] + F[4][8] * P[PIDX(8, 9)] + F[4][9] * P[PIDX(9, 9)];
+    D[4][10] = F[4][6] * P[PIDX(6, 10)] + F[4][7] * P[PIDX(7, 10)] + F[4][8] * P[PIDX(8, 10)] + F[4][9] * P[PIDX(9, 10)];
+    D[4][11] = F[4][6] * P[PIDX(6, 11)] + F[4][7] * P[PIDX(7, 11)] + F[4][8] * P[PIDX(8, 11)] + F[4][9] * P[PIDX(9, 11)];
+    D[4][12] = F[4][6] * P[PIDX(6, 12)] + F[4][7] * P[PIDX(7, 12)] + F[4][8] * P[PIDX(8, 12)] + F[4][9] * P[PIDX(9, 12)];
+    D[5][0] = F[5][6] * P[PIDX(0, 6)] + F[5][7] * P[PIDX(0, 7)] + F[5][8] * P[PIDX(0, 8)] + F[5][9] * P[PIDX(0, 9)];
+    D[5][1] = F[5][6] * P[PIDX(1, 6)] + F[5][7] * P[PIDX(1, 7)] + F[5][8] * P[PIDX(1, 8)] + F[5][9] * P[PIDX(1, 9)];
+    D[5][2] = F[5][6] * P[PIDX(2, 6)] + F[5][7] * P[PIDX(2, 7)] + F[5][8] * P[PIDX(2, 8)] + F[5][9] * P[PIDX(2, 9)];
+    D[5][3] = F[5][6] * P[PIDX(3, 6)] + F[5][7] * P[PIDX(3, 7)] + F[5][8] * P[PIDX(3, 8)] + F[5][9] * P[PIDX(3, 9)];
+    D[5][4] = F[5][6] * P[PIDX(4, 6)] + F[5][7] * P[PIDX(4, 7)] + F[5][8] * P[PIDX(4, 8)] + F[5][9] * P[PIDX(4, 9)];
+    D[5][5] = F[5][6] * P[PIDX(5, 6)] + F[5][7] * P[PIDX(5, 7)] + F[5][8] * P[PIDX(5, 8)] + F[5][9] * P[PIDX(5, 9)];
+    D[5][6] = F[5][6] * P[PIDX(6, 6)] + F[5][7] * P[PIDX(6, 7)] + F[5][8] * P[PIDX(6, 8)] + F[5][9] * P[PIDX(6, 9)];
+    D[5][7] = F[5][6] * P[PIDX(6, 7)] + F[5][7] * P[PIDX(7, 7)] + F[5][8] * P[PIDX(7, 8)] + F[5][9] * P[PIDX(7, 9)];
+    D[5][8] = F[5][6] * P[PIDX(6, 8)] + F[5][7] * P[PIDX(7, 8)] + F[5][8] * P[PIDX(8, 8)] + F[5][9] * P[PIDX(8, 9)];
+    D[5][9] = F[5][6] * P[PIDX(6, 9)] + F[5][7] * P[PIDX(7, 9)] + F[5][8] * P[PIDX(8, 9)] + F[5][9] * P[PIDX(9, 9)];
+    D[5][10] = F[5][6] * P[PIDX(6, 10)] + F[5][7] * P[PIDX(7, 10)] + F[5][8] * P[PIDX(8, 10)] + F[5][9] * P[PIDX(9, 10)];
+    D[5][11] = F[5][6] * P[PIDX(6, 11)] + F[5][7] * P[PIDX(7, 11)] + F[5][8] * P[PIDX(8, 11)] + F[5][9] * P[PIDX(9, 11)];
+    D[5][12] = F[5][6] * P[PIDX(6, 12)] + F[5][7] * P[PIDX(7, 12)] + F[5][8] * P[PIDX(8, 12)] + F[5][9] * P[PIDX(9, 12)];
+    D[6][0] = F[6][7] * P[PIDX(0, 7)] + F[6][8] * P[PIDX(0, 8)] + F[6][9] * P[PIDX(0, 9)] + F[6][10] * P[PIDX(0, 10)]
+            + F[6][11] * P[PIDX(0, 11)] + F[6][12] * P[PIDX(0, 12)];
+    D[6][1] = F[6][7] * P[PIDX(1, 7)] + F[6][8] * P[PIDX(1, 8)] + F[6][9] * P[PIDX(1, 9)] + F[6][10] * P[PIDX(1, 10)]
+            + F[6][11] * P[PIDX(1, 11)] + F[6][12] * P[PIDX(1, 12)];
+    D[6][2] = F[6][7] * P[PIDX(2, 7)] + F[6][8] * P[PIDX(2, 8)] + F[6][9] * P[PIDX(2, 9)] + F[6][10] * P[PIDX(2, 10)]
+            + F[6][11] * P[PIDX(2, 11)] + F[6][12] * P[PIDX(2, 12)];
+    D[6][3] = F[6][7] * P[PIDX(3, 7)] + F[6][8] * P[PIDX(3, 8)] + F[6][9] * P[PIDX(3, 9)] + F[6][10] * P[PIDX(3, 10)]
+            + F[6][11] * P[PIDX(3, 11)] + F[6][12] * P[PIDX(3, 12)];
+    D[6][4] = F[6][7] * P[PIDX(4, 7)] + F[6][8] * P[PIDX(4, 8)] + F[6][9] * P[PIDX(4, 9)] + F[6][10] * P[PIDX(4, 10)]
+            + F[6][11] * P[PIDX(4, 11)] + F[6][12] * P[PIDX(4, 12)];
+    D[6][5] = F[6][7] * P[PIDX(5, 7)] + F[6][8] * P[PIDX(5, 8)] + F[6][9] * P[PIDX(5, 9)] + F[6][10] * P[PIDX(5, 10)]
+            + F[6][11] * P[PIDX(5, 11)] + F[6][12] * P[PIDX(5, 12)];
+    D[6][6] = F[6][7] * P[PIDX(6, 7)] + F[6][8] * P[PIDX(6, 8)] + F[6][9] * P[PIDX(6, 9)] + F[6][10] * P[PIDX(6, 10)]
+            + F[6][11] * P[PIDX(6, 11)] + F[6][12] * P[PIDX(6, 12)];
+    D[6][7] = F[6][7] * P[PIDX(7, 7)] + F[6][8] * P[PIDX(7, 8)] + F[6][9] * P[PIDX(7, 9)] + F[6][10] * P[PIDX(7, 10)]
+            + F[6][11] * P[PIDX(7, 11)] + F[6][12] * P[PIDX(7, 12)];
+    D[6][8] = F[6][7] * P[PIDX(7, 8)] + F[6][8] * P[PIDX(8, 8)] + F[6][9] * P[PIDX(8, 9)] + F[6][10] * P[PIDX(8, 10)]
+            + F[6][11] * P[PIDX(8, 11)] + F[6][12] * P[PIDX(8, 12)];
+    D[6][9] = F[6][7] * P[PIDX(7, 9)] + F[6][8] * P[PIDX(8, 9)] + F[6][9] * P[PIDX(9, 9)] + F[6][10] * P[PIDX(9, 10)]
+            + F[6][11] * P[PIDX(9, 11)] + F[6][12] * P[PIDX(9, 12)];
+    D[6][10] = F[6][7] * P[PIDX(7, 10)] + F[6][8] * P[PIDX(8, 10)] + F[6][9] * P[PIDX(9, 10)] + F[6][10] * P[PIDX(10, 10)]
+             + F[6][11] * P[PIDX(10, 11)] + F[6][12] * P[PIDX(10, 12)];
+    D[6][11] = F[6][7] * P[PIDX(7, 11)] + F[6][8] * P[PIDX(8, 11)] + F[6][9] * P[PIDX(9, 11)] + F[6][10] * P[PIDX(10, 11)]
+             + F[6][11] * P[PIDX(11, 11)] + F[6][12] * P[PIDX(11, 12)];
+    D[6][12] = F[6][7] * P[PIDX(7, 12)] + F[6][8] * P[PIDX(8, 12)] + F[6][9] * P[PIDX(9, 12)] + F[6][10] * P[PIDX(10, 12)]
+             + F[6][11] * P[PIDX(11, 12)] + F[6][12] * P[PIDX(12, 12)];
+    D[7][0] = F[7][6] * P[PIDX(0, 6)] + F[7][8] * P[PIDX(0, 8)] + F[7][9] * P[PIDX(0, 9)] + F[7][10] * P[PIDX(0, 10)]
+            + F[7][11] * P[PIDX(0, 11)] + F[7][12] * P[PIDX(0, 12)];
+    D[7][1] = F[7][6] * P[PIDX(1, 6)] + F[7][8] * P[PIDX(1, 8)] + F[7][9] * P[PIDX(1, 9)] + F[7][10] * P[PIDX(1, 10)]
+            + F[7][11] * P[PIDX(1, 11)] + F[7][12] * P[PIDX(1, 12)];
+    D[7][2] = F[7][6] * P[PIDX(2, 6)] + F[7][8] * P[PIDX(2, 8)] + F[7][9] * P[PIDX(2, 9)] + F[7][10] * P[PIDX(2, 10)]
+            + F[7][11] * P[PIDX(2, 11)] + F[7][12] * P[PIDX(2, 12)];
+    D[7][3] = F[7][6] * P[PIDX(3, 6)] + F[7][8] * P[PIDX(3, 8)] + F[7][9] * P[PIDX(3, 9)] + F[7][10] * P[PIDX(3, 10)]
+            + F[7][11] * P[PIDX(3, 11)] + F[7][12] * P[PIDX(3, 12)];
+    D[7][4] = F[7][6] * P[PIDX(4, 6)] + F[7][8] * P[PIDX(4, 8)] + F[7][9] * P[PIDX(4, 9)] + F[7][10] * P[PIDX(4, 10)]
+            + F[7][11] * P[PIDX(4, 11)] + F[7][12] * P[PIDX(4, 12)];
+    D[7][5] = F[7][6] * P[PIDX(5, 6)] + F[7][8] * P[PIDX(5, 8)] + F[7][9] * P[PIDX(5, 9)] + F[7][10] * P[PIDX(5, 10)]
+            + F[7][11] * P[PIDX(5, 11)] + F[7][12] * P[PIDX(5, 12)];
+    D[7][6] = F[7][6] * P[PIDX(6, 6)] + F[7][8] * P[PIDX(6, 8)] + F[7][9] * P[PIDX(6, 9)] + F[7][10] * P[PIDX(6, 10)]
+            + F[7][11] * P[PIDX(6, 11)] + F[7][12] * P[PIDX(6, 12)];
+    D[7][7] = F[7][6] * P[PIDX(6, 7)] + F[7][8] * P[PIDX(7, 8)] + F[7][9] * P[PIDX(7, 9)] + F[7][10] * P[PIDX(7, 10)]
+            + F[7][11] * P[PIDX(7, 11)] + F[7][12] * P[PIDX(7, 12)];
+    D[7][8] = F[7][6] * P[PIDX(6, 8)] + F[7][8] * P[PIDX(8, 8)] + F[7][9] * P[PIDX(8, 9)] + F[7][10] * P[PIDX(8, 10)]
+            + F[7][11] * P[PIDX(8, 11)] + F[7][12] * P[PIDX(8, 12)];
+    D[7][9] = F[7][6] * P[PIDX(6, 9)] + F[7][8] * P[PIDX(8, 9)] + F[7][9] * P[PIDX(9, 9)] + F[7][10] * P[PIDX(9, 10)]
+            + F[7][11] * P[PIDX(9, 11)] + F[7][12] * P[PIDX(9, 12)];
+    D[7][10] = F[7][6] * P[PIDX(6, 10)] + F[7][8] * P[PIDX(8, 10)] + F[7][9] * P[PIDX(9, 10)] + F[7][10] * P[PIDX(10, 10)]
+             + F[7][11] * P[PIDX(10, 11)] + F[7][12] * P[PIDX(10, 12)];
+    D[7][11] = F[7][6] * P[PIDX(6, 11)] + F[7][8] * P[PIDX(8, 11)] + F[7][9] * P[PIDX(9, 11)] + F[7][10] * P[PIDX(10, 11)]
+             + F[7][11] * P[PIDX(11, 11)] + F[7][12] * P[PIDX(11, 12)];
+    D[7][12] = F[7][6] * P[PIDX(6, 12)] + F[7][8] * P[PIDX(8, 12)] + F[7][9] * P[PIDX(9, 12)] + F[7][10] * P[PIDX(10, 12)]
+             + F[7][11] * P[PIDX(11, 12)] + F[7][12] * P[PIDX(12, 12)];
+    D[8][0] = F[8][6] * P[PIDX(0, 6)] + F[8][7] * P[PIDX(0, 7)] + F[8][9] * P[PIDX(0, 9)] + F[8][10] * P[PIDX(0, 10)]
+            + F[8][11] * P[PIDX(0, 11)] + F[8][12] * P[PIDX(0, 12)];
+    D[8][1] = F[8][6] * P[PIDX(1, 6)] + F[8][7] * P[PIDX(1, 7)] + F[8][9] * P[PIDX(1, 9)] + F[8][10] * P[PIDX(1, 10)]
+            + F[8][11] * P[PIDX(1, 11)] + F[8][12] * P[PIDX(1, 12)];
+    D[8][2] = F[8][6] * P[PIDX(2, 6)] + F[8][7] * P[PIDX(2, 7)] + F[8][9] * P[PIDX(2, 9)] + F[8][10] * P[PIDX(2, 10)]
+            + F[8][11] * P[PIDX(2, 11)] + F[8][12] * P[PIDX(2, 12)];
+    D[8][3] = F[8][6] * P[PIDX(3, 6)] + F[8][7] * P[PIDX(3, 7)] + F[8][9] * P[PIDX(3, 9)] + F[8][10] * P[PIDX(3, 10)]
+            + F[8][11] * P[PIDX(3, 11)] + F[8][12] * P[PIDX(3, 12)];
+    D[8][4] = F[8][6] * P[PIDX(4, 6)] + F[8][7] * P[PIDX(4, 7)] + F[8][9] * P[PIDX(4, 9)] + F[8][10] * P[PIDX(4, 10)]
+            + F[8][11] * P[PIDX(4, 11)] + F[8][12] * P[PIDX(4, 12)];
+    D[8][5] = F[8][6] * P[PIDX(5, 6)] + F[8][7] * P[PIDX(5, 7)] + F[8][9] * P[PIDX(5, 9)] + F[8][10] * P[PIDX(5, 10)]
+            + F[8][11] * P[PIDX(5, 11)] + F[8][12] * P[PIDX(5, 12)];
+    D[8][6] = F[8][6] * P[PIDX(6, 6)] + F[8][7] * P[PIDX(6, 7)] + F[8][9] * P[PIDX(6, 9)] + F[8][10] * P[PIDX(6, 10)]
+            + F[8][11] * P[PIDX(6, 11)] + F[8][12] * P[PIDX(6, 12)];
+    D[8][7] = F[8][6] * P[PIDX(6, 7)] + F[8][7] * P[PIDX(7, 7)] + F[8][9] * P[PIDX(7, 9)] + F[8][10] * P[PIDX(7, 10)]
+            + F[8][11] * P[PIDX(7, 11)] + F[8][12] * P[PIDX(7, 12)];
+    D[8][8] = F[8][6] * P[PIDX(6, 8)] + F[8][7] * P[PIDX(7, 8)] + F[8][9] * P[PIDX(8, 9)] + F[8][10] * P[PIDX(8, 10)]
+            + F[8][11] * P[PIDX(8, 11)] + F[8][12] * P[PIDX(8, 12)];
+    D[8][9] = F[8][6] * P[PIDX(6, 9)] + F[8][7] * P[PIDX(7, 9)] + F[8][9] * P[PIDX(9, 9)] + F[8][10] * P[PIDX(9, 10)]
+            + F[8][11] * P[PIDX(9, 11)] + F[8][12] * P[PIDX(9, 12)];
+    D[8][10] = F[8][6] * P[PIDX(6, 10)] + F[8][7] * P[PIDX(7, 10)] + F[8][9] * P[PIDX(9, 10)] + F[8][10] * P[PIDX(10, 10)]
+             + F[8][11] * P[PIDX(10, 11)] + F[8][12] * P[PIDX(10, 12)];
+    D[8][11] = F[8][6] * P[PIDX(6, 11)] + F[8][7] * P[PIDX(7, 11)] + F[8][9] * P[PIDX(9, 11)] + F[8][10] * P[PIDX(10, 11)]
+             + F[8][11] * P[PIDX(11, 11)] + F[8][12] * P[PIDX(11, 12)];
+    D[8][12] = F[8][6] * P[PIDX(6, 12)] + F[8][7] * P[PIDX(7, 12)] + F[8][9] * P[PIDX(9, 12)] + F[8][10] * P[PIDX(10, 12)]
+             + F[8][11] * P[PIDX(11, 12)] + F[8][12] * P[PIDX(12, 12)];
+    D[9][0] = F[9][6] * P[PIDX(0, 6)] + F[9][7] * P[PIDX(0, 7)] + F[9][8] * P[PIDX(0, 8)] + F[9][10] * P[PIDX(0, 10)]
+            + F[9][11] * P[PIDX(0, 11)] + F[9][12] * P[PIDX(0, 12)];
+    D[9][1] = F[9][6] * P[PIDX(1, 6)] + F[9][7] * P[PIDX(1, 7)] + F[9][8] * P[PIDX(1, 8)] + F[9][10] * P[PIDX(1, 10)]
+            + F[9][11] * P[PIDX(1, 11)] + F[9][12] * P[PIDX(1, 12)];
+    D[9][2] = F[9][6] * P[PIDX(2, 6)] + F[9][7] * P[PIDX(2, 7)] + F[9][8] * P[PIDX(2, 8)] + F[9][10] * P[PIDX(2, 10)]
+            + F[9][11] * P[PIDX(2, 11)] + F[9][12] * P[PIDX(2, 12)];
+    D[9][3] = F[9][6] * P[PIDX(3, 6)] + F[9][7] * P[PIDX(3, 7)] + F[9][8] * P[PIDX(3, 8)] + F[9][10] * P[PIDX(3, 10)]
+            + F[9][11] * P[PIDX(3, 11)] + F[9][12] * P[PIDX(3, 12)];
+    D[9][4] = F[9][6] * P[PIDX(4, 6)] + F[9][7] * P[PIDX(4, 7)] + F[9][8] * P[PIDX(4, 8)] + F[9][10] * P[PIDX(4, 10)]
+            + F[9][11] * P[PIDX(4, 11)] + F[9][12] * P[PIDX(4, 12)];
+    D[9][5] = F[9][6] * P[PIDX(5, 6)] + F[9][7] * P[PIDX(5, 7)] + F[9][8] * P[PIDX(5, 8)] + F[9][10] * P[PIDX(5, 10)]
+            + F[9][11] * P[PIDX(5, 11)] + F[9][12] * P[PIDX(5, 12)];
+    D[9][6] = F[9][6] * P[PIDX(6, 6)] + F[9][7] * P[PIDX(6, 7)] + F[9][8] * P[PIDX(6, 8)] + F[9][10] * P[PIDX(6, 10)]
+            + F[9][11] * P[PIDX(6, 11)] + F[9][12] * P[PIDX(6, 12)];
+    D[9][7] = F[9][6] * P[PIDX(6, 7)] + F[9][7] * P[PIDX(7, 7)] + F[9][8] * P[PIDX(7, 8)] + F[9][10] * P[PIDX(7, 10)]
+            + F[9][11] * P[PIDX(7, 11)] + F[9][12] * P[PIDX(7, 12)];
+    D[9][8] = F[9][6] * P[PIDX(6, 8)] + F[9][7] * P[PIDX(7, 8)] + F[9][8] * P[PIDX(8, 8)] + F[9][10] * P[PIDX(8, 10)]
+            + F[9][11] * P[PIDX(8, 11)] + F[9][12] * P[PIDX(8, 12)];
+    D[9][9] = F[9][6] * P[PIDX(6, 9)] + F[9][7] * P[PIDX(7, 9)] + F[9][8] * P[PIDX(8, 9)] + F[9][10] * P[PIDX(9, 10)]
+            + F[9][11] * P[PIDX(9, 11)] + F[9][12] * P[PIDX(9, 12)];
+    D[9][10] = F[9][6] * P[PIDX(6, 10)] + F[9][7] * P[PIDX(7, 10)] + F[9][8] * P[PIDX(8, 10)] + F[9][10] * P[PIDX(10, 10)]
+             + F[9][11] * P[PIDX(10, 11)] + F[9][12] * P[PIDX(10, 12)];
+    D[9][11] = F[9][6] * P[PIDX(6, 11)] + F[9][7] * P[PIDX(7, 11)] + F[9][8] * P[PIDX(8, 11)] + F[9][10] * P[PIDX(10, 11)]
+             + F[9][11] * P[PIDX(11, 11)] + F[9][12] * P[PIDX(11, 12)];
+    D[9][12] = F[9][6] * P[PIDX(6, 12)] + F[9][7] * P[PIDX(7, 12)] + F[9][8] * P[PIDX(8, 12)] + F[9][10] * P[PIDX(10, 12)]
+             + F[9][11] * P[PIDX(11, 12)] + F[9][12] * P[PIDX(12, 12)];
+
+    // GQ = G*Q
+    const float GQ3_3 = G[3][3] * Q[3];
+    const float GQ3_4 = G[3][4] * Q[4];
+    const float GQ3_5 = G[3][5] * Q[5];
+    const float GQ4_3 = G[4][3] * Q[3];
+    const float GQ4_4 = G[4][4] * Q[4];
+    const float GQ4_5 = G[4][5] * Q[5];
+    const float GQ5_3 = G[5][3] * Q[3];
+    const float GQ5_4 = G[5][4] * Q[4];
+    const float GQ5_5 = G[5][5] * Q[5];
+    const float GQ6_0 = G[6][0] * Q[0];
+    const float GQ6_1 = G[6][1] * Q[1];
+    const float GQ6_2 = G[6][2] * Q[2];
+    const float GQ7_0 = G[7][0] * Q[0];
+    const float GQ7_1 = G[7][1] * Q[1];
+    const float GQ7_2 = G[7][2] * Q[2];
+    const float GQ8_0 = G[8][0] * Q[0];
+    const float GQ8_1 = G[8][1] * Q[1];
+    const float GQ8_2 = G[8][2] * Q[2];
+    const float GQ9_0 = G[9][0] * Q[0];
+    const float GQ9_1 = G[9][1] * Q[1];
+    const float GQ9_2 = G[9][2] * Q[2];
+
+    // Pnew = P + T*(D + D') + T^2*(D*F' + GQ*G')
+    P[PIDX(0, 0)] += dT * (2.0f * D[0][0])
+                     + dTsq * D[0][3];
+    P[PIDX(0, 1)] += dT * (D[0][1] + D[1][0])
+                     + dTsq * D[0][4];
+    P[PIDX(0, 2)] += dT * (D[0][2] + D[2][0])
+                     + dTsq * D[0][5];
+    P[PIDX(0, 3)] += dT * (D[0][3] + D[3][0])
+                     + dTsq * (F[3][6] * D[0][6] + F[3][7] * D[0][7] + F[3][8] * D[0][8] + F[3][9] * D[0][9]);
+    P[PIDX(0, 4)] += dT * (D[0][4] + D[4][0])
+                     + dTsq * (F[4][6] * D[0][6] + F[4][7] * D[0][7] + F[4][8] * D[0][8] + F[4][9] * D[0][9]);
+    P[PIDX(0, 5)] += dT * (D[0][5] + D[5][0])
+                     + dTsq * (F[5][6] * D[0][6] + F[5][7] * D[0][7] + F[5][8] * D[0][8] + F[5][9] * D[0][9]);
+    P[PIDX(0, 6)] += dT * (D[0][6] + D[6][0])
+                     + dTsq * (F[6][7] * D[0][7] + F[6][8] * D[0][8] + F[6][9] * D[0][9] + F[6][10] * D[0][10]
+                           + F[6][11] * D[0][11] + F[6][12] * D[0][12]);
+    P[PIDX(0, 7)] += dT * (D[0][7] + D[7][0])
+                     + dTsq * (F[7][6] * D[0][6] + F[7][8] * D[0][8] + F[7][9] * D[0][9] + F[7][10] * D[0][10]
+                           + F[7][11] * D[0][11] + F[7][12] * D[0][12]);
+    P[PIDX(0, 8)] += dT * (D[0][8] + D[8][0])
+                     + dTsq * (F[8][6] * D[0][6] + F[8][7] * D[0][7] + F[8][9] * D[0][9] + F[8][10] * D[0][10]
+                           + F[8][11] * D[0][11] + F[8][12] * D[0][12]);
+    P[PIDX(0, 9)] += dT * (D[0][9] + D[9][0])
+                     + dTsq * (F[9][6] * D[0][6] + F[9][7] * D[0][7] + F[9][8] * D[0][8] + F[9][10] * D[0][10]
+                           + F[9][11] * D[0][11] + F[9][12] * D[0][12]);
+    P[PIDX(0, 10)] += dT * (D[0][10]);
+    P[PIDX(0, 11)] += dT * (D[0][11]);
+    P[PIDX(0, 12)] += dT * (D[0][12]);
+    P[PIDX(1, 1)] += dT * (2.0f * D[1][1])
+                     + dTsq * D[1][4];
+    P[PIDX(1, 2)] += dT * (D[1][2] + D[2][1])
+                     + dTsq * D[1][5];
+    P[PIDX(1, 3)] += dT * (D[1][3] + D[3][1])
+                     + dTsq * (F[3][6] * D[1][6] + F[3][7] * D[1][7] + F[3][8] * D[1][8] + F[3][9] * D[1][9]);
+    P[PIDX(1, 4)] += dT * (D[1][4] + D[4][1])
+                     + dTsq * (F[4][6] * D[1][6] + F[4][7] * D[1][7] + F[4][8] * D[1][8] + F[4][9] * D[1][9]);
+    P[PIDX(1, 5)] += dT * (D[1][5] + D[5][1])
+                     + dTsq * (F[5][6] * D[1][6] + F[5][7] * D[1][7] + F[5][8] * D[1][8] + F[5][9] * D[1][9]);
+    P[PIDX(1, 6)] += dT * (D[1][6] + D[6][1])
+                     + dTsq * (F[6][7] * D[1][7] + F[6][8] * D[1][8] + F[6][9] * D[1][9] + F[6][10] * D[1][10]
+                           + F[6][11] * D[1][11] + F[6][12] * D[1][12]);
+    P[PIDX(1, 7)] += dT * (D[1][7] + D[7][1])
+                     + dTsq * (F[7][6] * D[1][6] + F[7][8] * D[1][8] + F[7][9] * D[1][9] + F[7][10] * D[1][10]
+                           + F[7][11] * D[1][11] + F[7][12] * D[1][12]);
+    P[PIDX(1, 8)] += dT * (D[1][8] + D[8][1])
+                     + dTsq * (F[8][6] * D[1][6] + F[8][7] * D[1][7] + F[8][9] * D[1][9] + F[8][10] * D[1][10]
+                           + F[8][11] * D[1][11] + F[8][12] * D[1][12]);
+    P[PIDX(1, 9)] += dT * (D[1][9] + D[9][1])
+                     + dTsq * (F[9][6] * D[1][6] + F[9][7] * D[1][7] + F[9][8] * D[1][8] + F[9][10] * D[1][10]
+                           + F[9][11] * D[1][11] + F[9][12] * D[1][12]);
+    P[PIDX(1, 10)] += dT * (D[1][10]);
+    P[PIDX(1, 11)] += dT * (D[1][11]);
+    P[PIDX(1, 12)] += dT * (D[1][12]);
+    P[PIDX(2, 2)] += dT * (2.0f * D[2][2])
+                     + dTsq * D[2][5];
+    P[PIDX(2, 3)] += dT * (D[2][3] + D[3][2])
+                     + dTsq * (F[3][6] * D[2][6] + F[3][7] * D[2][7] + F[3][8] * D[2][8] + F[3][9] * D[2][9]);
+    P[PIDX(2, 4)] += dT * (D[2][4] + D[4][2])
+                     + dTsq * (F[4][6] * D[2][6] + F[4][7] * D[2][7] + F[4][8] * D[2][8] + F[4][9] * D[2][9]);
+    P[PIDX(2, 5)] += dT * (D[2][5] + D[5][2])
+                     + dTsq * (F[5][6] * D[2][6] + F[5][7] * D[2][7] + F[5][8] * D[2][8] + F[5][9] * D[2][9]);
+    P[PIDX(2, 6)] += dT * (D[2][6] + D[6][2])
+                     + dTsq * (F[6][7] * D[2][7] + F[6][8] * D[2][8] + F[6][9] * D[2][9] + F[6][10] * D[2][10]
+                           + F[6][11] * D[2][11] + F[6][12] * D[2][12]);
+    P[PIDX(2, 7)] += dT * (D[2][7] + D[7][2])
+                     + dTsq * (F[7][6] * D[2][6] + F[7][8] * D[2][8] + F[7][9] * D[2][9] + F[7][10] * D[2][10]
+                           + F[7][11] * D[2][11] + F[7][12] * D[2][12]);
+    P[PIDX(2, 8)] += dT * (D[2][8] + D[8][2])
+                     + dTsq * (F[8][6] * D[2][6] + F[8][7] * D[2][7] + F[8][9] * D[2][9] + F[8][10] * D[2][10]
+                           + F[8][11] * D[2][11] + F[8][12] * D[2][12]);
+    P[PIDX(2, 9)] += dT * (D[2][9] + D[9][2])
+                     + dTsq * (F[9][6] * D[2][6] + F[9][7] * D[2][7] + F[9][8] * D[2][8] + F[9][10] * D[2][10]
+                           + F[9][11] * D[2][11] + F[9][12] * D[2][12]);
+    P[PIDX(2, 10)] += dT * (D[2][10]);
+    P[PIDX(2, 11)] += dT * (D[2][11]);
+    P[PIDX(2, 12)] += dT * (D[2][12]);
+    P[PIDX(3, 3)] += dT * (2.0f * D[3][3])
+                     + dTsq * (F[3][6] * D[3][6] + F[3][7] * D[3][7] + F[3][8] * D[3][8] + F[3][9] * D[3][9]
+                           + G[3][3] * GQ3_3 + G[3][4] * GQ3_4 + G[3][5] * GQ3_5);
+    P[PIDX(3, 4)] += dT * (D[3][4] + D[4][3])
+                     + dTsq * (F[4][6] * D[3][6] + F[4][7] * D[3][7] + F[4][8] * D[3][8] + F[4][9] * D[3][9]
+                           + G[4][3] * GQ3_3 + G[4][4] * GQ3_4 + G[4][5] * GQ3_5);
+    P[PIDX(3, 5)] += dT * (D[3][5] + D[5][3])
+                     + dTsq * (F[5][6] * D[3][6] + F[5][7] * D[3][7] + F[5][8] * D[3][8] + F[5][9] * D[3][9]
+                           + G[5][3] * GQ3_3 + G[5][4] * GQ3_4 + G[5][5] * GQ3_5);
+    P[PIDX(3, 6)] += dT * (D[3][6] + D[6][3])
+                     + dTsq * (F[6][7] * D[3][7] + F[6][8] * D[3][8] + F[6][9] * D[3][9] + F[6][10] * D[3][10]
+                           + F[6][11] * D[3][11] + F[6][12] * D[3][12]);
+    P[PIDX(3, 7)] += dT * (D[3][7] + D[7][3])
+                     + dTsq * (F[7][6] * D[3][6] + F[7][8] * D[3][8] + F[7][9] * D[3][9] + F[7][10] * D[3][10]
+                           + F[7][11] * D[3][11] + F[7][12] * D[3][12]);
+    P[PIDX(3, 8)] += dT * (D[3][8] + D[8][3])
+                     + dTsq * (F[8][6] * D[3][6] + F[8][7] * D[3][7] + F[8][9] * D[3][9] + F[8][10] * D[3][10]
+                           + F[8][11] * D[3][11] + F[8][12] * D[3][12]);
+    P[PIDX(3, 9)] += dT * (D[3][9] + D[9][3])
+                     + dTsq * (F[9][6] * D[3][6] + F[9][7] * D[3][7] + F[9][8] * D[3][8] + F[9][10] * D[3][10]
+                           + F[9][11] * D[3][11] + F[9][12] * D[3][12]);
+    P[PIDX(3, 10)] += dT * (D[3][10]);
+    P[PIDX(3, 11)] += dT * (D[3][11]);
+    P[PIDX(3, 12)] += dT * (D[3][12]);
+    P[PIDX(4, 4)] += dT * (2.0f * D[4][4])
+                     + dTsq * (F[4][6] * D[4][6] + F[4][7] * D[4][7] + F[4][8] * D[4][8] + F[4][9] * D[4][9]
+                           + G[4][3] * GQ4_3 + G[4][4] * GQ4_4 + G[4][5] * GQ4_5);
+    P[PIDX(4, 5)] += dT * (D[4][5] + D[5][4])
+                     + dTsq * (F[5][6] * D[4][6] + F[5][7] * D[4][7] + F[5][8] * D[4][8] + F[5][9] * D[4][9]
+                           + G[5][3] * GQ4_3 + G[5][4] * GQ4_4 + G[5][5] * GQ4_5);
+    P[PIDX(4, 6)] += dT * (D[4][6] + D[6][4])
+                     + dTsq * (F[6][7] * D[4][7] + F[6][8] * D[4][8] + F[6][9] * D[4][9] + F[6][10] * D[4][10]
+                           + F[6][11] * D[4][11] + F[6][12] * D[4][12]);
+    P[PIDX(4, 7)] += dT * (D[4][7] + D[7][4])
+                     + dTsq * (F[7][6] * D[4][6] + F[7][8] * D[4][8] + F[7][9] * D[4][9] + F[7][10] * D[4][10]
+                           + F[7][11] * D[4][11] + F[7][12] * D[4][12]);
+    P[PIDX(4, 8)] += dT * (D[4][8] + D[8][4])
+                     + dTsq * (F[8][6] * D[4][6] + F[8][7] * D[4][7] + F[8][9] * D[4][9] + F[8][10] * D[4][10]
+                           + F[8][11] * D[4][11] + F[8][12] * D[4][12]);
+    P[PIDX(4, 9)] += dT * (D[4][9] + D[9][4])
+                     + dTsq * (F[9][6] * D[4][6] + F[9][7] * D[4][7] + F[9][8] * D[4][8] + F[9][10] * D[4][10]
+                           + F[9][11] * D[4][11] + F[9][12] * D[4][12]);
+    P[PIDX(4, 10)] += dT * (D[4][10]);
+    P[PIDX(4, 11)] += dT * (D[4][11]);
+    P[PIDX(4, 12)] += dT * (D[4][12]);
+    P[PIDX(5, 5)] += dT * (2.0f * D[5][5])
+                     + dTsq * (F[5][6] * D[5][6] + F[5][7] * D[5][7] + F[5][8] * D[5][8] + F[5][9] * D[5][9]
+                           + G[5][3] * GQ5_3 + G[5][4] * GQ5_4 + G[5][5] * GQ5_5);
+    P[PIDX(5, 6)] += dT * (D[5][6] + D[6][5])
+                     + dTsq * (F[6][7] * D[5][7] + F[6][8] * D[5][8] + F[6][9] * D[5][9] + F[6][10] * D[5][10]
+                           + F[6][11] * D[5][11] + F[6][12] * D[5][12]);
+    P[PIDX(5, 7)] += dT * (D[5][7] + D[7][5])
+                     + dTsq * (F[7][6] * D[5][6] + F[7][8] * D[5][8] + F[7][9] * D[5][9] + F[7][10] * D[5][10]
+                           + F[7][11] * D[5][11] + F[7][12] * D[5][12]);
+    P[PIDX(5, 8)] += dT * (D[5][8] + D[8][5])
+                     + dTsq * (F[8][6] * D[5][6] + F[8][7] * D[5][7] + F[8][9] * D[5][9] + F[8][10] * D[5][10]
+                           + F[8][11] * D[5][11] + F[8][12] * D[5][12]);
+    P[PIDX(5, 9)] += dT * (D[5][9] + D[9][5])
+                     + dTsq * (F[9][6] * D[5][6] + F[9][7] * D[5][7] + F[9][8] * D[5][8] + F[9][10] * D[5][10]
+                           + F[9][11] * D[5][11] + F[9][12] * D[5][12]);
+    P[PIDX(5, 10)] += dT * (D[5][10]);
+    P[PIDX(5, 11)] += dT * (D[5][11]);
+    P[PIDX(5, 12)] += dT * (D[5][12]);
+    P[PIDX(6, 6)] += dT * (2.0f * D[6][6])
+                     + dTsq * (F[6][7] * D[6][7] + F[6][8] * D[6][8] + F[6][9] * D[6][9] + F[6][10] * D[6][10]
+                           + F[6][11] * D[6][11] + F[6][12] * D[6][12] + G[6][0] * GQ6_0 + G[6][1] * GQ6_1
+                           + G[6][2] * GQ6_2);
+    P[PIDX(6, 7)] += dT * (D[6][7] + D[7][6])
+                     + dTsq * (F[7][6] * D[6][6] + F[7][8] * D[6][8] + F[7][9] * D[6][9] + F[7][10] * D[6][10]
+                           + F[7][11] * D[6][11] + F[7][12] * D[6][12] + G[7][0] * GQ6_0 + G[7][1] * GQ6_1
+                           + G[7][2] * GQ6_2);
+    P[PIDX(6, 8)] += dT * (D[6][8] + D[8][6])
+                     + dTsq * (F[8][6] * D[6][6] + F[8][7] * D[6][7] + F[8][9] * D[6][9] + F[8][10] * D[6][10]
+                           + F[8][11] * D[6][11] + F[8][12] * D[6][12] + G[8][0] * GQ6_0 + G[8][1] * GQ6_1
+                           + G[8][2] * GQ6_2);
+    P[PIDX(6, 9)] += dT * (D[6][9] + D[9][6])
+                     + dTsq * (F[9][6] * D[6][6] + F[9][7] * D[6][7] + F[9][8] * D[6][8] + F[9][10] * D[6][10]
+                           + F[9][11] * D[6][11] + F[9][12] * D[6][12] + G[9][0] * GQ6_0 + G[9][1] * GQ6_1
+                           + G[9][2] * GQ6_2);
+    P[PIDX(6, 10)] += dT * (D[6][10]);
+    P[PIDX(6, 11)] += dT * (D[6][11]);
+    P[PIDX(6, 12)] += dT * (D[6][12]);
+    P[PIDX(7, 7)] += dT * (2.0f * D[7][7])
+                     + dTsq * (F[7][6] * D[7][6] + F[7][8] * D[7][8] + F[7][9] * D[7][9] + F[7][10] * D[7][10]
+                           + F[7][11] * D[7][11] + F[7][12] * D[7][12] + G[7][0] * GQ7_0 + G[7][1] * GQ7_1
+                           + G[7][2] * GQ7_2);
+    P[PIDX(7, 8)] += dT * (D[7][8] + D[8][7])
+                     + dTsq * (F[8][6] * D[7][6] + F[8][7] * D[7][7] + F[8][9] * D[7][9] + F[8][10] * D[7][10]
+                           + F[8][11] * D[7][11] + F[8][12] * D[7][12] + G[8][0] * GQ7_0 + G[8][1] * GQ7_1
+                           + G[8][2] * GQ7_2);
+    P[PIDX(7, 9)] += dT * (D[7][9] + D[9][7])
+                     + dTsq * (F[9][6] * D[7][6] + F[9][7] * D[7][7] + F[9][8] * D[7][8] + F[9][10] * D[7][10]
+                           + F[9][11] * D[7][11] + F[9][12] * D[7][12] + G[9][0] * GQ7_0 + G[9][1] * GQ7_1
+                           + G[9][2] * GQ7_2);
+    P[PIDX(7, 10)] += dT * (D[7][10]);
+    P[PIDX(7, 11)] += dT * (D[7][11]);
+    P[PIDX(7, 12)] += dT * (D[7][12]);
+    P[PIDX(8, 8)] += dT * (2.0f * D[8][8])
+                     + dTsq * (F[8][6] * D[8][6] + F[8][7] * D[8][7] + F[8][9] * D[8][9] + F[8][10] * D[8][10]
+                           + F[8][11] * D[8][11] + F[8][12] * D[8][12] + G[8][0] * GQ8_0 + G[8][1] * GQ8_1
+                           + G[8][2] * GQ8_2);
+    P[PIDX(8, 9)] += dT * (D[8][9] + D[9][8])
+                     + dTsq * (F[9][6] * D[8][6] + F[9][7] * D[8][7] + F[9][8] * D[8][8] + F[9][10] * D[8][10]
+                           + F[9][11] * D[8][11] + F[9][12] * D[8][12] + G[9][0] * GQ8_0 + G[9][1] * GQ8_1
+                           + G[9][2] * GQ8_2);
+    P[PIDX(8, 10)] += dT * (D[8][10]);
+    P[PIDX(8, 11)] += dT * (D[8][11]);
+    P[PIDX(8, 12)] += dT * (D[8][12]);
+    P[PIDX(9, 9)] += dT * (2.0f * D[9][9])
+                     + dTsq * (F[9][6] * D[9][6] + F[9][7] * D[9][7] + F[9][8] * D[9][8] + F[9][10] * D[9][10]
+                           + F[9][11] * D[9][11] + F[9][12] * D[9][12] + G[9][0] * GQ9_0 + G[9][1] * GQ9_1
+                           + G[9][2] * GQ9_2);
+    P[PIDX(9, 10)] += dT * (D[9][10]);
+    P[PIDX(9, 11)] += dT * (D[9][11]);
+    P[PIDX(9, 12)] += dT * (D[9][12]);
+    P[PIDX(10, 10)] += dTsq * Q[6];
+    P[PIDX(11, 11)] += dTsq * Q[7];
+    P[PIDX(12, 12)] += dTsq * Q[8];
+}
+
+#endif /* INSGPS13STATE_KERNELS_H */
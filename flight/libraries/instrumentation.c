@@ -44,6 +44,16 @@ void InstrumentationPublishAllCounters()
         return;
     }
     PIOS_Instrumentation_ForEachCounter(&counterCallback, NULL);
+    if (pios_instrumentation_dropped_counters > 0) {
+        // Counters that did not fit are reported by an extra instance with Id 0
+        pios_perf_counter_t dropped = {
+            .id    = 0,
+            .value = pios_instrumentation_dropped_counters,
+            .min   = pios_instrumentation_dropped_counters,
+            .max   = pios_instrumentation_dropped_counters,
+        };
+        counterCallback(&dropped, pios_instrumentation_last_used_counter + 1, NULL);
+    }
     xSemaphoreGive(sem);
 }
 
@@ -58,5 +68,8 @@ void counterCallback(const pios_perf_counter_t *counter, const int8_t index, __a
     data.Counter.Max   = counter->max;
     data.Counter.Min   = counter->min;
     data.Counter.Value = counter->value;
+    data.Counter.P50   = PIOS_Instrumentation_HistogramPercentile(counter, 5000);
+    data.Counter.P99   = PIOS_Instrumentation_HistogramPercentile(counter, 9900);
+    data.Counter.P999  = PIOS_Instrumentation_HistogramPercentile(counter, 9990);
     PerfCounterInstSet(index, &data);
 }
@@ -0,0 +1,80 @@
+###############################################################################
+# @file       benchmark.mk
+# @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+#
+# @brief Common rules to build and run the host side benchmarks of flight code
+###############################################################################
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+# for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc.,
+# 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+
+# Use native toolchain and disable THUMB mode for benchmarks
+override ARM_SDK_PREFIX :=
+override THUMB :=
+
+BENCH_COMMON_DIR := $(FLIGHT_ROOT_DIR)/benchmarks/common
+
+# Module benchmarks list the objects their module uses in BENCH_UAVOBJECTS,
+# the code uavobjgenerator produced for them is built with the benchmark,
+# see BENCH_UAVO_TARGETS in flight/Makefile
+ifneq ($(strip $(BENCH_UAVOBJECTS)),)
+SRC += $(addprefix $(FLIGHT_UAVOBJ_DIR)/, $(addsuffix .c, $(BENCH_UAVOBJECTS)))
+endif
+
+# Benchmark source files
+ALLSRC     := $(SRC) $(wildcard ./*.c) $(BENCH_COMMON_DIR)/benchmark.c
+ALLSRCBASE := $(notdir $(basename $(ALLSRC)))
+ALLOBJ     := $(addprefix $(OUTDIR)/, $(addsuffix .o, $(ALLSRCBASE)))
+
+$(foreach src,$(ALLSRC),$(eval $(call COMPILE_C_TEMPLATE,$(src))))
+$(eval $(call LINK_TEMPLATE,$(OUTDIR)/$(TARGET).elf,$(ALLOBJ)))
+
+# The stand-ins of the benchmark directory come first, then the shared ones
+EXTRAINCDIRS += $(BENCH_COMMON_DIR)
+EXTRAINCDIRS += $(OPUAVTALK)/inc
+
+ifneq ($(strip $(BENCH_UAVOBJECTS)),)
+EXTRAINCDIRS += $(FLIGHT_UAVOBJ_DIR)
+CFLAGS       += -DBENCH_MODULE
+endif
+
+# Flags passed to the C compiler
+CONLYFLAGS += -std=gnu99
+
+# Benchmarks are built like the firmware is: optimized, but with the
+# same UNIT_TEST hooks as the unit tests to reach private code
+CFLAGS += -DUNIT_TEST
+CFLAGS += -O2 -g
+CFLAGS += -Wall -Werror
+CFLAGS += $(patsubst %,-I%,$(EXTRAINCDIRS))
+
+LDFLAGS += -lm
+
+.PHONY: elf
+elf: $(OUTDIR)/$(TARGET).elf
+
+# One JSON object per line and benchmark, see benchmarks/common/benchmark.h
+.PHONY: json
+json: $(OUTDIR)/bench-reports/$(TARGET).json
+
+$(OUTDIR)/bench-reports/$(TARGET).json: $(OUTDIR)/$(TARGET).elf
+	$(V0) @echo " BENCH JSON $(MSG_EXTRA)  $(call toprel, $@)"
+	$(V1) $(MKDIR) -p $(dir $@)
+	$(V1) $< > $@
+
+.PHONY: run
+run: $(OUTDIR)/$(TARGET).elf
+	$(V0) @echo " BENCH RUN $(MSG_EXTRA)  $(call toprel, $<)"
+	$(V1) $<
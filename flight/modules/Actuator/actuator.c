@@ -211,6 +211,9 @@ static void actuatorTask(__attribute__((unused)) void *parameters)
     MixerStatusData mixerStatus;
     FlightModeSettingsData settings;
     FlightStatusData flightStatus;
+    // FlightModeSettings and FlightStatus rarely change, only copy them when they do
+    UAVObjDataCache settingsCache     = { 0 };
+    UAVObjDataCache flightStatusCache = { 0 };
     float throttleDesired;
     float collectiveDesired;
 
@@ -254,8 +257,8 @@ static void actuatorTask(__attribute__((unused)) void *parameters)
         dTMilliseconds = (thisSysTime == lastSysTime) ? 1 : (thisSysTime - lastSysTime) * portTICK_RATE_MS;
         lastSysTime    = thisSysTime;
 
-        FlightStatusGet(&flightStatus);
-        FlightModeSettingsGet(&settings);
+        FlightStatusGetCached(&flightStatus, &flightStatusCache);
+        FlightModeSettingsGetCached(&settings, &settingsCache);
         ActuatorDesiredGet(&desired);
         ActuatorCommandGet(&command);
 
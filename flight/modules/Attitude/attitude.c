@@ -71,6 +71,8 @@
 #include <pios_notify.h>
 #include <mathmisc.h>
 #include <pios_constants.h>
+
+#define PIOS_INSTRUMENT_MODULE
 #include <pios_instrumentation_helper.h>
 
 PERF_DEFINE_COUNTER(counterUpd);
@@ -285,8 +287,8 @@ static void AttitudeTask(__attribute__((unused)) void *parameters)
     }
 
     PERF_INIT_COUNTER(counterUpd, 0xA7710001);
-    PERF_INIT_COUNTER(counterAtt, 0xA7710002);
-    PERF_INIT_COUNTER(counterPeriod, 0xA7710003);
+    PERF_INIT_HISTOGRAM_COUNTER(counterAtt, 0xA7710002);
+    PERF_INIT_HISTOGRAM_COUNTER(counterPeriod, 0xA7710003);
     PERF_INIT_COUNTER(counterAccelSamples, 0xA7710004);
 
     // Force settings update to make sure rotation loaded
@@ -37,6 +37,9 @@
 #include "debuglogentry.h"
 #include "flightstatus.h"
 
+// private defines
+#define STREAM_MAX_ENTRIES 8 // DebugLogEntry instances used to stream a window of entries
+
 // private variables
 static DebugLogSettingsData settings;
 static DebugLogControlData control;
@@ -49,6 +52,7 @@ static void SettingsUpdatedCb(UAVObjEvent *ev);
 static void ControlUpdatedCb(UAVObjEvent *ev);
 static void StatusUpdatedCb(UAVObjEvent *ev);
 static void FlightStatusUpdatedCb(UAVObjEvent *ev);
+static void StreamEntries(uint16_t flight, uint16_t first, uint8_t count);
 
 int32_t LoggingInitialize(void)
 {
@@ -133,6 +137,8 @@ static void ControlUpdatedCb(__attribute__((unused)) UAVObjEvent *ev)
             entry->Type   = DEBUGLOGENTRY_TYPE_EMPTY;
         }
         DebugLogEntrySet(entry);
+    } else if (control.Operation == DEBUGLOGCONTROL_OPERATION_STREAM) {
+        StreamEntries(control.Flight, control.Entry, control.Count);
     } else if (control.Operation == DEBUGLOGCONTROL_OPERATION_FORMATFLASH) {
         FlightStatusArmedOptions armed;
         FlightStatusArmedGet(&armed);
@@ -143,6 +149,45 @@ static void ControlUpdatedCb(__attribute__((unused)) UAVObjEvent *ev)
     StatusUpdatedCb(ev);
 }
 
+/**
+ * Push a window of consecutive entries without waiting for a request per entry.
+ * Entry n goes to DebugLogEntry instance n modulo STREAM_MAX_ENTRIES, so that none
+ * is overwritten before telemetry sent it while the GCS keeps several consecutive
+ * windows in flight. Nothing is sent if the instances can not be allocated, the
+ * GCS then falls back to retrieving entry by entry.
+ */
+static void StreamEntries(uint16_t flight, uint16_t first, uint8_t count)
+{
+    uint16_t instances = UAVObjGetNumInstances(DebugLogEntryHandle());
+
+    if (count > STREAM_MAX_ENTRIES) {
+        count = STREAM_MAX_ENTRIES;
+    }
+    // instances are only allocated once a download was streamed
+    while (instances < STREAM_MAX_ENTRIES) {
+        DebugLogEntryCreateInstance();
+        if (UAVObjGetNumInstances(DebugLogEntryHandle()) == instances) {
+            return;
+        }
+        instances++;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        memset(entry, 0, sizeof(DebugLogEntryData));
+        if (PIOS_DEBUGLOG_Read(entry, flight, first + i) != 0) {
+            // end of the flight, the empty entry tells the GCS
+            entry->Flight = flight;
+            entry->Entry  = first + i;
+            entry->Type   = DEBUGLOGENTRY_TYPE_EMPTY;
+        }
+        DebugLogEntryInstSet((first + i) % STREAM_MAX_ENTRIES, entry);
+        DebugLogEntryInstUpdated((first + i) % STREAM_MAX_ENTRIES);
+        if (entry->Type == DEBUGLOGENTRY_TYPE_EMPTY) {
+            break;
+        }
+    }
+}
+
 
 /**
  * @}
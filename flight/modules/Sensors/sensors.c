@@ -131,6 +131,7 @@ PERF_DEFINE_COUNTER(counterMagPeriod);
 PERF_DEFINE_COUNTER(counterBaroPeriod);
 PERF_DEFINE_COUNTER(counterSensorPeriod);
 PERF_DEFINE_COUNTER(counterSensorResets);
+PERF_DEFINE_COUNTER(counterSensorDropped);
 
 #if defined(PIOS_INCLUDE_HMC5X83)
 void aux_hmc5x83_load_settings();
@@ -140,7 +141,8 @@ void aux_hmc5x83_load_settings();
 static void SensorsTask(void *parameters);
 static void settingsUpdatedCb(UAVObjEvent *objEv);
 
-static void accumulateSamples(sensor_fetch_context *sensor_context, sensor_data *sample);
+static void accumulateSamples(sensor_fetch_context *sensor_context, const sensor_data *sample);
+static void accumulateRing(sensor_fetch_context *sensor_context, struct pios_sensors_ring *ring, bool wait);
 static void processSamples3d(sensor_fetch_context *sensor_context, const PIOS_SENSORS_Instance *sensor);
 static void processSamples1d(PIOS_SENSORS_1Axis_SensorsWithTemp *sample, const PIOS_SENSORS_Instance *sensor);
 
@@ -272,8 +274,9 @@ static void SensorsTask(__attribute__((unused)) void *parameters)
     PERF_INIT_COUNTER(counterAccelPeriod, 0x53000002);
     PERF_INIT_COUNTER(counterMagPeriod, 0x53000003);
     PERF_INIT_COUNTER(counterBaroPeriod, 0x53000004);
-    PERF_INIT_COUNTER(counterSensorPeriod, 0x53000005);
+    PERF_INIT_HISTOGRAM_COUNTER(counterSensorPeriod, 0x53000005);
     PERF_INIT_COUNTER(counterSensorResets, 0x53000006);
+    PERF_INIT_COUNTER(counterSensorDropped, 0x53000007);
 
     // Test sensors
     bool sensors_test = true;
@@ -317,11 +320,17 @@ static void SensorsTask(__attribute__((unused)) void *parameters)
             bool is_primary = (sensor->type & PIOS_SENSORS_TYPE_3AXIS_ACCEL);
 
             if (!sensor->driver->is_polled) {
-                const QueueHandle_t queue = PIOS_SENSORS_GetQueue(sensor);
-                while (xQueueReceive(queue,
-                                     (void *)source_data,
-                                     (is_primary && !sensor_context.count) ? sensor_period_ticks : 0) == pdTRUE) {
-                    accumulateSamples(&sensor_context, source_data);
+                struct pios_sensors_ring *ring = PIOS_SENSORS_GetRing(sensor);
+                if (ring) {
+                    accumulateRing(&sensor_context, ring, is_primary);
+                    PERF_TRACK_VALUE(counterSensorDropped, PIOS_SENSORS_RingDropped(ring));
+                } else {
+                    const QueueHandle_t queue = PIOS_SENSORS_GetQueue(sensor);
+                    while (xQueueReceive(queue,
+                                         (void *)source_data,
+                                         (is_primary && !sensor_context.count) ? sensor_period_ticks : 0) == pdTRUE) {
+                        accumulateSamples(&sensor_context, source_data);
+                    }
                 }
                 if (sensor_context.count) {
                     processSamples3d(&sensor_context, sensor);
@@ -365,7 +374,7 @@ static void clearContext(sensor_fetch_context *sensor_context)
     sensor_context->count     = 0;
 }
 
-static void accumulateSamples(sensor_fetch_context *sensor_context, sensor_data *sample)
+static void accumulateSamples(sensor_fetch_context *sensor_context, const sensor_data *sample)
 {
     for (uint32_t i = 0; (i < MAX_SENSORS_PER_INSTANCE) && (i < sample->sensorSample3Axis.count); i++) {
         sensor_context->accum[i].x += sample->sensorSample3Axis.sample[i].x;
@@ -384,6 +393,25 @@ static void accumulateSamples(sensor_fetch_context *sensor_context, sensor_data
     sensor_context->count++;
 }
 
+/**
+ * Accumulate all samples queued in a sensor ring, batch by batch and in place.
+ * The primary sensor is waited for up to one sensor period, the interrupt
+ * handler wakes this task when the first sample of a batch arrives.
+ */
+static void accumulateRing(sensor_fetch_context *sensor_context, struct pios_sensors_ring *ring, bool wait)
+{
+    const void *samples;
+    uint16_t count = wait ? PIOS_SENSORS_RingWait(ring, &samples, sensor_period_ticks) : PIOS_SENSORS_RingPeek(ring, &samples);
+
+    while (count) {
+        for (uint16_t i = 0; i < count; i++) {
+            accumulateSamples(sensor_context, (const sensor_data *)((const uint8_t *)samples + i * ring->sample_size));
+        }
+        PIOS_SENSORS_RingRelease(ring, count);
+        count = PIOS_SENSORS_RingPeek(ring, &samples);
+    }
+}
+
 static void processSamples3d(sensor_fetch_context *sensor_context, const PIOS_SENSORS_Instance *sensor)
 {
     float samples[3];
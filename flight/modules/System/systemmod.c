@@ -474,8 +474,9 @@ static void callbackSchedulerForEachCallback(int16_t callback_id, const struct p
     // of the CallbackInfoXXXXElem enums
     PIOS_DEBUG_Assert(callback_id < CALLBACKINFO_RUNNING_NUMELEM);
     ((uint8_t *)&callbackData->Running)[callback_id] = callback_info->is_running;
-    ((uint32_t *)&callbackData->RunningTime)[callback_id]   = callback_info->running_time_count;
-    ((int16_t *)&callbackData->StackRemaining)[callback_id] = callback_info->stack_remaining;
+    ((uint32_t *)&callbackData->RunningTime)[callback_id]        = callback_info->running_time_count;
+    ((int16_t *)&callbackData->StackRemaining)[callback_id]      = callback_info->stack_remaining;
+    ((uint32_t *)&callbackData->DispatchLatencyMax)[callback_id] = callback_info->dispatch_latency_max_us;
 }
 #endif /* ifdef DIAG_TASKS */
 
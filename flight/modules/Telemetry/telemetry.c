@@ -906,6 +906,9 @@ static void updateTelemetryStats()
         AlarmsClear(SYSTEMALARMS_ALARM_TELEMETRY);
     }
 
+    // Lets the GCS skip retrieving settings it already has
+    flightStats.SettingsHash = UAVObjGetSettingsHash();
+
     // Update object
     FlightTelemetryStatsSet(&flightStats);
 
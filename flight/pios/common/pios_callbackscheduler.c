@@ -43,7 +43,14 @@
  */
 struct DelayedCallbackTaskStruct {
     DelayedCallbackInfo *callbackQueue[CALLBACK_PRIORITY_LOW + 1];
-    DelayedCallbackInfo *queueCursor[CALLBACK_PRIORITY_LOW + 1];
+    // FIFOs of dispatched callbacks, written by Dispatch() from any context
+    DelayedCallbackInfo *readyHead[CALLBACK_PRIORITY_LOW + 1];
+    DelayedCallbackInfo *readyTail[CALLBACK_PRIORITY_LOW + 1];
+    uint16_t readyCount[CALLBACK_PRIORITY_LOW + 1];
+    uint16_t roundLeft[CALLBACK_PRIORITY_LOW + 1]; // runs left in the current round of each priority
+    uint8_t  readyMask; // bit p set if readyHead[p] is not empty
+    // pairing heap of scheduled callbacks ordered by scheduletime, mutex protected
+    DelayedCallbackInfo *deadlineRoot;
     xTaskHandle callbackSchedulerTaskHandle;
     char name[3];
     uint32_t    stackSize;
@@ -58,8 +65,13 @@ struct DelayedCallbackTaskStruct {
 struct DelayedCallbackInfoStruct {
     DelayedCallback   cb;
     int16_t callbackID;
+    DelayedCallbackPriority priority;
     bool volatile     waiting;
     uint32_t volatile scheduletime;
+    bool     deadlineQueued; // in the deadline heap of the task
+    uint32_t dispatchTime; // PIOS_DELAY_GetRaw() at dispatch
+    uint32_t latencyMax; // longest time from dispatch to run in us
+    uint32_t latencyAvg; // running average of the time from dispatch to run in us
     uint32_t stackSize;
     int32_t  stackFree;
     int32_t  stackNotFree;
@@ -68,6 +80,11 @@ struct DelayedCallbackInfoStruct {
     uint32_t runCount;
     struct DelayedCallbackTaskStruct *task;
     struct DelayedCallbackInfoStruct *next;
+    struct DelayedCallbackInfoStruct *readyNext;
+    // deadline heap links: first child, next sibling and parent or previous sibling
+    struct DelayedCallbackInfoStruct *deadlineChild;
+    struct DelayedCallbackInfoStruct *deadlineNext;
+    struct DelayedCallbackInfoStruct *deadlinePrev;
 };
 
 
@@ -78,7 +95,11 @@ static bool schedulerStarted;
 
 // Private functions
 static void CallbackSchedulerTask(void *task);
-static int32_t runNextCallback(struct DelayedCallbackTaskStruct *task, DelayedCallbackPriority priority);
+static int32_t runNextCallback(struct DelayedCallbackTaskStruct *task);
+static void enqueueReady(DelayedCallbackInfo *cbinfo);
+static void deadlineInsert(struct DelayedCallbackTaskStruct *task, DelayedCallbackInfo *cbinfo);
+static void deadlineUpdate(struct DelayedCallbackTaskStruct *task, DelayedCallbackInfo *cbinfo);
+static void deadlineRemove(struct DelayedCallbackTaskStruct *task, DelayedCallbackInfo *cbinfo);
 
 /**
  * Initialize the scheduler
@@ -187,6 +208,11 @@ int32_t PIOS_CALLBACKSCHEDULER_Schedule(
             result = 2;
         }
         cbinfo->scheduletime = new;
+        if (!cbinfo->deadlineQueued) {
+            deadlineInsert(cbinfo->task, cbinfo);
+        } else {
+            deadlineUpdate(cbinfo->task, cbinfo);
+        }
 
         // scheduler needs to be notified to adapt sleep times
         xSemaphoreGive(cbinfo->task->signal);
@@ -207,9 +233,11 @@ int32_t PIOS_CALLBACKSCHEDULER_Dispatch(DelayedCallbackInfo *cbinfo)
 {
     PIOS_Assert(cbinfo);
 
-    // no semaphore needed for the callback
-    cbinfo->waiting = true;
-    // but the scheduler as a whole needs to be notified
+    // the ready queues are shared with interrupt handlers
+    taskENTER_CRITICAL();
+    enqueueReady(cbinfo);
+    taskEXIT_CRITICAL();
+    // the scheduler as a whole needs to be notified
     return xSemaphoreGive(cbinfo->task->signal);
 }
 
@@ -231,9 +259,10 @@ int32_t PIOS_CALLBACKSCHEDULER_DispatchFromISR(DelayedCallbackInfo *cbinfo, long
 {
     PIOS_Assert(cbinfo);
 
-    // no semaphore needed for the callback
-    cbinfo->waiting = true;
-    // but the scheduler as a whole needs to be notified
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    enqueueReady(cbinfo);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    // the scheduler as a whole needs to be notified
     return xSemaphoreGiveFromISR(cbinfo->task->signal, pxHigherPriorityTaskWoken);
 }
 
@@ -282,8 +311,13 @@ DelayedCallbackInfo *PIOS_CALLBACKSCHEDULER_Create(
         // initialize structure
         for (DelayedCallbackPriority p = 0; p <= CALLBACK_PRIORITY_LOW; p++) {
             task->callbackQueue[p] = NULL;
-            task->queueCursor[p]   = NULL;
+            task->readyHead[p]     = NULL;
+            task->readyTail[p]     = NULL;
+            task->readyCount[p]    = 0;
+            task->roundLeft[p]     = 0;
         }
+        task->readyMask    = 0;
+        task->deadlineRoot = NULL;
         task->name[0]      = 'C';
         task->name[1]      = 'a' + t;
         task->name[2]      = 0;
@@ -335,8 +369,17 @@ DelayedCallbackInfo *PIOS_CALLBACKSCHEDULER_Create(
         return NULL; // error - not enough memory
     }
     info->next               = NULL;
+    info->readyNext          = NULL;
+    info->priority           = priority;
     info->waiting            = false;
     info->scheduletime       = 0;
+    info->deadlineQueued     = false;
+    info->deadlineChild      = NULL;
+    info->deadlineNext       = NULL;
+    info->deadlinePrev       = NULL;
+    info->dispatchTime       = 0;
+    info->latencyMax         = 0;
+    info->latencyAvg         = 0;
     info->task               = task;
     info->cb = cb;
     info->callbackID         = callbackID;
@@ -380,6 +423,8 @@ void PIOS_CALLBACKSCHEDULER_ForEachCallback(CallbackSchedulerCallbackInfoCallbac
                 info.is_running = true;
                 info.stack_remaining    = cbinfo->stackNotFree;
                 info.running_time_count = cbinfo->runCount;
+                info.dispatch_latency_max_us = cbinfo->latencyMax;
+                info.dispatch_latency_avg_us = cbinfo->latencyAvg;
                 xSemaphoreGiveRecursive(mutex);
                 callback(cbinfo->callbackID, &info, context);
             }
@@ -458,75 +503,242 @@ static void checkStack(DelayedCallbackInfo *current)
 }
 
 /**
- * Scheduler subtask
+ * Append a callback to the ready queue of its priority unless it is already waiting.
+ * Must be called with interrupts masked.
+ * \param[in] cbinfo the callback handle
+ */
+static void enqueueReady(DelayedCallbackInfo *cbinfo)
+{
+    struct DelayedCallbackTaskStruct *task = cbinfo->task;
+    DelayedCallbackPriority priority = cbinfo->priority;
+
+    if (cbinfo->waiting) {
+        return; // already queued, a callback runs once no matter how often it got dispatched
+    }
+    cbinfo->waiting      = true;
+    cbinfo->dispatchTime = PIOS_DELAY_GetRaw();
+    cbinfo->readyNext    = NULL;
+    if (task->readyTail[priority]) {
+        task->readyTail[priority]->readyNext = cbinfo;
+    } else {
+        task->readyHead[priority] = cbinfo;
+    }
+    task->readyTail[priority] = cbinfo;
+    task->readyCount[priority]++;
+    task->readyMask |= 1 << priority;
+}
+
+/**
+ * Pick the next callback to run, highest priority first, and take it off its ready queue.
+ * Each time a priority has run as many callbacks as were queued at the start of its
+ * round, one callback of the next lower priority is run before the next round starts.
+ * Must be called with interrupts masked.
  * \param[in] task The scheduler task in question
- * \param[in] priority The scheduling priority of the callback to search for
- * \return wait time until next scheduled callback is due - 0 if a callback has just been executed
+ * \param[in] priority The highest priority to consider
+ * \return the callback, NULL if none of priority or lower is ready
  */
-static int32_t runNextCallback(struct DelayedCallbackTaskStruct *task, DelayedCallbackPriority priority)
+static DelayedCallbackInfo *dequeueReady(struct DelayedCallbackTaskStruct *task, DelayedCallbackPriority priority)
 {
-    int32_t result = MAX_SLEEP;
-    int32_t diff   = 0;
+    uint8_t mask = task->readyMask >> priority;
 
-    // no such queue
-    if (priority > CALLBACK_PRIORITY_LOW) {
-        return result;
+    if (!mask) {
+        return NULL;
+    }
+    priority += __builtin_ctz(mask);
+
+    if (!task->roundLeft[priority]) {
+        // round completed, give the next lower priority its turn
+        task->roundLeft[priority] = task->readyCount[priority];
+        if (priority < CALLBACK_PRIORITY_LOW) {
+            DelayedCallbackInfo *lower = dequeueReady(task, priority + 1);
+            if (lower) {
+                return lower;
+            }
+        }
     }
+    task->roundLeft[priority]--;
 
-    // queue is empty, search a lower priority queue
-    if (task->callbackQueue[priority] == NULL) {
-        return runNextCallback(task, priority + 1);
+    DelayedCallbackInfo *current = task->readyHead[priority];
+    task->readyHead[priority] = current->readyNext;
+    if (!task->readyHead[priority]) {
+        task->readyTail[priority] = NULL;
+        task->readyMask &= ~(1 << priority);
     }
+    task->readyCount[priority]--;
+    current->waiting = false; // the flag is reset just before execution.
 
-    DelayedCallbackInfo *current = task->queueCursor[priority];
-    DelayedCallbackInfo *next;
-    do {
-        if (current == NULL) {
-            next = task->callbackQueue[priority]; // loop around the end of the list
-            // also attempt to run a callback that has lower priority
-            // every time the queue is completely traversed
-            diff = runNextCallback(task, priority + 1);
-            if (!diff) {
-                task->queueCursor[priority] = next; // the recursive call has executed a callback
-                return 0;
-            }
-            if (diff < result) {
-                result = diff; // adjust sleep time
-            }
+    return current;
+}
+
+/**
+ * Deadline heap, a pairing heap ordered by scheduletime. Its links live in the
+ * callbacks, so scheduling never allocates. Must be called with the mutex held.
+ */
+static inline bool deadlineBefore(const DelayedCallbackInfo *a, const DelayedCallbackInfo *b)
+{
+    return (int32_t)(a->scheduletime - b->scheduletime) < 0; // uint32_t tick counts wrap around
+}
+
+/**
+ * Meld two heaps, the later root becomes the first child of the earlier one
+ */
+static DelayedCallbackInfo *deadlineMeld(DelayedCallbackInfo *a, DelayedCallbackInfo *b)
+{
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    if (deadlineBefore(b, a)) {
+        DelayedCallbackInfo *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->deadlineNext = a->deadlineChild;
+    if (a->deadlineChild) {
+        a->deadlineChild->deadlinePrev = b;
+    }
+    b->deadlinePrev  = a;
+    a->deadlineChild = b;
+    return a;
+}
+
+/**
+ * Meld a list of siblings into one heap, in pairs from left to right and
+ * then the pairs from right to left
+ */
+static DelayedCallbackInfo *deadlineMergePairs(DelayedCallbackInfo *first)
+{
+    DelayedCallbackInfo *pairs = NULL;
+
+    while (first) {
+        DelayedCallbackInfo *a = first;
+        DelayedCallbackInfo *b = a->deadlineNext;
+        first = b ? b->deadlineNext : NULL;
+        a->deadlineNext = NULL;
+        a->deadlinePrev = NULL;
+        if (b) {
+            b->deadlineNext = NULL;
+            b->deadlinePrev = NULL;
+        }
+        a = deadlineMeld(a, b);
+        // the melded pairs are stacked through deadlineNext
+        a->deadlineNext = pairs;
+        pairs = a;
+    }
+
+    DelayedCallbackInfo *root = NULL;
+    while (pairs) {
+        DelayedCallbackInfo *next = pairs->deadlineNext;
+        pairs->deadlineNext = NULL;
+        root  = deadlineMeld(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+static void deadlineInsert(struct DelayedCallbackTaskStruct *task, DelayedCallbackInfo *cbinfo)
+{
+    cbinfo->deadlineChild  = NULL;
+    cbinfo->deadlineNext   = NULL;
+    cbinfo->deadlinePrev   = NULL;
+    cbinfo->deadlineQueued = true;
+    task->deadlineRoot     = deadlineMeld(task->deadlineRoot, cbinfo);
+}
+
+static void deadlineRemove(struct DelayedCallbackTaskStruct *task, DelayedCallbackInfo *cbinfo)
+{
+    DelayedCallbackInfo *children = deadlineMergePairs(cbinfo->deadlineChild);
+
+    if (cbinfo == task->deadlineRoot) {
+        task->deadlineRoot = children;
+    } else {
+        // unlink the subtree from its parent or previous sibling
+        if (cbinfo->deadlinePrev->deadlineChild == cbinfo) {
+            cbinfo->deadlinePrev->deadlineChild = cbinfo->deadlineNext;
         } else {
-            next = current->next;
-            xSemaphoreTakeRecursive(mutex, portMAX_DELAY); // access to scheduletime should be mutex protected
-            if (current->scheduletime) {
-                diff = current->scheduletime - xTaskGetTickCount();
-                if (diff <= 0) {
-                    current->waiting = true;
-                } else if (diff < result) {
+            cbinfo->deadlinePrev->deadlineNext = cbinfo->deadlineNext;
+        }
+        if (cbinfo->deadlineNext) {
+            cbinfo->deadlineNext->deadlinePrev = cbinfo->deadlinePrev;
+        }
+        task->deadlineRoot = deadlineMeld(task->deadlineRoot, children);
+    }
+    cbinfo->deadlineChild  = NULL;
+    cbinfo->deadlineNext   = NULL;
+    cbinfo->deadlinePrev   = NULL;
+    cbinfo->deadlineQueued = false;
+}
+
+static void deadlineUpdate(struct DelayedCallbackTaskStruct *task, DelayedCallbackInfo *cbinfo)
+{
+    deadlineRemove(task, cbinfo);
+    deadlineInsert(task, cbinfo);
+}
+
+/**
+ * Scheduler subtask
+ * \param[in] task The scheduler task in question
+ * \return wait time until next scheduled callback is due - 0 if a callback has just been executed
+ */
+static int32_t runNextCallback(struct DelayedCallbackTaskStruct *task)
+{
+    int32_t result = MAX_SLEEP;
+
+    // move all callbacks that are due to the ready queues
+    if (task->deadlineRoot) {
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY); // access to scheduletime should be mutex protected
+        uint32_t now = xTaskGetTickCount();
+        while (task->deadlineRoot) {
+            DelayedCallbackInfo *next = task->deadlineRoot;
+            int32_t diff = next->scheduletime - now;
+            if (diff > 0) {
+                if (diff < result) {
                     result = diff; // adjust sleep time
                 }
+                break;
             }
-            if (current->waiting) {
-                task->queueCursor[priority] = next;
-                current->scheduletime = 0; // any schedules are reset
-                current->waiting = false; // the flag is reset just before execution.
-                xSemaphoreGiveRecursive(mutex);
+            deadlineRemove(task, next);
+            taskENTER_CRITICAL();
+            enqueueReady(next);
+            taskEXIT_CRITICAL();
+        }
+        xSemaphoreGiveRecursive(mutex);
+    }
+
+    taskENTER_CRITICAL();
+    DelayedCallbackInfo *current = dequeueReady(task, CALLBACK_PRIORITY_CRITICAL);
+    taskEXIT_CRITICAL();
+    if (!current) {
+        return result; // nothing to do
+    }
+
+    if (current->scheduletime) {
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+        current->scheduletime = 0; // any schedules are reset
+        if (current->deadlineQueued) {
+            deadlineRemove(task, current);
+        }
+        xSemaphoreGiveRecursive(mutex);
+    }
 
-                /* callback gets invoked here - check stack sizes */
-                markStack(current);
+    uint32_t latency = PIOS_DELAY_DiffuS(current->dispatchTime);
+    if (latency > current->latencyMax) {
+        current->latencyMax = latency;
+    }
+    current->latencyAvg = (current->latencyAvg * 15 + latency) / 16;
 
-                current->cb(); // call the callback
+    /* callback gets invoked here - check stack sizes */
+    markStack(current);
 
-                checkStack(current);
+    current->cb(); // call the callback
 
-                current->runCount++;
+    checkStack(current);
 
-                return 0;
-            }
-            xSemaphoreGiveRecursive(mutex);
-        }
-        current = next;
-    } while (current != task->queueCursor[priority]);
-    // once the list has been traversed entirely without finding any to be executed task, abort (nothing to do)
-    return result;
+    current->runCount++;
+
+    return 0;
 }
 
 /**
@@ -538,7 +750,7 @@ static void CallbackSchedulerTask(void *task)
     uint32_t delay = 0;
 
     while (1) {
-        delay = runNextCallback((struct DelayedCallbackTaskStruct *)task, CALLBACK_PRIORITY_CRITICAL);
+        delay = runNextCallback((struct DelayedCallbackTaskStruct *)task);
         if (delay) {
             // nothing to do but sleep
             xSemaphoreTake(((struct DelayedCallbackTaskStruct *)task)->signal, delay);
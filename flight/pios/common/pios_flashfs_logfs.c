@@ -30,15 +30,32 @@
 #ifdef PIOS_INCLUDE_FLASH
 
 #include <stdbool.h>
+#include <string.h>
 #include <openpilot.h>
 #include <pios_math.h>
 #include <pios_wdg.h>
 #include "pios_flashfs_logfs_priv.h"
 
+/*
+ * Maximum number of objects in the RAM slot index, 8 bytes per entry.
+ * With more objects than that, or 0 on boards short of RAM, objects
+ * are looked up by scanning the slot headers in flash.
+ */
+#ifndef PIOS_FLASHFS_LOGFS_INDEX_SIZE
+#define PIOS_FLASHFS_LOGFS_INDEX_SIZE 256
+#endif
+
 /*
  * Filesystem state data tracked in RAM
  */
 
+/* Maps an object instance to the slot of its active copy, sorted by object and instance */
+struct logfs_index_entry {
+    uint32_t obj_id;
+    uint16_t obj_inst_id;
+    uint16_t slot_id;
+};
+
 enum pios_flashfs_logfs_dev_magic {
     PIOS_FLASHFS_LOGFS_DEV_MAGIC = 0x94938201,
 };
@@ -56,6 +73,12 @@ struct logfs_state {
     uint16_t num_free_slots; /* slots in free state */
     uint16_t num_active_slots; /* slots in active state */
 
+    /* Index of all active slots, only trusted while index_valid is set */
+    struct logfs_index_entry *index;
+    uint16_t index_size; /* entries allocated */
+    uint16_t index_count; /* entries in use */
+    bool     index_valid;
+
     /* Underlying flash driver glue */
     const struct pios_flash_driver *driver;
     uintptr_t flash_id;
@@ -416,12 +439,83 @@ static bool logfs_log_is_full(const struct logfs_state *logfs)
     return logfs->num_free_slots == 0;
 }
 
+/*
+ * Binary search of the slot index
+ * true = found, *pos is the entry
+ * false = not found, *pos is where it would be inserted
+ */
+static bool logfs_index_lookup(const struct logfs_state *logfs, uint32_t obj_id, uint16_t obj_inst_id, uint16_t *pos)
+{
+    uint16_t lo = 0;
+    uint16_t hi = logfs->index_count;
+
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        const struct logfs_index_entry *entry = &logfs->index[mid];
+        if (entry->obj_id < obj_id ||
+            (entry->obj_id == obj_id && entry->obj_inst_id < obj_inst_id)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *pos = lo;
+
+    return lo < logfs->index_count &&
+           logfs->index[lo].obj_id == obj_id &&
+           logfs->index[lo].obj_inst_id == obj_inst_id;
+}
+
+/*
+ * Record a newly active slot. An index that overflows, or that would
+ * have to map an object to two active slots, is dropped until the next
+ * mount and lookups fall back to scanning the log.
+ */
+static void logfs_index_add(struct logfs_state *logfs, uint32_t obj_id, uint16_t obj_inst_id, uint16_t slot_id)
+{
+    uint16_t pos;
+
+    if (!logfs->index_valid) {
+        return;
+    }
+    if (logfs->index_count == logfs->index_size ||
+        logfs_index_lookup(logfs, obj_id, obj_inst_id, &pos)) {
+        logfs->index_valid = false;
+        return;
+    }
+
+    memmove(&logfs->index[pos + 1], &logfs->index[pos], (logfs->index_count - pos) * sizeof(logfs->index[0]));
+    logfs->index[pos].obj_id      = obj_id;
+    logfs->index[pos].obj_inst_id = obj_inst_id;
+    logfs->index[pos].slot_id     = slot_id;
+    logfs->index_count++;
+}
+
+static void logfs_index_remove(struct logfs_state *logfs, uint32_t obj_id, uint16_t obj_inst_id)
+{
+    uint16_t pos;
+
+    if (!logfs->index_valid || !logfs_index_lookup(logfs, obj_id, obj_inst_id, &pos)) {
+        return;
+    }
+
+    logfs->index_count--;
+    memmove(&logfs->index[pos], &logfs->index[pos + 1], (logfs->index_count - pos) * sizeof(logfs->index[0]));
+}
+
+static void logfs_index_reset(struct logfs_state *logfs)
+{
+    logfs->index_count = 0;
+    logfs->index_valid = (logfs->index != NULL);
+}
+
 static int32_t logfs_unmount_log(struct logfs_state *logfs)
 {
     PIOS_Assert(logfs->mounted);
 
     logfs->num_active_slots = 0;
     logfs->num_free_slots   = 0;
+    logfs_index_reset(logfs);
     logfs->mounted = false;
 
     return 0;
@@ -434,8 +528,9 @@ static int32_t logfs_mount_log(struct logfs_state *logfs, uint8_t arena_id)
     logfs->num_active_slots = 0;
     logfs->num_free_slots   = 0;
     logfs->active_arena_id  = arena_id;
+    logfs_index_reset(logfs);
 
-    /* Scan the log to find out how full it is */
+    /* Scan the log to find out how full it is, and index the active slots */
     for (uint16_t slot_id = 1;
          slot_id < (logfs->cfg->arena_size / logfs->cfg->slot_size);
          slot_id++) {
@@ -467,6 +562,7 @@ static int32_t logfs_mount_log(struct logfs_state *logfs, uint8_t arena_id)
             break;
         case SLOT_STATE_ACTIVE:
             logfs->num_active_slots++;
+            logfs_index_add(logfs, slot_hdr.obj_id, slot_hdr.obj_inst_id, slot_id);
             break;
         case SLOT_STATE_RESERVED:
         case SLOT_STATE_OBSOLETE:
@@ -493,7 +589,7 @@ static bool PIOS_FLASHFS_Logfs_validate(const struct logfs_state *logfs)
 }
 
 #if defined(PIOS_INCLUDE_FREERTOS)
-static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(void)
+static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(const struct flashfs_logfs_cfg *cfg)
 {
     struct logfs_state *logfs;
 
@@ -502,6 +598,16 @@ static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(void)
         return NULL;
     }
 
+    /* No index needs more entries than there are slots, running without one is fine */
+    logfs->index_size = MIN(PIOS_FLASHFS_LOGFS_INDEX_SIZE, (cfg->arena_size / cfg->slot_size) - 1);
+    logfs->index = NULL;
+    if (logfs->index_size) {
+        logfs->index = (struct logfs_index_entry *)pios_malloc(logfs->index_size * sizeof(struct logfs_index_entry));
+    }
+    if (!logfs->index) {
+        logfs->index_size = 0;
+    }
+
     logfs->magic = PIOS_FLASHFS_LOGFS_DEV_MAGIC;
     return logfs;
 }
@@ -509,12 +615,15 @@ static void PIOS_FLASHFS_Logfs_free(struct logfs_state *logfs)
 {
     /* Invalidate the magic */
     logfs->magic = ~PIOS_FLASHFS_LOGFS_DEV_MAGIC;
+    if (logfs->index) {
+        vPortFree(logfs->index);
+    }
     vPortFree(logfs);
 }
 #else
 static struct logfs_state pios_flashfs_logfs_devs[PIOS_FLASHFS_LOGFS_MAX_DEVS];
 static uint8_t pios_flashfs_logfs_num_devs;
-static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(void)
+static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(__attribute__((unused)) const struct flashfs_logfs_cfg *cfg)
 {
     struct logfs_state *logfs;
 
@@ -525,6 +634,10 @@ static struct logfs_state *PIOS_FLASHFS_Logfs_alloc(void)
     logfs = &pios_flashfs_logfs_devs[pios_flashfs_logfs_num_devs++];
     logfs->magic = PIOS_FLASHFS_LOGFS_DEV_MAGIC;
 
+    /* No heap, always scan the log */
+    logfs->index = NULL;
+    logfs->index_size = 0;
+
     return logfs;
 }
 static void PIOS_FLASHFS_Logfs_free(struct logfs_state *logfs)
@@ -565,7 +678,7 @@ int32_t PIOS_FLASHFS_Logfs_Init(uintptr_t *fs_id, const struct flashfs_logfs_cfg
 
     struct logfs_state *logfs;
 
-    logfs = (struct logfs_state *)PIOS_FLASHFS_Logfs_alloc();
+    logfs = (struct logfs_state *)PIOS_FLASHFS_Logfs_alloc(cfg);
     if (logfs) {
         while (rc && count++ < 2) {
             /* Bind configuration parameters to this filesystem instance */
@@ -756,8 +869,45 @@ static int16_t logfs_object_find_next(const struct logfs_state *logfs, struct sl
     return -1;
 }
 
+/*
+ * Find the active slot of an object through the index, or by scanning the
+ * log from *slot_id on if there is no valid index. A slot header that does
+ * not match its index entry drops the index and falls back to the scan.
+ * NOTE: Must be called while holding the flash transaction lock
+ */
+static int16_t logfs_object_find(struct logfs_state *logfs, struct slot_header *slot_hdr, uint16_t *slot_id, uint32_t obj_id, uint16_t obj_inst_id)
+{
+    uint16_t pos;
+
+    if (logfs->index_valid) {
+        if (!logfs_index_lookup(logfs, obj_id, obj_inst_id, &pos)) {
+            /* No matching entry was found */
+            return -1;
+        }
+
+        uintptr_t slot_addr = logfs_get_addr(logfs, logfs->active_arena_id, logfs->index[pos].slot_id);
+        if (logfs->driver->read_data(logfs->flash_id,
+                                     slot_addr,
+                                     (uint8_t *)slot_hdr,
+                                     sizeof(*slot_hdr)) != 0) {
+            return -2;
+        }
+        if (slot_hdr->state == SLOT_STATE_ACTIVE &&
+            slot_hdr->obj_id == obj_id &&
+            slot_hdr->obj_inst_id == obj_inst_id) {
+            *slot_id = logfs->index[pos].slot_id;
+            return 0;
+        }
+
+        /* Index is out of sync with the log, stop trusting it */
+        PIOS_DEBUG_Assert(0);
+        logfs->index_valid = false;
+    }
+
+    return logfs_object_find_next(logfs, slot_hdr, slot_id, obj_id, obj_inst_id);
+}
+
 /* NOTE: Must be called while holding the flash transaction lock */
-/* OPTIMIZE: could trust that there is at most one active version of every object and terminate the search when we find one */
 static int8_t logfs_delete_object(struct logfs_state *logfs, uint32_t obj_id, uint16_t obj_inst_id)
 {
     int8_t rc;
@@ -767,7 +917,7 @@ static int8_t logfs_delete_object(struct logfs_state *logfs, uint32_t obj_id, ui
 
     do {
         struct slot_header slot_hdr;
-        switch (logfs_object_find_next(logfs, &slot_hdr, &curr_slot_id, obj_id, obj_inst_id)) {
+        switch (logfs_object_find(logfs, &slot_hdr, &curr_slot_id, obj_id, obj_inst_id)) {
         case 0:
             /* Found a matching slot.  Obsolete it. */
             slot_hdr.state = SLOT_STATE_OBSOLETE;
@@ -782,6 +932,7 @@ static int8_t logfs_delete_object(struct logfs_state *logfs, uint32_t obj_id, ui
             }
             /* Object has been successfully obsoleted and is no longer active */
             logfs->num_active_slots--;
+            logfs_index_remove(logfs, obj_id, obj_inst_id);
             break;
         case -1:
             /* Search completed, object not found */
@@ -902,6 +1053,7 @@ static int8_t logfs_append_to_log(struct logfs_state *logfs, uint32_t obj_id, ui
 
     /* Object has been successfully written to the slot */
     logfs->num_active_slots++;
+    logfs_index_add(logfs, obj_id, obj_inst_id, free_slot_id);
     return 0;
 }
 
@@ -1036,7 +1188,7 @@ int32_t PIOS_FLASHFS_ObjLoad(uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst
     /* Find the object in the log */
     uint16_t slot_id = 0;
     struct slot_header slot_hdr;
-    if (logfs_object_find_next(logfs, &slot_hdr, &slot_id, obj_id, obj_inst_id) != 0) {
+    if (logfs_object_find(logfs, &slot_hdr, &slot_id, obj_id, obj_inst_id) != 0) {
         /* Object does not exist in fs */
         rc = -3;
         goto out_end_trans;
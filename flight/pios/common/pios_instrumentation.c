@@ -29,6 +29,7 @@
 pios_perf_counter_t *pios_instrumentation_perf_counters = NULL;
 int8_t pios_instrumentation_max_counters = -1;
 int8_t pios_instrumentation_last_used_counter = -1;
+uint8_t pios_instrumentation_dropped_counters  = 0;
 
 void PIOS_Instrumentation_Init(int8_t maxCounters)
 {
@@ -46,10 +47,17 @@ void PIOS_Instrumentation_Init(int8_t maxCounters)
 
 pios_counter_t PIOS_Instrumentation_CreateCounter(uint32_t id)
 {
-    PIOS_Assert(pios_instrumentation_perf_counters && (pios_instrumentation_max_counters > pios_instrumentation_last_used_counter));
+    PIOS_Assert(pios_instrumentation_perf_counters);
 
     pios_counter_t counter_handle = PIOS_Instrumentation_SearchCounter(id);
     if (!counter_handle) {
+        if (pios_instrumentation_last_used_counter + 1 >= pios_instrumentation_max_counters) {
+            // Out of counters, see PIOS_INSTRUMENTATION_MAX_COUNTERS. The count is published along with the counters
+            if (pios_instrumentation_dropped_counters < UINT8_MAX) {
+                pios_instrumentation_dropped_counters++;
+            }
+            return NULL;
+        }
         pios_perf_counter_t *newcounter = &pios_instrumentation_perf_counters[++pios_instrumentation_last_used_counter];
         newcounter->id  = id;
         newcounter->max = INT32_MIN + 1;
@@ -59,6 +67,60 @@ pios_counter_t PIOS_Instrumentation_CreateCounter(uint32_t id)
     return counter_handle;
 }
 
+pios_counter_t PIOS_Instrumentation_CreateHistogramCounter(uint32_t id)
+{
+    pios_perf_counter_t *counter = (pios_perf_counter_t *)PIOS_Instrumentation_CreateCounter(id);
+
+    if (counter && !counter->histogram) {
+        pios_perf_histogram_t *histogram = (pios_perf_histogram_t *)pvPortMalloc(sizeof(pios_perf_histogram_t));
+        PIOS_Assert(histogram);
+        memset(histogram, 0, sizeof(pios_perf_histogram_t));
+        counter->histogram = histogram;
+    }
+    return (pios_counter_t)counter;
+}
+
+int32_t PIOS_Instrumentation_HistogramPercentile(const pios_perf_counter_t *counter, uint16_t rank)
+{
+    pios_perf_histogram_t histogram;
+    uint64_t total = 0;
+
+    if (!counter->histogram) {
+        return 0;
+    }
+    vPortEnterCritical();
+    histogram = *counter->histogram;
+    vPortExitCritical();
+
+    for (uint8_t i = 0; i < PIOS_INSTRUMENTATION_HISTOGRAM_BUCKETS; i++) {
+        total += histogram.buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // rank of the sample looked for, rounded up
+    uint64_t target = (total * rank + 9999) / 10000;
+    uint64_t below  = 0;
+    for (uint8_t i = 0; i < PIOS_INSTRUMENTATION_HISTOGRAM_BUCKETS; i++) {
+        uint32_t count = histogram.buckets[i];
+        if (count > 0 && below + count >= target) {
+            if (i == 0) {
+                return 0;
+            }
+            // spread the samples evenly over [2^(i-1), 2^i), clipped to the observed max
+            uint32_t low  = 1u << (i - 1);
+            uint32_t high = (1u << i) - 1;
+            if (counter->max >= (int32_t)low && (uint32_t)counter->max < high) {
+                high = counter->max;
+            }
+            return (int32_t)(low + (uint64_t)(high - low) * (target - below) / count);
+        }
+        below += count;
+    }
+    return counter->max;
+}
+
 pios_counter_t PIOS_Instrumentation_SearchCounter(uint32_t id)
 {
     PIOS_Assert(pios_instrumentation_perf_counters);
@@ -47,6 +47,7 @@ bool PIOS_MPU6000_driver_Test(uintptr_t context);
 void PIOS_MPU6000_driver_Reset(uintptr_t context);
 void PIOS_MPU6000_driver_get_scale(float *scales, uint8_t size, uintptr_t context);
 QueueHandle_t PIOS_MPU6000_driver_get_queue(uintptr_t context);
+struct pios_sensors_ring *PIOS_MPU6000_driver_get_ring(uintptr_t context);
 
 const PIOS_SENSORS_Driver PIOS_MPU6000_Driver = {
     .test      = PIOS_MPU6000_driver_Test,
@@ -54,6 +55,7 @@ const PIOS_SENSORS_Driver PIOS_MPU6000_Driver = {
     .fetch     = NULL,
     .reset     = PIOS_MPU6000_driver_Reset,
     .get_queue = PIOS_MPU6000_driver_get_queue,
+    .get_ring  = PIOS_MPU6000_driver_get_ring,
     .get_scale = PIOS_MPU6000_driver_get_scale,
     .is_polled = false,
 };
@@ -64,6 +66,7 @@ struct mpu6000_dev {
     uint32_t spi_id;
     uint32_t slave_num;
     QueueHandle_t queue;
+    struct pios_sensors_ring *volatile ring;
     const struct pios_mpu6000_cfg *cfg;
     enum pios_mpu6000_range gyro_range;
     enum pios_mpu6000_accel_range accel_range;
@@ -135,6 +138,7 @@ static struct mpu6000_dev *PIOS_MPU6000_alloc(const struct pios_mpu6000_cfg *cfg
 
     mpu6000_dev->queue = xQueueCreate(cfg->max_downsample + 1, SENSOR_DATA_SIZE);
     PIOS_Assert(mpu6000_dev->queue);
+    mpu6000_dev->ring  = NULL;
 
     queue_data = (PIOS_SENSORS_3Axis_SensorsWithTemp *)pios_malloc(SENSOR_DATA_SIZE);
     PIOS_Assert(queue_data);
@@ -600,6 +604,9 @@ static bool PIOS_MPU6000_HandleData(uint32_t gyro_read_timestamp)
     queue_data->temperature = 3653 + (temp * 100) / 340;
     queue_data->timestamp   = gyro_read_timestamp;
 
+    if (dev->ring) {
+        return PIOS_SENSORS_RingWriteFromISR(dev->ring, queue_data);
+    }
     BaseType_t higherPriorityTaskWoken;
     xQueueSendToBackFromISR(dev->queue, (void *)queue_data, &higherPriorityTaskWoken);
     return higherPriorityTaskWoken == pdTRUE;
@@ -642,6 +649,24 @@ QueueHandle_t PIOS_MPU6000_driver_get_queue(__attribute__((unused)) uintptr_t co
 {
     return dev->queue;
 }
+
+/**
+ * The ring is only created once the Sensors task asks for it, from then on
+ * samples go to the ring instead of the queue. The CC3D Attitude module
+ * keeps reading the queue.
+ */
+struct pios_sensors_ring *PIOS_MPU6000_driver_get_ring(__attribute__((unused)) uintptr_t context)
+{
+    if (!dev->ring) {
+        struct pios_sensors_ring *ring = PIOS_SENSORS_RingCreate(SENSOR_DATA_SIZE, dev->cfg->max_downsample + 1);
+        PIOS_Assert(ring);
+        const bool wakeup = PIOS_SENSORS_RingEnableWakeup(ring);
+        PIOS_Assert(wakeup);
+        // publish the ring to the IRQ handler only once it is complete
+        dev->ring = ring;
+    }
+    return dev->ring;
+}
 #endif /* PIOS_INCLUDE_MPU6000 */
 
 /**
@@ -44,7 +44,7 @@ enum pios_mpu9250_dev_magic {
 struct mpu9250_dev {
     uint32_t spi_id;
     uint32_t slave_num;
-    QueueHandle_t queue;
+    struct pios_sensors_ring *ring;
     const struct pios_mpu9250_cfg *cfg;
     enum pios_mpu9250_range gyro_range;
     enum pios_mpu9250_accel_range accel_range;
@@ -150,14 +150,15 @@ static int32_t PIOS_MPU9250_Mag_Init(void);
 bool PIOS_MPU9250_Main_driver_Test(uintptr_t context);
 void PIOS_MPU9250_Main_driver_Reset(uintptr_t context);
 void PIOS_MPU9250_Main_driver_get_scale(float *scales, uint8_t size, uintptr_t context);
-QueueHandle_t PIOS_MPU9250_Main_driver_get_queue(uintptr_t context);
+struct pios_sensors_ring *PIOS_MPU9250_Main_driver_get_ring(uintptr_t context);
 
 const PIOS_SENSORS_Driver PIOS_MPU9250_Main_Driver = {
     .test      = PIOS_MPU9250_Main_driver_Test,
     .poll      = NULL,
     .fetch     = NULL,
     .reset     = PIOS_MPU9250_Main_driver_Reset,
-    .get_queue = PIOS_MPU9250_Main_driver_get_queue,
+    .get_queue = NULL,
+    .get_ring  = PIOS_MPU9250_Main_driver_get_ring,
     .get_scale = PIOS_MPU9250_Main_driver_get_scale,
     .is_polled = false,
 };
@@ -200,8 +201,10 @@ static struct mpu9250_dev *PIOS_MPU9250_alloc(const struct pios_mpu9250_cfg *cfg
 
     mpu9250_dev->magic = PIOS_MPU9250_DEV_MAGIC;
 
-    mpu9250_dev->queue = xQueueCreate(cfg->max_downsample + 1, SENSOR_DATA_SIZE);
-    PIOS_Assert(mpu9250_dev->queue);
+    mpu9250_dev->ring = PIOS_SENSORS_RingCreate(SENSOR_DATA_SIZE, cfg->max_downsample + 1);
+    PIOS_Assert(mpu9250_dev->ring);
+    const bool wakeup = PIOS_SENSORS_RingEnableWakeup(mpu9250_dev->ring);
+    PIOS_Assert(wakeup);
 
     queue_data = (PIOS_SENSORS_3Axis_SensorsWithTemp *)pios_malloc(SENSOR_DATA_SIZE);
     PIOS_Assert(queue_data);
@@ -921,9 +924,7 @@ static bool PIOS_MPU9250_HandleData(uint32_t gyro_read_timestamp)
     }
 #endif
 
-    BaseType_t higherPriorityTaskWoken;
-    xQueueSendToBackFromISR(dev->queue, queue_data, &higherPriorityTaskWoken);
-    return higherPriorityTaskWoken == pdTRUE;
+    return PIOS_SENSORS_RingWriteFromISR(dev->ring, queue_data);
 }
 
 static bool PIOS_MPU9250_ReadSensor(bool *woken)
@@ -959,9 +960,9 @@ void PIOS_MPU9250_Main_driver_get_scale(float *scales, uint8_t size, __attribute
     scales[1] = PIOS_MPU9250_GetScale();
 }
 
-QueueHandle_t PIOS_MPU9250_Main_driver_get_queue(__attribute__((unused)) uintptr_t context)
+struct pios_sensors_ring *PIOS_MPU9250_Main_driver_get_ring(__attribute__((unused)) uintptr_t context)
 {
-    return dev->queue;
+    return dev->ring;
 }
 
 
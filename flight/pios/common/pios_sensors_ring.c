@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios_sensors_ring.c
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Lock free single producer, single consumer sample ring
+ *             --
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stdlib.h>
+#include <pios_mem.h>
+#include <pios_sensors_ring.h>
+
+struct pios_sensors_ring *PIOS_SENSORS_RingCreate(uint16_t sample_size, uint16_t min_samples)
+{
+    uint32_t capacity = 1;
+
+    while (capacity < min_samples) {
+        capacity <<= 1;
+    }
+    // keep every slot word aligned, samples are cast to structs in place
+    sample_size = (sample_size + 3) & ~3;
+
+    struct pios_sensors_ring *ring = (struct pios_sensors_ring *)pios_malloc(sizeof(struct pios_sensors_ring));
+    if (!ring) {
+        return NULL;
+    }
+    ring->data = (uint8_t *)pios_malloc(capacity * sample_size);
+    if (!ring->data) {
+        pios_free(ring);
+        return NULL;
+    }
+    ring->sample_size = sample_size;
+    ring->mask    = capacity - 1;
+    ring->head    = 0;
+    ring->tail    = 0;
+    ring->dropped = 0;
+    ring->wakeup  = NULL;
+    return ring;
+}
@@ -197,6 +197,10 @@ struct pios_callback_info {
     bool     is_running;
     /** Count of executions of the callback since system start */
     uint32_t running_time_count;
+    /** Longest time from dispatch (or schedule due) to execution in microseconds */
+    uint32_t dispatch_latency_max_us;
+    /** Running average of the time from dispatch to execution in microseconds */
+    uint32_t dispatch_latency_avg_us;
 };
 
 /**
@@ -29,18 +29,41 @@
 #include <pios_debug.h>
 #include <pios_delay.h>
 #include <FreeRTOS.h>
+
+/* log2 buckets: bucket 0 holds values <= 0, bucket n values in [2^(n-1), 2^n) */
+#define PIOS_INSTRUMENTATION_HISTOGRAM_BUCKETS 32
+
+typedef struct {
+    uint32_t buckets[PIOS_INSTRUMENTATION_HISTOGRAM_BUCKETS];
+} pios_perf_histogram_t;
+
 typedef struct {
     uint32_t id;
     int32_t  max;
     int32_t  min;
     int32_t  value;
     uint32_t lastUpdateTS;
+    pios_perf_histogram_t *histogram; /* NULL unless created by PIOS_Instrumentation_CreateHistogramCounter */
 } pios_perf_counter_t;
 
 typedef void *pios_counter_t;
 
 extern pios_perf_counter_t *pios_instrumentation_perf_counters;
 extern int8_t pios_instrumentation_last_used_counter;
+extern uint8_t pios_instrumentation_dropped_counters;
+
+/**
+ * Add a sample to the histogram of a counter, if it has one. Must be called inside a critical section.
+ * @param counter the counter
+ * @param sample the value to add
+ */
+static inline void PIOS_Instrumentation_HistogramInsert(pios_perf_counter_t *counter, int32_t sample)
+{
+    if (counter->histogram) {
+        uint8_t bucket = sample > 0 ? 32 - __builtin_clz((uint32_t)sample) : 0;
+        counter->histogram->buckets[bucket]++;
+    }
+}
 
 /**
  * Update a counter with a new value
@@ -53,6 +76,7 @@ static inline void PIOS_Instrumentation_updateCounter(pios_counter_t counter_han
     vPortEnterCritical();
     pios_perf_counter_t *counter = (pios_perf_counter_t *)counter_handle;
     counter->value = newValue;
+    PIOS_Instrumentation_HistogramInsert(counter, newValue);
     counter->max--;
     if (counter->value > counter->max) {
         counter->max = counter->value;
@@ -90,6 +114,7 @@ static inline void PIOS_Instrumentation_TimeEnd(pios_counter_t counter_handle)
     pios_perf_counter_t *counter = (pios_perf_counter_t *)counter_handle;
 
     counter->value = PIOS_DELAY_DiffuS(counter->lastUpdateTS);
+    PIOS_Instrumentation_HistogramInsert(counter, counter->value);
     counter->max--;
     if (counter->value > counter->max) {
         counter->max = counter->value;
@@ -114,6 +139,7 @@ static inline void PIOS_Instrumentation_TrackPeriod(pios_counter_t counter_handl
         vPortEnterCritical();
         uint32_t period = PIOS_DELAY_DiffuS(counter->lastUpdateTS);
         counter->value = (counter->value * 15 + period) / 16;
+        PIOS_Instrumentation_HistogramInsert(counter, period);
         counter->max--;
         if ((int32_t)period > counter->max) {
             counter->max = period;
@@ -159,10 +185,28 @@ void PIOS_Instrumentation_Init(int8_t maxCounters);
 /**
  * Create a new counter.
  * @param id the unique id to assign to the counter
- * @return the counter handle to be used to manage its content
+ * @return the counter handle to be used to manage its content, NULL if all the
+ * counters are in use (counted in pios_instrumentation_dropped_counters)
  */
 pios_counter_t PIOS_Instrumentation_CreateCounter(uint32_t id);
 
+/**
+ * Create a new counter that also keeps a histogram of its values, to get percentiles
+ * with @see PIOS_Instrumentation_HistogramPercentile.
+ * Values, durations and periods are recorded, increments are not.
+ * @param id the unique id to assign to the counter
+ * @return the counter handle to be used to manage its content, NULL if all the counters are in use
+ */
+pios_counter_t PIOS_Instrumentation_CreateHistogramCounter(uint32_t id);
+
+/**
+ * Estimate a percentile of the values recorded by a histogram counter
+ * @param counter the counter
+ * @param rank the percentile in hundredths of percent, i.e. 9990 for p99.9
+ * @return the estimated value, interpolated inside its log2 bucket, or 0 without histogram or samples
+ */
+int32_t PIOS_Instrumentation_HistogramPercentile(const pios_perf_counter_t *counter, uint16_t rank);
+
 /**
  * search a counter index by its unique Id
  * @param id the unique id to assign to the counter.
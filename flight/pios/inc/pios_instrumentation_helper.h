@@ -75,6 +75,10 @@
  * <pre>PERF_MEASURE_PERIOD(counterPeriod);</pre>
  * Note that the value stored in the counter is a long running mean while max and min are single point values
  *
+ * Use PERF_INIT_HISTOGRAM_COUNTER instead of PERF_INIT_COUNTER to also keep a log2 histogram of the
+ * values, durations or periods. p50, p99 and p99.9 are then published along with value, min and max:
+ * <pre>PERF_INIT_HISTOGRAM_COUNTER(counterPeriod, 0xA7710003, "ATTITUDE", "Sensor update period", "us");</pre>
+ *
  * Track an user defined int32_t value:
  * <pre>PERF_TRACK_VALUE(counterAccelSamples, i);</pre>
  * the counter is then updated with the value of i.
@@ -97,21 +101,24 @@
  * this mast be called at some module init code
  */
 #define PERF_INIT_COUNTER(x, id, ...) x = PIOS_Instrumentation_CreateCounter(id)
+#define PERF_INIT_HISTOGRAM_COUNTER(x, id, ...) x = PIOS_Instrumentation_CreateHistogramCounter(id)
 
 /**
- * those are the monitoring macros
+ * those are the monitoring macros, they do nothing if the counter could not be created
  */
-#define PERF_TIMED_SECTION_START(x)   PIOS_Instrumentation_TimeStart(x)
-#define PERF_TIMED_SECTION_END(x)     PIOS_Instrumentation_TimeEnd(x)
-#define PERF_MEASURE_PERIOD(x)        PIOS_Instrumentation_TrackPeriod(x)
-#define PERF_TRACK_VALUE(x, y)        PIOS_Instrumentation_updateCounter(x, y)
-#define PERF_INCREMENT_VALUE(x)       PIOS_Instrumentation_incrementCounter(x, 1)
-#define PERF_DECREMENT_VALUE(x)       PIOS_Instrumentation_incrementCounter(x, -1)
+#define PERF_IF_COUNTER(x, op)        do { if (x) { op; } } while (0)
+#define PERF_TIMED_SECTION_START(x)   PERF_IF_COUNTER(x, PIOS_Instrumentation_TimeStart(x))
+#define PERF_TIMED_SECTION_END(x)     PERF_IF_COUNTER(x, PIOS_Instrumentation_TimeEnd(x))
+#define PERF_MEASURE_PERIOD(x)        PERF_IF_COUNTER(x, PIOS_Instrumentation_TrackPeriod(x))
+#define PERF_TRACK_VALUE(x, y)        PERF_IF_COUNTER(x, PIOS_Instrumentation_updateCounter(x, y))
+#define PERF_INCREMENT_VALUE(x)       PERF_IF_COUNTER(x, PIOS_Instrumentation_incrementCounter(x, 1))
+#define PERF_DECREMENT_VALUE(x)       PERF_IF_COUNTER(x, PIOS_Instrumentation_incrementCounter(x, -1))
 
 #else
 
 #define PERF_DEFINE_COUNTER(x)
 #define PERF_INIT_COUNTER(x, id, ...)
+#define PERF_INIT_HISTOGRAM_COUNTER(x, id, ...)
 #define PERF_TIMED_SECTION_START(x)
 #define PERF_TIMED_SECTION_END(x)
 #define PERF_MEASURE_PERIOD(x)
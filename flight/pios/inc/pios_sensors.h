@@ -29,6 +29,7 @@
 #include <utlist.h>
 #include <stdint.h>
 #include <vectors.h>
+#include <pios_sensors_ring.h>
 // needed for debug APIs.
 
 typedef bool (*PIOS_SENSORS_test_function)(uintptr_t context);
@@ -42,6 +43,7 @@ typedef void (*PIOS_SENSORS_fetch_function)(void *samples, uint8_t size, uintptr
  */
 typedef void (*PIOS_SENSORS_get_scale_function)(float *, uint8_t size, uintptr_t context);
 typedef QueueHandle_t (*PIOS_SENSORS_get_queue_function)(uintptr_t context);
+typedef struct pios_sensors_ring *(*PIOS_SENSORS_get_ring_function)(uintptr_t context);
 
 typedef struct PIOS_SENSORS_Driver {
     PIOS_SENSORS_test_function      test; // called at startup to test the sensor
@@ -49,6 +51,7 @@ typedef struct PIOS_SENSORS_Driver {
     PIOS_SENSORS_fetch_function     fetch; // called to fetch data for polled sensors
     PIOS_SENSORS_reset_function     reset; // reset sensor. for example if data are not received in the allotted time
     PIOS_SENSORS_get_queue_function get_queue; // get the queue reference
+    PIOS_SENSORS_get_ring_function  get_ring; // get the sample ring, replaces the queue for high rate sensors
     PIOS_SENSORS_get_scale_function get_scale; // return scales for the sensors
     bool is_polled;
 } PIOS_SENSORS_Driver;
@@ -164,6 +167,19 @@ static inline QueueHandle_t PIOS_SENSORS_GetQueue(const PIOS_SENSORS_Instance *s
     }
     return sensor->driver->get_queue(sensor->context);
 }
+/**
+ * retrieve the sensor sample ring
+ * @param sensor
+ * @return sensor ring or null if not supported
+ */
+static inline struct pios_sensors_ring *PIOS_SENSORS_GetRing(const PIOS_SENSORS_Instance *sensor)
+{
+    PIOS_Assert(sensor);
+    if (!sensor->driver->get_ring) {
+        return NULL;
+    }
+    return sensor->driver->get_ring(sensor->context);
+}
 /**
  * Get the sensor scales.
  * @param sensor sensor instance
@@ -0,0 +1,192 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios_sensors_ring.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Lock free single producer, single consumer sample ring
+ *             used to pass raw sensor samples from a driver interrupt
+ *             to the Sensors module.
+ *             --
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef PIOS_SENSORS_RING_H
+#define PIOS_SENSORS_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * The producer (a driver IRQ handler) only ever writes head and dropped,
+ * the consumer (the Sensors task) only ever writes tail. Both are free
+ * running sample counters, the slot is the counter masked by capacity - 1.
+ * The release store of head publishes a sample after its data was written,
+ * the release store of tail hands a slot back after its data was read.
+ */
+struct pios_sensors_ring {
+    uint8_t  *data;
+    uint16_t sample_size; // bytes per slot, multiple of 4
+    uint16_t mask; // capacity - 1, capacity is a power of two
+    uint32_t head; // samples written
+    uint32_t tail; // samples read
+    uint32_t dropped; // samples lost because the ring was full
+    void     *wakeup; // binary semaphore given when the ring turns non empty, NULL if the consumer polls
+};
+
+/**
+ * Allocate a new ring
+ * @param sample_size size of a sample in bytes
+ * @param min_samples minimum number of samples the ring holds, rounded up to a power of two
+ * @return the new ring or NULL if out of memory
+ */
+struct pios_sensors_ring *PIOS_SENSORS_RingCreate(uint16_t sample_size, uint16_t min_samples);
+
+/**
+ * Producer side: copy a sample into the ring, never blocks.
+ * When the ring is full the new sample is dropped and counted.
+ * @param ring ring to write to
+ * @param sample sample_size bytes to copy
+ * @return true if the sample was queued
+ */
+static inline bool PIOS_SENSORS_RingWrite(struct pios_sensors_ring *ring, const void *sample)
+{
+    const uint32_t head = ring->head;
+
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+        ring->dropped++;
+        return false;
+    }
+    memcpy(&ring->data[(head & ring->mask) * ring->sample_size], sample, ring->sample_size);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @param ring ring to check
+ * @return number of samples queued
+ */
+static inline uint32_t PIOS_SENSORS_RingCount(const struct pios_sensors_ring *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Consumer side: get the oldest queued samples without copying them.
+ * Returns the samples that are contiguous in memory, call again after
+ * PIOS_SENSORS_RingRelease() to get the rest of a wrapped batch.
+ * @param ring ring to read from
+ * @param samples set to the first sample, samples are ring->sample_size apart
+ * @return number of samples available at *samples
+ */
+static inline uint16_t PIOS_SENSORS_RingPeek(struct pios_sensors_ring *ring, const void * *samples)
+{
+    const uint32_t tail  = ring->tail;
+    const uint32_t used  = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+    const uint32_t slot  = tail & ring->mask;
+    const uint32_t avail = ring->mask + 1 - slot;
+
+    *samples = &ring->data[slot * ring->sample_size];
+    return (uint16_t)(used < avail ? used : avail);
+}
+
+/**
+ * Consumer side: hand back samples obtained with PIOS_SENSORS_RingPeek()
+ * @param ring ring the samples were read from
+ * @param count number of samples consumed
+ */
+static inline void PIOS_SENSORS_RingRelease(struct pios_sensors_ring *ring, uint16_t count)
+{
+    __atomic_store_n(&ring->tail, ring->tail + count, __ATOMIC_RELEASE);
+}
+
+/**
+ * Consumer side: discard all queued samples
+ * @param ring ring to flush
+ */
+static inline void PIOS_SENSORS_RingFlush(struct pios_sensors_ring *ring)
+{
+    __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+/**
+ * @param ring ring to check
+ * @return number of samples the producer had to drop so far
+ */
+static inline uint32_t PIOS_SENSORS_RingDropped(const struct pios_sensors_ring *ring)
+{
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
+
+#if defined(PIOS_INCLUDE_FREERTOS)
+/**
+ * Let the consumer block in PIOS_SENSORS_RingWait() instead of polling
+ * @param ring ring to enable the wakeup for
+ * @return true on success, false if out of memory
+ */
+static inline bool PIOS_SENSORS_RingEnableWakeup(struct pios_sensors_ring *ring)
+{
+    ring->wakeup = xSemaphoreCreateBinary();
+    return ring->wakeup != NULL;
+}
+
+/**
+ * Producer side: PIOS_SENSORS_RingWrite() from an IRQ handler that also
+ * wakes the consumer, but only when the ring goes from empty to non empty.
+ * The consumer task can not run between the check and the write.
+ * @param ring ring to write to
+ * @param sample sample_size bytes to copy
+ * @return true if a higher priority task was woken
+ */
+static inline bool PIOS_SENSORS_RingWriteFromISR(struct pios_sensors_ring *ring, const void *sample)
+{
+    const bool was_empty = !PIOS_SENSORS_RingCount(ring);
+
+    if (!PIOS_SENSORS_RingWrite(ring, sample) || !was_empty || !ring->wakeup) {
+        return false;
+    }
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR((SemaphoreHandle_t)ring->wakeup, &higherPriorityTaskWoken);
+    return higherPriorityTaskWoken == pdTRUE;
+}
+
+/**
+ * Consumer side: PIOS_SENSORS_RingPeek() that blocks until samples arrive
+ * @param ring ring to read from
+ * @param samples set to the first sample, samples are ring->sample_size apart
+ * @param timeout maximum ticks to wait
+ * @return number of samples available at *samples, 0 on timeout
+ */
+static inline uint16_t PIOS_SENSORS_RingWait(struct pios_sensors_ring *ring, const void * *samples, TickType_t timeout)
+{
+    const TickType_t start = xTaskGetTickCount();
+    uint16_t count;
+
+    // the semaphore may still be given from samples drained in an earlier
+    // call, so check the ring again after every wakeup
+    while (!(count = PIOS_SENSORS_RingPeek(ring, samples)) && ring->wakeup) {
+        const TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= timeout || xSemaphoreTake((SemaphoreHandle_t)ring->wakeup, timeout - waited) != pdTRUE) {
+            break;
+        }
+    }
+    return count;
+}
+#endif /* PIOS_INCLUDE_FREERTOS */
+
+#endif /* PIOS_SENSORS_RING_H */
@@ -57,7 +57,7 @@
 #define PIOS_INCLUDE_SYS
 #define PIOS_INCLUDE_TASK_MONITOR
 
-#define PIOS_INSTRUMENTATION_MAX_COUNTERS 10
+#define PIOS_INSTRUMENTATION_MAX_COUNTERS 16
 #define PIOS_INCLUDE_INSTRUMENTATION
 
 /* PIOS hardware peripherals */
@@ -113,6 +113,7 @@
 #define PIOS_INCLUDE_FLASH
 #define PIOS_INCLUDE_FLASH_INTERNAL
 #define PIOS_INCLUDE_FLASH_LOGFS_SETTINGS
+#define PIOS_FLASHFS_LOGFS_INDEX_SIZE 0 /* no RAM for the slot index, scan the log */
 /* #define FLASH_FREERTOS */
 // #define PIOS_INCLUDE_FLASH_EEPROM
 
@@ -58,7 +58,7 @@
 #define PIOS_INCLUDE_TASK_MONITOR
 
 #define PIOS_INCLUDE_INSTRUMENTATION
-#define PIOS_INSTRUMENTATION_MAX_COUNTERS 10
+#define PIOS_INSTRUMENTATION_MAX_COUNTERS 16
 
 /* PIOS hardware peripherals */
 #define PIOS_INCLUDE_IRQ
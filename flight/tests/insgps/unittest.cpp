@@ -0,0 +1,240 @@
+#include "gtest/gtest.h"
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* abort */
+#include <string.h> /* memset */
+#include <math.h>
+
+extern "C" {
+#include "insgps.h"
+
+uint8_t ut_pidx(uint8_t i, uint8_t j);
+float *ut_ekf_P(void);
+float *ut_ekf_X(void);
+void ut_serial_update(float Z[], float Y[], uint16_t SensorsUsed);
+void ut_covariance_prediction_reference(float dT, float P[][13]);
+void ut_serial_update_reference(float Z[], float Y[], float P[][13], float X[], uint16_t SensorsUsed);
+void ut_measurement_eq(float Y[]);
+void ut_measurement_eq_reference(float X[], float Y[], float H[][13]);
+}
+
+#define NUMX 13
+#define NUMV 10
+
+// Relative to the standard deviations of the two states
+#define tolerance 2e-5f
+
+static float frand(float min, float max)
+{
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+// To use a test fixture, derive a class from testing::Test.
+class INSGPS13State : public testing::Test {
+protected:
+    float Pref[NUMX][NUMX];
+
+    virtual void SetUp()
+    {
+        srand(1234);
+        INSGPSInit();
+    }
+
+    // Random attitude, rates and biases, then let the prediction linearize F and G there
+    void randomizeModel(float dT)
+    {
+        float pos[3] = { frand(-100, 100), frand(-100, 100), frand(-50, 0) };
+        float vel[3] = { frand(-10, 10), frand(-10, 10), frand(-2, 2) };
+        float q[4]   = { frand(-1, 1), frand(-1, 1), frand(-1, 1), frand(-1, 1) };
+        float gyro_bias[3] = { frand(-0.01f, 0.01f), frand(-0.01f, 0.01f), frand(-0.01f, 0.01f) };
+        float accel_bias[3] = { 0, 0, 0 };
+        float gyro[3]  = { frand(-3, 3), frand(-3, 3), frand(-3, 3) };
+        float accel[3] = { frand(-5, 5), frand(-5, 5), frand(-15, -5) };
+        float qmag     = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+        for (int i = 0; i < 4; i++) {
+            q[i] /= qmag;
+        }
+        INSSetState(pos, vel, q, gyro_bias, accel_bias);
+        INSStatePrediction(gyro, accel, dT);
+    }
+
+    // Random symmetric positive definite covariance, in both representations
+    void randomizeP()
+    {
+        float A[NUMX][NUMX];
+
+        for (int i = 0; i < NUMX; i++) {
+            for (int j = 0; j < NUMX; j++) {
+                A[i][j] = frand(-1, 1);
+            }
+        }
+        for (int i = 0; i < NUMX; i++) {
+            for (int j = i; j < NUMX; j++) {
+                float sum = (i == j) ? 0.1f : 0.0f;
+                for (int k = 0; k < NUMX; k++) {
+                    sum += A[i][k] * A[j][k];
+                }
+                Pref[i][j] = Pref[j][i] = sum;
+                ut_ekf_P()[ut_pidx(i, j)] = sum;
+            }
+        }
+    }
+
+    void expectPMatchesReference(float relative = tolerance)
+    {
+        for (int i = 0; i < NUMX; i++) {
+            for (int j = i; j < NUMX; j++) {
+                float scale = sqrtf(fabsf(Pref[i][i] * Pref[j][j]));
+                EXPECT_NEAR(Pref[i][j], ut_ekf_P()[ut_pidx(i, j)], relative * scale) << "P[" << i << "][" << j << "]";
+            }
+        }
+    }
+};
+
+TEST_F(INSGPS13State, PackedIndex) {
+    uint8_t expected = 0;
+
+    for (int i = 0; i < NUMX; i++) {
+        for (int j = i; j < NUMX; j++) {
+            EXPECT_EQ(expected, ut_pidx(i, j));
+            EXPECT_EQ(expected, ut_pidx(j, i));
+            expected++;
+        }
+    }
+    EXPECT_EQ(NUMX * (NUMX + 1) / 2, expected);
+}
+
+TEST_F(INSGPS13State, ResetAndGetP) {
+    float PDiag[NUMX];
+    float PGet[NUMX];
+
+    randomizeP();
+    for (int i = 0; i < NUMX; i++) {
+        PDiag[i] = (float)(i + 1);
+    }
+    INSResetP(PDiag);
+    INSGetP(PGet);
+    for (int i = 0; i < NUMX; i++) {
+        EXPECT_EQ(PDiag[i], PGet[i]);
+        for (int j = i + 1; j < NUMX; j++) {
+            EXPECT_EQ(0.0f, ut_ekf_P()[ut_pidx(i, j)]);
+        }
+    }
+}
+
+TEST_F(INSGPS13State, CovariancePredictionMatchesReference) {
+    for (int trial = 0; trial < 50; trial++) {
+        float dT = frand(0.001f, 0.01f);
+
+        randomizeModel(dT);
+        randomizeP();
+        ut_covariance_prediction_reference(dT, Pref);
+        INSCovariancePrediction(dT);
+        expectPMatchesReference();
+    }
+}
+
+TEST_F(INSGPS13State, CovariancePredictionRepeated) {
+    float PDiag[NUMX];
+
+    // start from the initial covariance and predict for one second at 500Hz
+    INSGetP(PDiag);
+    for (int i = 0; i < NUMX; i++) {
+        for (int j = 0; j < NUMX; j++) {
+            Pref[i][j] = (i == j) ? PDiag[i] : 0.0f;
+        }
+    }
+    for (int step = 0; step < 500; step++) {
+        randomizeModel(0.002f);
+        ut_covariance_prediction_reference(0.002f, Pref);
+        INSCovariancePrediction(0.002f);
+    }
+    // rounding of the tiny bias noise increments accumulates differently in both
+    expectPMatchesReference(10 * tolerance);
+}
+
+TEST_F(INSGPS13State, SerialUpdateMatchesReference) {
+    for (int trial = 0; trial < 50; trial++) {
+        float Z[NUMV], Y[NUMV], Xref[NUMX];
+        uint16_t sensors = (uint16_t)(rand() & FULL_SENSORS);
+
+        randomizeModel(0.002f);
+        randomizeP();
+        for (int i = 0; i < NUMV; i++) {
+            Z[i] = frand(-1, 1);
+            Y[i] = frand(-1, 1);
+        }
+        memcpy(Xref, ut_ekf_X(), sizeof(Xref));
+
+        ut_serial_update_reference(Z, Y, Pref, Xref, sensors);
+        ut_serial_update(Z, Y, sensors);
+
+        expectPMatchesReference();
+        for (int i = 0; i < NUMX; i++) {
+            EXPECT_NEAR(Xref[i], ut_ekf_X()[i], tolerance * (1.0f + fabsf(Xref[i])));
+        }
+    }
+}
+
+TEST_F(INSGPS13State, MeasurementEqMatchesReference) {
+    for (int trial = 0; trial < 50; trial++) {
+        float Be[3] = { frand(-1, 1), frand(-1, 1), frand(-1, 1) };
+        float Y[NUMV], Yref[NUMV], Href[NUMV][NUMX];
+
+        INSSetMagNorth(Be);
+        randomizeModel(0.002f);
+        ut_measurement_eq(Y);
+        ut_measurement_eq_reference(ut_ekf_X(), Yref, Href);
+        for (int i = 0; i < NUMV; i++) {
+            EXPECT_NEAR(Yref[i], Y[i], 1e-5f * (1.0f + fabsf(Yref[i])));
+        }
+    }
+}
+
+TEST_F(INSGPS13State, CorrectionMatchesReference) {
+    const uint16_t masks[] = {
+        MAG_SENSORS,
+        HORIZ_SENSORS | VERT_SENSORS | BARO_SENSOR,
+        POS_SENSORS | HORIZ_SENSORS | MAG_SENSORS,
+        MAG_SENSORS | HORIZ_SENSORS | VERT_SENSORS | BARO_SENSOR,
+        FULL_SENSORS,
+    };
+
+    for (int trial = 0; trial < 50; trial++) {
+        uint16_t sensors = masks[trial % (sizeof(masks) / sizeof(masks[0]))];
+        float mag[3]     = { frand(-1, 1), frand(-1, 1), frand(-1, 1) };
+        float pos[3]     = { frand(-100, 100), frand(-100, 100), frand(-50, 0) };
+        float vel[3]     = { frand(-10, 10), frand(-10, 10), frand(-2, 2) };
+        float baro = frand(0, 50);
+        float Be[3]      = { frand(-1, 1), frand(-1, 1), frand(-1, 1) };
+        float Z[NUMV], Yref[NUMV], Href[NUMV][NUMX], Xref[NUMX];
+
+        INSSetMagNorth(Be);
+        randomizeModel(0.002f);
+        randomizeP();
+        memcpy(Xref, ut_ekf_X(), sizeof(Xref));
+
+        // the correction step as INSCorrection() did it on the dense P
+        float magnorm = sqrtf(mag[0] * mag[0] + mag[1] * mag[1] + mag[2] * mag[2]);
+        for (int i = 0; i < 3; i++) {
+            Z[i]     = pos[i];
+            Z[3 + i] = vel[i];
+            Z[6 + i] = mag[i] / magnorm;
+        }
+        Z[9] = baro;
+        ut_measurement_eq_reference(Xref, Yref, Href);
+        ut_serial_update_reference(Z, Yref, Pref, Xref, sensors);
+        float qnorm = sqrtf(Xref[6] * Xref[6] + Xref[7] * Xref[7] + Xref[8] * Xref[8] + Xref[9] * Xref[9]);
+        for (int i = 6; i < 10; i++) {
+            Xref[i] /= qnorm;
+        }
+
+        INSCorrection(mag, pos, vel, baro, sensors);
+
+        expectPMatchesReference(10 * tolerance);
+        for (int i = 0; i < NUMX; i++) {
+            EXPECT_NEAR(Xref[i], ut_ekf_X()[i], 10 * tolerance * (1.0f + fabsf(Xref[i]))) << "X[" << i << "] sensors " << sensors;
+        }
+    }
+}
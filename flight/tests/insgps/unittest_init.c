@@ -0,0 +1,151 @@
+/*
+ * Test fixture support that needs to be written in C: access to the private
+ * EKF state of the 13 state INS/GPS and the dense reference implementations
+ * its kernels are checked against.
+ */
+
+#include "insgps13state.c"
+
+#define REF_FrowMin { 3, 4, 5, 6, 6, 6, 5, 5, 5, 5, 13, 13, 13 }
+#define REF_FrowMax { 3, 4, 5, 9, 9, 9, 12, 12, 12, 12, -1, -1, -1 }
+#define REF_GrowMin { 9, 9, 9, 3, 3, 3, 0, 0, 0, 0, 6, 7, 8 }
+#define REF_GrowMax { -1, -1, -1, 5, 5, 5, 2, 2, 2, 2, 6, 7, 8 }
+#define REF_HrowMin { 0, 1, 2, 3, 4, 5, 6, 6, 6, 2 }
+#define REF_HrowMax { 0, 1, 2, 3, 4, 5, 9, 9, 9, 2 }
+
+uint8_t ut_pidx(uint8_t i, uint8_t j)
+{
+    return (i <= j) ? PIDX(i, j) : PIDX(j, i);
+}
+
+float *ut_ekf_P(void)
+{
+    return ekf.P;
+}
+
+float *ut_ekf_X(void)
+{
+    return ekf.X;
+}
+
+void ut_serial_update(float Z[NUMV], float Y[NUMV], uint16_t SensorsUsed)
+{
+    LinearizeH(ekf.X, ekf.Be, ekf.H);
+    SerialUpdate(ekf.H, ekf.R, Z, Y, ekf.P, ekf.X, SensorsUsed);
+}
+
+void ut_measurement_eq(float Y[NUMV])
+{
+    LinearizeH(ekf.X, ekf.Be, ekf.H);
+    MeasurementEq(ekf.X, ekf.H, Y, FULL_SENSORS);
+}
+
+/* Measurement equation and its full Jacobian, as they were before LinearizeH() shared its products */
+void ut_measurement_eq_reference(float X[NUMX], float Y[NUMV], float H[NUMV][NUMX])
+{
+    const float q0 = X[6], q1 = X[7], q2 = X[8], q3 = X[9];
+    const float *Be = ekf.Be;
+
+    for (uint8_t m = 0; m < NUMV; m++) {
+        for (uint8_t k = 0; k < NUMX; k++) {
+            H[m][k] = 0.0f;
+        }
+    }
+    for (uint8_t m = 0; m < 6; m++) {
+        Y[m]    = X[m];
+        H[m][m] = 1.0f;
+    }
+    Y[6]    = (q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * Be[0] + 2.0f * (q1 * q2 + q0 * q3) * Be[1] + 2.0f * (q1 * q3 - q0 * q2) * Be[2];
+    Y[7]    = 2.0f * (q1 * q2 - q0 * q3) * Be[0] + (q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3) * Be[1] + 2.0f * (q2 * q3 + q0 * q1) * Be[2];
+    Y[8]    = 2.0f * (q1 * q3 + q0 * q2) * Be[0] + 2.0f * (q2 * q3 - q0 * q1) * Be[1] + (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3) * Be[2];
+    Y[9]    = -1.0f * X[2];
+
+    H[6][6] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
+    H[6][7] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+    H[6][8] = 2.0f * (-q2 * Be[0] + q1 * Be[1] - q0 * Be[2]);
+    H[6][9] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
+    H[7][6] = 2.0f * (-q3 * Be[0] + q0 * Be[1] + q1 * Be[2]);
+    H[7][7] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
+    H[7][8] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+    H[7][9] = 2.0f * (-q0 * Be[0] - q3 * Be[1] + q2 * Be[2]);
+    H[8][6] = 2.0f * (q2 * Be[0] - q1 * Be[1] + q0 * Be[2]);
+    H[8][7] = 2.0f * (q3 * Be[0] - q0 * Be[1] - q1 * Be[2]);
+    H[8][8] = 2.0f * (q0 * Be[0] + q3 * Be[1] - q2 * Be[2]);
+    H[8][9] = 2.0f * (q1 * Be[0] + q2 * Be[1] + q3 * Be[2]);
+    H[9][2] = -1.0f;
+}
+
+/* Covariance prediction on a dense P, as it was before the generated kernel */
+void ut_covariance_prediction_reference(float dT, float P[NUMX][NUMX])
+{
+    const int8_t FrowMin[NUMX] = REF_FrowMin;
+    const int8_t FrowMax[NUMX] = REF_FrowMax;
+    const int8_t GrowMin[NUMX] = REF_GrowMin;
+    const int8_t GrowMax[NUMX] = REF_GrowMax;
+    float (*F)[NUMX] = ekf.F;
+    float (*G)[NUMW] = ekf.G;
+    float *Q = ekf.Q;
+    const float dT1  = 1.0f / dT;
+    const float dTsq = dT * dT;
+    float Dummy[NUMX][NUMX];
+
+    for (int8_t i = 0; i < NUMX; i++) { // Calculate Dummy = (P/T +F*P)
+        for (int8_t j = 0; j < NUMX; j++) {
+            Dummy[i][j] = P[i][j] * dT1;
+        }
+        for (int8_t k = FrowMin[i]; k <= FrowMax[i]; k++) {
+            for (int8_t j = 0; j < NUMX; j++) {
+                Dummy[i][j] += F[i][k] * P[k][j];
+            }
+        }
+    }
+    for (int8_t i = 0; i < NUMX; i++) { // Calculate Pnew = (T^2) [Dummy/T + Dummy*F' + G*Qw*G']
+        for (int8_t j = i; j < NUMX; j++) {
+            float Ptmp = Dummy[i][j] * dT1;
+            for (int8_t k = FrowMin[j]; k <= FrowMax[j]; k++) {
+                Ptmp += Dummy[i][k] * F[j][k];
+            }
+            for (int8_t k = MAX(GrowMin[i], GrowMin[j]); k <= MIN(GrowMax[i], GrowMax[j]); k++) {
+                Ptmp += Q[k] * G[i][k] * G[j][k];
+            }
+            P[j][i] = P[i][j] = Ptmp * dTsq;
+        }
+    }
+}
+
+/* Serial measurement update on a dense P and the full H, as it was before the sensor specific kernels */
+void ut_serial_update_reference(float Z[NUMV], float Y[NUMV], float P[NUMX][NUMX], float X[NUMX], uint16_t SensorsUsed)
+{
+    const int8_t HrowMin[NUMV] = REF_HrowMin;
+    const int8_t HrowMax[NUMV] = REF_HrowMax;
+    float H[NUMV][NUMX], Yref[NUMV];
+    float HP[NUMX], Km[NUMX];
+
+    ut_measurement_eq_reference(X, Yref, H);
+    for (uint8_t m = 0; m < NUMV; m++) {
+        if (SensorsUsed & (0x01 << m)) {
+            for (uint8_t j = 0; j < NUMX; j++) {
+                HP[j] = 0;
+                for (uint8_t k = HrowMin[m]; k <= HrowMax[m]; k++) {
+                    HP[j] += H[m][k] * P[k][j];
+                }
+            }
+            float HPHR = ekf.R[m];
+            for (uint8_t k = HrowMin[m]; k <= HrowMax[m]; k++) {
+                HPHR += HP[k] * H[m][k];
+            }
+            float invHPHR = 1.0f / HPHR;
+            for (uint8_t k = 0; k < NUMX; k++) {
+                Km[k] = HP[k] * invHPHR;
+            }
+            for (uint8_t i = 0; i < NUMX; i++) {
+                for (uint8_t j = i; j < NUMX; j++) {
+                    P[i][j] = P[j][i] = P[i][j] - Km[i] * HP[j];
+                }
+            }
+            for (uint8_t i = 0; i < NUMX; i++) {
+                X[i] += Km[i] * (Z[m] - Y[m]);
+            }
+        }
+    }
+}
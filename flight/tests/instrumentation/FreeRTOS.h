@@ -0,0 +1,7 @@
+#include <stdlib.h>
+#define pvPortMalloc(xSize) (malloc(xSize))
+#define vPortFree(pv)       (free(pv))
+
+/* the unit tests are single threaded */
+#define vPortEnterCritical()
+#define vPortExitCritical()
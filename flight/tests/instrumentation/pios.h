@@ -0,0 +1,11 @@
+#ifndef PIOS_H
+#define PIOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pios_helpers.h>
+
+#endif /* PIOS_H */
@@ -0,0 +1,9 @@
+#ifndef PIOS_DEBUG_H
+#define PIOS_DEBUG_H
+
+#define PIOS_Assert(x) \
+    if (!(x)) { while (1) {; } \
+    }
+#define PIOS_DEBUG_Assert(x) PIOS_Assert(x)
+
+#endif /* PIOS_DEBUG_H */
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* abort */
+#include <string.h> /* memset */
+
+extern "C" {
+#include "pios_instrumentation.h"
+
+uint32_t PIOS_DELAY_GetRaw()
+{
+    return 0;
+}
+}
+
+// To use a test fixture, derive a class from testing::Test.
+class InstrumentationHistogram : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        PIOS_Instrumentation_Init(2);
+        pios_instrumentation_last_used_counter = -1;
+        counter = (pios_perf_counter_t *)PIOS_Instrumentation_CreateHistogramCounter(0x1234);
+        ASSERT_TRUE(counter != NULL);
+        ASSERT_TRUE(counter->histogram != NULL);
+    }
+
+    void record(int32_t value, uint32_t times)
+    {
+        for (uint32_t i = 0; i < times; i++) {
+            PIOS_Instrumentation_updateCounter(counter, value);
+        }
+    }
+
+    pios_perf_counter_t *counter;
+};
+
+TEST_F(InstrumentationHistogram, BucketBoundaries) {
+    const struct {
+        int32_t value;
+        uint8_t bucket;
+    } samples[] = {
+        { -5, 0 }, { 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 2 }, { 4, 3 }, { 7, 3 }, { 8, 4 }, { 1023, 10 },
+        { 1024, 11 }, { 1 << 30, 31 }, { INT32_MAX, 31 }, { INT32_MIN, 0 },
+    };
+
+    for (uint32_t i = 0; i < NELEMENTS(samples); i++) {
+        uint32_t before = counter->histogram->buckets[samples[i].bucket];
+        record(samples[i].value, 1);
+        EXPECT_EQ(before + 1, counter->histogram->buckets[samples[i].bucket]) << samples[i].value;
+    }
+}
+
+TEST_F(InstrumentationHistogram, NoSamples) {
+    pios_perf_counter_t *plain = (pios_perf_counter_t *)PIOS_Instrumentation_CreateCounter(0x5678);
+
+    ASSERT_TRUE(plain != NULL);
+    PIOS_Instrumentation_updateCounter(plain, 100);
+    EXPECT_EQ(0, PIOS_Instrumentation_HistogramPercentile(plain, 5000));
+
+    EXPECT_EQ(0, PIOS_Instrumentation_HistogramPercentile(counter, 5000));
+
+    /* values <= 0 all estimate as 0 */
+    record(-3, 10);
+    EXPECT_EQ(0, PIOS_Instrumentation_HistogramPercentile(counter, 9990));
+}
+
+TEST_F(InstrumentationHistogram, Percentiles) {
+    /* 950 samples in [64, 128), 45 in [1024, 2048) and 5 in [16384, 32768) */
+    record(100, 950);
+    record(1500, 45);
+    record(20000, 5);
+
+    /* 500th sample of 950 in the first bucket: 64 + 63 * 500 / 950 */
+    EXPECT_EQ(97, PIOS_Instrumentation_HistogramPercentile(counter, 5000));
+    /* 40th sample of 45 in the second one: 1024 + 1023 * 40 / 45 */
+    EXPECT_EQ(1933, PIOS_Instrumentation_HistogramPercentile(counter, 9900));
+    /* 4th sample of 5 in the last one, spread up to the max: 16384 + (20000 - 16384) * 4 / 5 */
+    EXPECT_EQ(19276, PIOS_Instrumentation_HistogramPercentile(counter, 9990));
+    /* rank 0 is the low end of the first bucket in use */
+    EXPECT_EQ(64, PIOS_Instrumentation_HistogramPercentile(counter, 0));
+}
+
+TEST_F(InstrumentationHistogram, ClippedToMax) {
+    record(100, 99);
+    record(5000, 1);
+    EXPECT_EQ(5000, counter->max);
+
+    /* never above the recorded max, the bucket would go up to 8191 */
+    EXPECT_EQ(5000, PIOS_Instrumentation_HistogramPercentile(counter, 10000));
+    EXPECT_EQ(5000, PIOS_Instrumentation_HistogramPercentile(counter, 9999));
+
+    /* the bucket of the max is only clipped at the max */
+    EXPECT_EQ(127, PIOS_Instrumentation_HistogramPercentile(counter, 9900));
+
+    /* once the max decays below the bucket, the whole bucket is used again */
+    counter->max = 4000;
+    EXPECT_EQ(8191, PIOS_Instrumentation_HistogramPercentile(counter, 10000));
+}
@@ -4,6 +4,8 @@
 /* Enable/Disable PiOS modules */
 #define PIOS_INCLUDE_FLASH
 // #define PIOS_FLASHFS_LOGFS_MAX_DEVS 5
+/* Smaller than partition a, so filling it exercises the lookups without index */
+#define PIOS_FLASHFS_LOGFS_INDEX_SIZE 128
 #define PIOS_INCLUDE_FREERTOS
 
 #endif /* PIOS_CONFIG_H */
@@ -297,6 +297,88 @@ TEST_F(LogfsTestCooked, WriteManyVerify) {
     EXPECT_EQ(0, memcmp(obj3, obj3_check, sizeof(obj3)));
 }
 
+TEST_F(LogfsTestCooked, BootLoadReadCount) {
+    const uint16_t num_objs   = 100;
+    const uint32_t num_arenas = flashfs_config_partition_a.total_fs_size / flashfs_config_partition_a.arena_size;
+    const uint32_t num_slots  = flashfs_config_partition_a.arena_size / flashfs_config_partition_a.slot_size;
+
+    for (uint16_t i = 0; i < num_objs; i++) {
+        EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i, obj1, sizeof(obj1)));
+    }
+
+    /* Remount like a reboot does, this reads every arena and slot header at most once */
+    PIOS_FLASHFS_Logfs_Destroy(fs_id);
+    uint32_t reads = PIOS_Flash_UT_GetReadCount(flash_id);
+    EXPECT_EQ(0, PIOS_FLASHFS_Logfs_Init(&fs_id, &flashfs_config_partition_a, &pios_ut_flash_driver, flash_id));
+    EXPECT_GE(num_arenas + num_slots, PIOS_Flash_UT_GetReadCount(flash_id) - reads);
+
+    /* Loading every object then costs a slot header and a data read each */
+    unsigned char obj1_check[OBJ1_SIZE];
+    reads = PIOS_Flash_UT_GetReadCount(flash_id);
+    for (uint16_t i = 0; i < num_objs; i++) {
+        memset(obj1_check, 0, sizeof(obj1_check));
+        EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+        EXPECT_EQ(0, memcmp(obj1, obj1_check, sizeof(obj1)));
+    }
+    EXPECT_EQ(2u * num_objs, PIOS_Flash_UT_GetReadCount(flash_id) - reads);
+
+    /* Saving a new version reads the old and the reserved slot header */
+    reads = PIOS_Flash_UT_GetReadCount(flash_id);
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, num_objs / 2, obj1_alt, sizeof(obj1_alt)));
+    EXPECT_EQ(2u, PIOS_Flash_UT_GetReadCount(flash_id) - reads);
+
+    /* Missing objects are not looked for in flash */
+    reads = PIOS_Flash_UT_GetReadCount(flash_id);
+    EXPECT_EQ(-3, PIOS_FLASHFS_ObjLoad(fs_id, OBJ2_ID, 0, obj1_check, sizeof(obj1_check)));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjDelete(fs_id, OBJ2_ID, 0));
+    EXPECT_EQ(0u, PIOS_Flash_UT_GetReadCount(flash_id) - reads);
+}
+
+TEST_F(LogfsTestCooked, GarbageCollectKeepsIndex) {
+    const uint16_t num_objs = 10;
+    const uint32_t num_slots = flashfs_config_partition_a.arena_size / flashfs_config_partition_a.slot_size;
+
+    /* Enough saves to go through several garbage collections, the last round writes 0 .. num_objs - 1 */
+    for (uint32_t i = 0; i < 3 * num_slots + num_objs; i++) {
+        obj1[0] = i < 3 * num_slots ? 0xFF : i - 3 * num_slots;
+        EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i % num_objs, obj1, sizeof(obj1)));
+    }
+
+    unsigned char obj1_check[OBJ1_SIZE];
+    uint32_t reads = PIOS_Flash_UT_GetReadCount(flash_id);
+    for (uint16_t i = 0; i < num_objs; i++) {
+        EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, (i + 3 * num_slots) % num_objs, obj1_check, sizeof(obj1_check)));
+        EXPECT_EQ(i, obj1_check[0]);
+    }
+    EXPECT_EQ(2u * num_objs, PIOS_Flash_UT_GetReadCount(flash_id) - reads);
+}
+
+TEST_F(LogfsTestCooked, MoreObjectsThanIndexEntries) {
+    /* The test configuration indexes 128 objects, the rest is found by scanning */
+    const uint16_t num_objs = 200;
+
+    for (uint16_t i = 0; i < num_objs; i++) {
+        obj1[0] = i;
+        EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(fs_id, OBJ1_ID, i, obj1, sizeof(obj1)));
+    }
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjDelete(fs_id, OBJ1_ID, 7));
+
+    /* Same results before and after a remount */
+    for (uint8_t mount = 0; mount < 2; mount++) {
+        unsigned char obj1_check[OBJ1_SIZE];
+        for (uint16_t i = 0; i < num_objs; i++) {
+            if (i == 7) {
+                EXPECT_EQ(-3, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+            } else {
+                EXPECT_EQ(0, PIOS_FLASHFS_ObjLoad(fs_id, OBJ1_ID, i, obj1_check, sizeof(obj1_check)));
+                EXPECT_EQ((unsigned char)i, obj1_check[0]);
+            }
+        }
+        PIOS_FLASHFS_Logfs_Destroy(fs_id);
+        EXPECT_EQ(0, PIOS_FLASHFS_Logfs_Init(&fs_id, &flashfs_config_partition_a, &pios_ut_flash_driver, flash_id));
+    }
+}
+
 class LogfsTestCookedMultiPart : public LogfsTestRaw {
 protected:
     virtual void SetUp()
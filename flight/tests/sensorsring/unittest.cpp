@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* abort */
+#include <string.h> /* memset */
+#include <pthread.h>
+
+extern "C" {
+#include "pios_sensors_ring.h"
+}
+
+// Same layout as a PIOS_SENSORS_3Axis_SensorsWithTemp with two sensors
+struct test_sample {
+    uint32_t timestamp;
+    uint16_t count;
+    int16_t  temperature;
+    int16_t  sample[6];
+};
+
+static void write_samples(struct pios_sensors_ring *ring, uint32_t first, uint32_t n)
+{
+    for (uint32_t i = first; i < first + n; i++) {
+        struct test_sample s;
+        memset(&s, 0, sizeof(s));
+        s.timestamp = i;
+        PIOS_SENSORS_RingWrite(ring, &s);
+    }
+}
+
+static uint32_t timestamp_at(struct pios_sensors_ring *ring, const void *samples, uint16_t i)
+{
+    return ((const struct test_sample *)((const uint8_t *)samples + i * ring->sample_size))->timestamp;
+}
+
+// To use a test fixture, derive a class from testing::Test.
+class SensorsRing : public testing::Test {
+protected:
+    struct pios_sensors_ring *ring;
+
+    virtual void SetUp()
+    {
+        ring = NULL;
+    }
+
+    virtual void TearDown()
+    {
+        if (ring) {
+            free(ring->data);
+            free(ring);
+        }
+    }
+};
+
+TEST_F(SensorsRing, CapacityRoundedUp) {
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 27);
+    ASSERT_TRUE(ring != NULL);
+    EXPECT_EQ(31, ring->mask);
+    EXPECT_EQ(sizeof(struct test_sample), ring->sample_size);
+    free(ring->data);
+    free(ring);
+
+    // slots stay word aligned
+    ring = PIOS_SENSORS_RingCreate(6, 4);
+    ASSERT_TRUE(ring != NULL);
+    EXPECT_EQ(3, ring->mask);
+    EXPECT_EQ(8, ring->sample_size);
+}
+
+TEST_F(SensorsRing, EmptyRing) {
+    const void *samples;
+
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 8);
+    EXPECT_EQ(0, PIOS_SENSORS_RingPeek(ring, &samples));
+    EXPECT_EQ(0u, PIOS_SENSORS_RingDropped(ring));
+    EXPECT_EQ(0u, PIOS_SENSORS_RingCount(ring));
+    EXPECT_TRUE(ring->wakeup == NULL);
+}
+
+TEST_F(SensorsRing, BatchInOrder) {
+    const void *samples;
+
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 8);
+    write_samples(ring, 100, 5);
+
+    ASSERT_EQ(5, PIOS_SENSORS_RingPeek(ring, &samples));
+    for (uint16_t i = 0; i < 5; i++) {
+        EXPECT_EQ(100u + i, timestamp_at(ring, samples, i));
+    }
+    // peek does not consume
+    EXPECT_EQ(5, PIOS_SENSORS_RingPeek(ring, &samples));
+    EXPECT_EQ(5u, PIOS_SENSORS_RingCount(ring));
+    PIOS_SENSORS_RingRelease(ring, 3);
+    EXPECT_EQ(2u, PIOS_SENSORS_RingCount(ring));
+    ASSERT_EQ(2, PIOS_SENSORS_RingPeek(ring, &samples));
+    EXPECT_EQ(103u, timestamp_at(ring, samples, 0));
+}
+
+TEST_F(SensorsRing, FullRingDropsNewest) {
+    const void *samples;
+
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 4);
+    write_samples(ring, 0, 6);
+
+    EXPECT_EQ(2u, PIOS_SENSORS_RingDropped(ring));
+    EXPECT_EQ(4u, PIOS_SENSORS_RingCount(ring));
+    ASSERT_EQ(4, PIOS_SENSORS_RingPeek(ring, &samples));
+    for (uint16_t i = 0; i < 4; i++) {
+        EXPECT_EQ(i, timestamp_at(ring, samples, i));
+    }
+}
+
+TEST_F(SensorsRing, WrappedBatchInTwoParts) {
+    const void *samples;
+
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 8);
+    write_samples(ring, 0, 6);
+    PIOS_SENSORS_RingRelease(ring, PIOS_SENSORS_RingPeek(ring, &samples));
+    write_samples(ring, 6, 5);
+
+    // slots 6 and 7 first, then 0 to 2
+    ASSERT_EQ(2, PIOS_SENSORS_RingPeek(ring, &samples));
+    EXPECT_EQ(6u, timestamp_at(ring, samples, 0));
+    EXPECT_EQ(7u, timestamp_at(ring, samples, 1));
+    PIOS_SENSORS_RingRelease(ring, 2);
+    ASSERT_EQ(3, PIOS_SENSORS_RingPeek(ring, &samples));
+    EXPECT_EQ(8u, timestamp_at(ring, samples, 0));
+    EXPECT_EQ(10u, timestamp_at(ring, samples, 2));
+    EXPECT_EQ(0u, PIOS_SENSORS_RingDropped(ring));
+}
+
+TEST_F(SensorsRing, Flush) {
+    const void *samples;
+
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 8);
+    write_samples(ring, 0, 5);
+    PIOS_SENSORS_RingFlush(ring);
+    EXPECT_EQ(0, PIOS_SENSORS_RingPeek(ring, &samples));
+    write_samples(ring, 5, 1);
+    ASSERT_EQ(1, PIOS_SENSORS_RingPeek(ring, &samples));
+    EXPECT_EQ(5u, timestamp_at(ring, samples, 0));
+}
+
+// Stub driver: a thread that writes samples as fast as it can, like an IRQ
+// handler it never waits for the consumer
+#define PRODUCER_SAMPLES 1000000
+
+static bool producer_done;
+
+static void *producer_thread(void *arg)
+{
+    write_samples((struct pios_sensors_ring *)arg, 0, PRODUCER_SAMPLES);
+    __atomic_store_n(&producer_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+TEST_F(SensorsRing, ConcurrentProducer) {
+    pthread_t producer;
+    const void *samples;
+    uint32_t next     = 0;
+    uint32_t received = 0;
+    uint32_t skipped  = 0;
+    bool done;
+
+    producer_done = false;
+    ring = PIOS_SENSORS_RingCreate(sizeof(struct test_sample), 32);
+    ASSERT_EQ(0, pthread_create(&producer, NULL, producer_thread, ring));
+
+    // every sample arrives once and in order, samples only go missing
+    // when the producer counted them as dropped
+    do {
+        done = __atomic_load_n(&producer_done, __ATOMIC_ACQUIRE);
+        uint16_t count;
+        while ((count = PIOS_SENSORS_RingPeek(ring, &samples))) {
+            for (uint16_t i = 0; i < count; i++) {
+                uint32_t timestamp = timestamp_at(ring, samples, i);
+                ASSERT_GE(timestamp, next);
+                skipped += timestamp - next;
+                next     = timestamp + 1;
+                received++;
+            }
+            PIOS_SENSORS_RingRelease(ring, count);
+        }
+    } while (!done);
+    pthread_join(producer, NULL);
+
+    skipped += PRODUCER_SAMPLES - next;
+    EXPECT_EQ((uint32_t)PRODUCER_SAMPLES, received + PIOS_SENSORS_RingDropped(ring));
+    EXPECT_EQ(skipped, PIOS_SENSORS_RingDropped(ring));
+}
@@ -0,0 +1,28 @@
+#include <stdlib.h>
+#define pvPortMalloc(xSize) (malloc(xSize))
+#define vPortFree(pv)       (free(pv))
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define portMAX_DELAY       0xffffffff
+
+typedef void *xQueueHandle;
+typedef void *xSemaphoreHandle;
+
+/* the unit tests are single threaded, locking always succeeds */
+static inline xSemaphoreHandle xSemaphoreCreateRecursiveMutex(void)
+{
+    return (xSemaphoreHandle)1;
+}
+static inline int xSemaphoreTakeRecursive(__attribute__((unused)) xSemaphoreHandle xMutex, __attribute__((unused)) unsigned int xBlockTime)
+{
+    return pdTRUE;
+}
+static inline int xSemaphoreGiveRecursive(__attribute__((unused)) xSemaphoreHandle xMutex)
+{
+    return pdTRUE;
+}
+static inline int xQueueSend(__attribute__((unused)) xQueueHandle xQueue, __attribute__((unused)) const void *pvItemToQueue, __attribute__((unused)) unsigned int xTicksToWait)
+{
+    return pdTRUE;
+}
@@ -0,0 +1,8 @@
+#ifndef UAVOBJECTSINIT_H
+#define UAVOBJECTSINIT_H
+
+void UAVObjectsInitializeAll();
+
+#define UAVOBJECTS_LARGEST 64
+
+#endif // UAVOBJECTSINIT_H
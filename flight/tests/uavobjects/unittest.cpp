@@ -0,0 +1,362 @@
+#include "gtest/gtest.h"
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* abort */
+#include <string.h> /* memset */
+
+extern "C" {
+#include "openpilot.h"
+#include "uavobjectsinit.h"
+
+extern UAVObjHandle ut_handles[];
+extern const uint32_t ut_num_handles;
+UAVObjHandle ut_get_by_id_linear(uint32_t id);
+uint16_t ut_get_seq(UAVObjHandle obj_handle);
+void ut_set_seq(UAVObjHandle obj_handle, uint16_t seq);
+void ut_flash_erase(void);
+}
+
+/* Object IDs registered by the tests, in ascending order */
+static const uint32_t known_ids[] = {
+    0x0000ABC0, 0x0000ABC2, 0x12345678, 0x2A7F0C4E, 0x5E1A8B30, 0x8FFFFFFE, 0xAA55AA55, 0xFFFFFFF0,
+};
+
+#define KNOWN_COUNT NELEMENTS(known_ids)
+#define UNKNOWN_ID  0x31415926
+#define OVERFLOW_ID 0x40000000
+
+// To use a test fixture, derive a class from testing::Test.
+class UAVObjectManagerGetByID : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        UAVObjInitialize();
+    }
+};
+
+TEST_F(UAVObjectManagerGetByID, NothingRegistered) {
+    for (uint32_t i = 0; i < KNOWN_COUNT; i++) {
+        EXPECT_EQ(NULL, UAVObjGetByID(known_ids[i]));
+        EXPECT_EQ(NULL, UAVObjGetByID(MetaObjectId(known_ids[i])));
+    }
+}
+
+TEST_F(UAVObjectManagerGetByID, MatchesLinearScan) {
+    /* register every other object, in reverse ID order */
+    for (int32_t i = KNOWN_COUNT - 1; i >= 0; i -= 2) {
+        ut_handles[i] = UAVObjRegister(known_ids[i], true, false, false, 16, NULL);
+        ASSERT_TRUE(ut_handles[i] != NULL);
+    }
+
+    for (uint32_t i = 0; i < KNOWN_COUNT; i++) {
+        EXPECT_EQ(ut_get_by_id_linear(known_ids[i]), UAVObjGetByID(known_ids[i]));
+        EXPECT_EQ(ut_get_by_id_linear(MetaObjectId(known_ids[i])), UAVObjGetByID(MetaObjectId(known_ids[i])));
+    }
+
+    /* register the rest */
+    for (int32_t i = KNOWN_COUNT - 2; i >= 0; i -= 2) {
+        ut_handles[i] = UAVObjRegister(known_ids[i], false, true, false, 32, NULL);
+        ASSERT_TRUE(ut_handles[i] != NULL);
+    }
+
+    for (uint32_t i = 0; i < KNOWN_COUNT; i++) {
+        EXPECT_EQ(ut_handles[i], UAVObjGetByID(known_ids[i]));
+        EXPECT_EQ(UAVObjGetLinkedObj(ut_handles[i]), UAVObjGetByID(MetaObjectId(known_ids[i])));
+        EXPECT_EQ(ut_get_by_id_linear(known_ids[i]), UAVObjGetByID(known_ids[i]));
+        EXPECT_EQ(ut_get_by_id_linear(MetaObjectId(known_ids[i])), UAVObjGetByID(MetaObjectId(known_ids[i])));
+        EXPECT_EQ(known_ids[i], UAVObjGetID(UAVObjGetByID(known_ids[i])));
+    }
+
+    EXPECT_EQ(NULL, UAVObjGetByID(UNKNOWN_ID));
+}
+
+TEST_F(UAVObjectManagerGetByID, DuplicateRegistration) {
+    ut_handles[0] = UAVObjRegister(known_ids[0], true, false, false, 16, NULL);
+    ASSERT_TRUE(ut_handles[0] != NULL);
+    EXPECT_EQ(NULL, UAVObjRegister(known_ids[0], true, false, false, 16, NULL));
+}
+
+TEST_F(UAVObjectManagerGetByID, UnknownObject) {
+    /* any ID can be registered, not only the known ones */
+    ut_handles[KNOWN_COUNT] = UAVObjRegister(UNKNOWN_ID, true, false, false, 16, NULL);
+    ASSERT_TRUE(ut_handles[KNOWN_COUNT] != NULL);
+
+    EXPECT_EQ(ut_handles[KNOWN_COUNT], UAVObjGetByID(UNKNOWN_ID));
+    EXPECT_EQ(UAVObjGetLinkedObj(ut_handles[KNOWN_COUNT]), UAVObjGetByID(MetaObjectId(UNKNOWN_ID)));
+    EXPECT_EQ(ut_get_by_id_linear(UNKNOWN_ID), UAVObjGetByID(UNKNOWN_ID));
+}
+
+TEST_F(UAVObjectManagerGetByID, TableOverflow) {
+    UAVObjHandle displaced[2];
+
+    /* the lookup table has one entry per handle slot, fill it */
+    for (uint32_t i = 0; i < ut_num_handles; i++) {
+        ut_handles[i] = UAVObjRegister(OVERFLOW_ID - 2 * i, true, false, false, 16, NULL);
+        ASSERT_TRUE(ut_handles[i] != NULL);
+    }
+
+    /* objects registered past that are only found by scanning the handle slots */
+    for (uint32_t i = 0; i < NELEMENTS(displaced); i++) {
+        displaced[i]  = ut_handles[i];
+        ut_handles[i] = UAVObjRegister(OVERFLOW_ID + 2 + 2 * i, false, true, false, 16, NULL);
+        ASSERT_TRUE(ut_handles[i] != NULL);
+    }
+
+    for (uint32_t i = 0; i < ut_num_handles; i++) {
+        uint32_t id = UAVObjGetID(ut_handles[i]);
+        EXPECT_EQ(ut_handles[i], UAVObjGetByID(id));
+        EXPECT_EQ(ut_get_by_id_linear(id), UAVObjGetByID(id));
+        EXPECT_EQ(ut_get_by_id_linear(MetaObjectId(id)), UAVObjGetByID(MetaObjectId(id)));
+        EXPECT_EQ(UAVObjGetLinkedObj(ut_handles[i]), UAVObjGetByID(MetaObjectId(id)));
+    }
+
+    /* the objects that left their slot are still in the table */
+    for (uint32_t i = 0; i < NELEMENTS(displaced); i++) {
+        EXPECT_EQ(displaced[i], UAVObjGetByID(OVERFLOW_ID - 2 * i));
+    }
+
+    EXPECT_EQ(NULL, UAVObjGetByID(UNKNOWN_ID));
+    EXPECT_EQ(NULL, UAVObjGetByID(OVERFLOW_ID + 2 + 2 * NELEMENTS(displaced)));
+}
+
+class UAVObjectManagerData : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        UAVObjInitialize();
+        ut_handles[0] = UAVObjRegister(known_ids[0], true, false, false, sizeof(data), NULL);
+        ut_handles[1] = UAVObjRegister(known_ids[1], false, false, false, sizeof(data), NULL);
+        for (uint32_t i = 0; i < sizeof(data); i++) {
+            data[i] = i;
+        }
+    }
+
+    uint8_t data[40];
+};
+
+TEST_F(UAVObjectManagerData, WriteUpdatesSequence) {
+    uint8_t out[sizeof(data)];
+
+    EXPECT_EQ(0, ut_get_seq(ut_handles[0]));
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+    EXPECT_EQ(2, ut_get_seq(ut_handles[0]));
+    EXPECT_EQ(0, UAVObjSetInstanceDataField(ut_handles[0], 0, &data[4], 4, 4));
+    EXPECT_EQ(4, ut_get_seq(ut_handles[0]));
+    EXPECT_EQ(0, UAVObjUnpack(ut_handles[0], 0, data));
+    EXPECT_EQ(6, ut_get_seq(ut_handles[0]));
+
+    memset(out, 0, sizeof(out));
+    EXPECT_EQ(0, UAVObjGetInstanceData(ut_handles[0], 0, out));
+    EXPECT_EQ(0, memcmp(data, out, sizeof(data)));
+    /* reads do not touch the sequence counter */
+    EXPECT_EQ(6, ut_get_seq(ut_handles[0]));
+}
+
+TEST_F(UAVObjectManagerData, ReadDuringWrite) {
+    uint8_t out[sizeof(data)];
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+
+    /* pretend a writer got interrupted, the read falls back to the locked copy */
+    ut_set_seq(ut_handles[0], 3);
+    memset(out, 0, sizeof(out));
+    EXPECT_EQ(0, UAVObjGetInstanceData(ut_handles[0], 0, out));
+    EXPECT_EQ(0, memcmp(data, out, sizeof(data)));
+
+    memset(out, 0, sizeof(out));
+    EXPECT_EQ(0, UAVObjPack(ut_handles[0], 0, out));
+    EXPECT_EQ(0, memcmp(data, out, sizeof(data)));
+}
+
+TEST_F(UAVObjectManagerData, CachedData) {
+    uint8_t cached[sizeof(data)];
+    UAVObjDataCache cache = { 0 };
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+
+    /* the first call always copies */
+    memset(cached, 0, sizeof(cached));
+    EXPECT_EQ(1, UAVObjGetCachedData(ut_handles[0], &cache, cached));
+    EXPECT_EQ(0, memcmp(data, cached, sizeof(data)));
+
+    /* unchanged object, the copy is left alone */
+    memset(cached, 0, sizeof(cached));
+    EXPECT_EQ(0, UAVObjGetCachedData(ut_handles[0], &cache, cached));
+    EXPECT_EQ(0, cached[1]);
+
+    /* any write refreshes the copy */
+    data[1] = 0xAA;
+    EXPECT_EQ(0, UAVObjSetInstanceDataField(ut_handles[0], 0, &data[1], 1, 1));
+    EXPECT_EQ(1, UAVObjGetCachedData(ut_handles[0], &cache, cached));
+    EXPECT_EQ(0, memcmp(data, cached, sizeof(data)));
+    EXPECT_EQ(0, UAVObjGetCachedData(ut_handles[0], &cache, cached));
+}
+
+TEST_F(UAVObjectManagerData, Fields) {
+    uint8_t out[8];
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+    EXPECT_EQ(0, UAVObjGetInstanceDataField(ut_handles[0], 0, out, 10, sizeof(out)));
+    EXPECT_EQ(0, memcmp(&data[10], out, sizeof(out)));
+
+    /* overrun */
+    EXPECT_EQ(-1, UAVObjGetInstanceDataField(ut_handles[0], 0, out, sizeof(data) - 4, sizeof(out)));
+    EXPECT_EQ(-1, UAVObjSetInstanceDataField(ut_handles[0], 0, out, sizeof(data) - 4, sizeof(out)));
+}
+
+TEST_F(UAVObjectManagerData, Instances) {
+    uint8_t out[sizeof(data)];
+
+    /* missing instances */
+    EXPECT_EQ(-1, UAVObjGetInstanceData(ut_handles[0], 1, out));
+    EXPECT_EQ(-1, UAVObjGetInstanceData(ut_handles[1], 2, out));
+
+    EXPECT_EQ(1, UAVObjCreateInstance(ut_handles[1], NULL));
+    EXPECT_EQ(-1, UAVObjSetInstanceData(ut_handles[1], 2, data));
+    /* unpacking creates the missing instances */
+    EXPECT_EQ(0, UAVObjUnpack(ut_handles[1], 3, data));
+    EXPECT_EQ(4, UAVObjGetNumInstances(ut_handles[1]));
+    EXPECT_EQ(0, UAVObjGetInstanceData(ut_handles[1], 3, out));
+    EXPECT_EQ(0, memcmp(data, out, sizeof(data)));
+    EXPECT_EQ(0, UAVObjGetInstanceData(ut_handles[1], 2, out));
+    EXPECT_NE(0, memcmp(data, out, sizeof(data)));
+}
+
+class UAVObjectManagerSettingsHash : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ut_flash_erase();
+        UAVObjInitialize();
+        ut_handles[0] = UAVObjRegister(known_ids[0], true, true, false, sizeof(data), NULL);
+        ut_handles[1] = UAVObjRegister(known_ids[1], false, true, false, sizeof(data), NULL);
+        ut_handles[2] = UAVObjRegister(known_ids[2], true, false, false, sizeof(data), NULL);
+        for (uint32_t i = 0; i < sizeof(data); i++) {
+            data[i] = i;
+        }
+    }
+
+    uint8_t data[40];
+};
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Recompute the hash from scratch the way the GCS does it */
+static uint32_t reference_hash(void)
+{
+    uint32_t sum = 0;
+    uint8_t buf[64];
+
+    for (uint32_t i = 0; i < 3; i++) {
+        UAVObjHandle objs[] = { ut_handles[i], UAVObjGetLinkedObj(ut_handles[i]) };
+        for (uint32_t k = 0; k < 2; k++) {
+            UAVObjHandle obj = objs[k];
+            if (!UAVObjIsSettings(obj) && !UAVObjIsMetaobject(obj)) {
+                continue;
+            }
+            for (uint16_t inst = 0; inst < UAVObjGetNumInstances(obj); inst++) {
+                uint32_t id = UAVObjGetID(obj);
+                uint8_t key[6] = { (uint8_t)id, (uint8_t)(id >> 8), (uint8_t)(id >> 16), (uint8_t)(id >> 24), (uint8_t)inst, (uint8_t)(inst >> 8) };
+                EXPECT_EQ(0, UAVObjPack(obj, inst, buf));
+                sum += fnv1a(fnv1a(2166136261u, key, sizeof(key)), buf, UAVObjGetNumBytes(obj));
+            }
+        }
+    }
+    return sum;
+}
+
+TEST_F(UAVObjectManagerSettingsHash, MatchesRecomputation) {
+    UAVObjMetadata metadata;
+
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    EXPECT_EQ(0, UAVObjSetInstanceDataField(ut_handles[0], 0, &data[20], 4, 4));
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    /* new instances are hashed too */
+    EXPECT_EQ(0, UAVObjUnpack(ut_handles[1], 2, data));
+    EXPECT_EQ(3, UAVObjGetNumInstances(ut_handles[1]));
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    EXPECT_EQ(0, UAVObjGetMetadata(ut_handles[2], &metadata));
+    metadata.telemetryUpdatePeriod = 1234;
+    EXPECT_EQ(0, UAVObjSetMetadata(ut_handles[2], &metadata));
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+}
+
+TEST_F(UAVObjectManagerSettingsHash, OnlySettingsAndMetadata) {
+    uint32_t hash = UAVObjGetSettingsHash();
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[2], 0, data));
+    EXPECT_EQ(hash, UAVObjGetSettingsHash());
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+    EXPECT_NE(hash, UAVObjGetSettingsHash());
+}
+
+TEST_F(UAVObjectManagerSettingsHash, RevertRestoresHash) {
+    uint8_t original[sizeof(data)];
+
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[0], 0, data));
+    uint32_t hash = UAVObjGetSettingsHash();
+    memcpy(original, data, sizeof(data));
+
+    /* the same bytes in a different instance hash differently */
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[1], 0, data));
+    EXPECT_NE(hash, UAVObjGetSettingsHash());
+    memset(data, 0, sizeof(data));
+    EXPECT_EQ(0, UAVObjSetInstanceData(ut_handles[1], 0, data));
+    EXPECT_EQ(hash, UAVObjGetSettingsHash());
+
+    data[7] = 0x55;
+    EXPECT_EQ(0, UAVObjUnpack(ut_handles[0], 0, data));
+    EXPECT_NE(hash, UAVObjGetSettingsHash());
+    EXPECT_EQ(0, UAVObjUnpack(ut_handles[0], 0, original));
+    EXPECT_EQ(hash, UAVObjGetSettingsHash());
+}
+
+TEST_F(UAVObjectManagerSettingsHash, LoadFromFlash) {
+    UAVObjMetadata metadata;
+
+    /* settings and metadata found in flash when the objects get registered */
+    memset(&metadata, 0x5a, sizeof(metadata));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(0, known_ids[0], 0, data, sizeof(data)));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(0, known_ids[2] + 1, 0, (uint8_t *)&metadata, sizeof(metadata)));
+    UAVObjInitialize();
+    ut_handles[0] = UAVObjRegister(known_ids[0], true, true, false, sizeof(data), NULL);
+    ut_handles[1] = UAVObjRegister(known_ids[1], false, true, false, sizeof(data), NULL);
+    ut_handles[2] = UAVObjRegister(known_ids[2], true, false, false, sizeof(data), NULL);
+    EXPECT_EQ(0, UAVObjGetMetadata(ut_handles[2], &metadata));
+    EXPECT_EQ(0x5a5a, metadata.telemetryUpdatePeriod);
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    /* reloading the settings and the metaobjects */
+    data[3] = 0xa5;
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(0, known_ids[0], 0, data, sizeof(data)));
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(0, known_ids[1], 0, data, sizeof(data)));
+    uint32_t hash = UAVObjGetSettingsHash();
+    EXPECT_EQ(0, UAVObjLoadSettings());
+    EXPECT_NE(hash, UAVObjGetSettingsHash());
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    metadata.telemetryUpdatePeriod = 4321;
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(0, PIOS_FLASHFS_ObjSave(0, known_ids[i] + 1, 0, (uint8_t *)&metadata, sizeof(metadata)));
+    }
+    EXPECT_EQ(0, UAVObjLoadMetaobjects());
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+
+    /* a failed load leaves the hash consistent */
+    EXPECT_EQ(0, PIOS_FLASHFS_ObjDelete(0, known_ids[0], 0));
+    EXPECT_EQ(-1, UAVObjLoad(ut_handles[0], 0));
+    EXPECT_EQ(reference_hash(), UAVObjGetSettingsHash());
+}
@@ -0,0 +1,119 @@
+/*
+ * Test fixture support that needs to be written in C: the object handle
+ * table in the _uavo_handles section and the stubs for the rest of the firmware.
+ */
+
+#include "openpilot.h"
+#include "uavobjectprivate.h"
+#include "uavobjectsinit.h"
+
+/* One slot per object registered by the tests, this also sizes the lookup table */
+#define UT_NUM_HANDLES 10
+
+UAVObjHandle ut_handles[UT_NUM_HANDLES] __attribute__((section("_uavo_handles")));
+const uint32_t ut_num_handles = UT_NUM_HANDLES;
+
+int32_t EventCallbackDispatch(__attribute__((unused)) UAVObjEvent *ev, __attribute__((unused)) UAVObjEventCallback cb)
+{
+    return pdTRUE;
+}
+
+uint8_t PIOS_CRC_updateCRC(uint8_t crc, __attribute__((unused)) const uint8_t *data, __attribute__((unused)) int32_t length)
+{
+    return crc;
+}
+
+/* In memory settings file system */
+#define UT_FLASH_SLOTS    8
+#define UT_FLASH_MAX_SIZE 64
+
+static struct {
+    bool     used;
+    uint32_t id;
+    uint16_t instId;
+    uint16_t size;
+    uint8_t  data[UT_FLASH_MAX_SIZE];
+} ut_flash[UT_FLASH_SLOTS];
+
+uintptr_t pios_uavo_settings_fs_id;
+
+void ut_flash_erase(void)
+{
+    memset(ut_flash, 0, sizeof(ut_flash));
+}
+
+int32_t PIOS_FLASHFS_ObjSave(__attribute__((unused)) uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id, uint8_t *obj_data, uint16_t obj_size)
+{
+    int32_t free_slot = -1;
+
+    if (obj_size > UT_FLASH_MAX_SIZE) {
+        return -1;
+    }
+    for (int32_t i = 0; i < UT_FLASH_SLOTS; i++) {
+        if (ut_flash[i].used && ut_flash[i].id == obj_id && ut_flash[i].instId == obj_inst_id) {
+            free_slot = i;
+            break;
+        }
+        if (!ut_flash[i].used && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        return -1;
+    }
+    ut_flash[free_slot].used   = true;
+    ut_flash[free_slot].id     = obj_id;
+    ut_flash[free_slot].instId = obj_inst_id;
+    ut_flash[free_slot].size   = obj_size;
+    memcpy(ut_flash[free_slot].data, obj_data, obj_size);
+    return 0;
+}
+
+int32_t PIOS_FLASHFS_ObjLoad(__attribute__((unused)) uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id, uint8_t *obj_data, uint16_t obj_size)
+{
+    for (int32_t i = 0; i < UT_FLASH_SLOTS; i++) {
+        if (ut_flash[i].used && ut_flash[i].id == obj_id && ut_flash[i].instId == obj_inst_id) {
+            if (ut_flash[i].size != obj_size) {
+                return -1;
+            }
+            memcpy(obj_data, ut_flash[i].data, obj_size);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int32_t PIOS_FLASHFS_ObjDelete(__attribute__((unused)) uintptr_t fs_id, uint32_t obj_id, uint16_t obj_inst_id)
+{
+    for (int32_t i = 0; i < UT_FLASH_SLOTS; i++) {
+        if (ut_flash[i].used && ut_flash[i].id == obj_id && ut_flash[i].instId == obj_inst_id) {
+            ut_flash[i].used = false;
+        }
+    }
+    return 0;
+}
+
+/* Reference implementation: scan the whole handle table like UAVObjGetByID() used to */
+UAVObjHandle ut_get_by_id_linear(uint32_t id)
+{
+    UAVO_LIST_ITERATE(tmp_obj)
+    if (tmp_obj->id == id) {
+        return (UAVObjHandle)tmp_obj;
+    }
+    if (MetaObjectId(tmp_obj->id) == id) {
+        return (UAVObjHandle) & (tmp_obj->metaObj);
+    }
+}
+return NULL;
+}
+
+/* Access to the instance data sequence counter of a data object */
+uint16_t ut_get_seq(UAVObjHandle obj_handle)
+{
+    return ((struct UAVOData *)obj_handle)->seq;
+}
+
+void ut_set_seq(UAVObjHandle obj_handle, uint16_t seq)
+{
+    ((struct UAVOData *)obj_handle)->seq = seq;
+}
@@ -65,12 +65,20 @@ struct PeriodicObjectListStruct {
     EventCallbackInfo evInfo; /** Event callback information */
     uint16_t updatePeriodMs; /** Update period in ms or 0 if no periodic updates are needed */
     int32_t  timeToNextUpdateMs; /** Time delay to the next update */
+    bool     heapQueued; /** In the deadline heap */
     struct PeriodicObjectListStruct *next; /** Needed by linked list library (utlist.h) */
+    struct PeriodicObjectListStruct *heapChild; /** Deadline heap: first child */
+    struct PeriodicObjectListStruct *heapNext; /** Deadline heap: next sibling */
+    struct PeriodicObjectListStruct *heapPrev; /** Deadline heap: parent or previous sibling */
 };
 typedef struct PeriodicObjectListStruct PeriodicObjectList;
 
 // Private variables
 static PeriodicObjectList *mObjList;
+// Pairing heap of the scheduled entries of mObjList, ordered by timeToNextUpdateMs.
+// Its links live in the entries, so it never allocates.
+static PeriodicObjectList *mHeap;
+static uint16_t mHeapSize;
 static xQueueHandle mQueue;
 static DelayedCallbackInfo *eventSchedulerCallback;
 static xSemaphoreHandle mMutex;
@@ -82,6 +90,9 @@ static void eventTask();
 static int32_t eventPeriodicCreate(UAVObjEvent *ev, UAVObjEventCallback cb, xQueueHandle queue, uint16_t periodMs);
 static int32_t eventPeriodicUpdate(UAVObjEvent *ev, UAVObjEventCallback cb, xQueueHandle queue, uint16_t periodMs);
 static uint16_t randomizePeriod(uint16_t periodMs);
+static void heapSchedule(PeriodicObjectList *objEntry);
+static void heapInsert(PeriodicObjectList *objEntry);
+static void heapRemove(PeriodicObjectList *objEntry);
 
 
 /**
@@ -92,6 +103,8 @@ int32_t EventDispatcherInitialize()
 {
     // Initialize variables
     mObjList = NULL;
+    mHeap    = NULL;
+    mHeapSize = 0;
     memset(&mStats, 0, sizeof(EventStats));
 
     // Create mMutex
@@ -230,6 +243,7 @@ static int32_t eventPeriodicCreate(UAVObjEvent *ev, UAVObjEventCallback cb, xQue
     // Create handle
     objEntry = (PeriodicObjectList *)pios_malloc(sizeof(PeriodicObjectList));
     if (objEntry == NULL) {
+        xSemaphoreGiveRecursive(mMutex);
         return -1;
     }
     objEntry->evInfo.ev.obj      = ev->obj;
@@ -239,7 +253,8 @@ static int32_t eventPeriodicCreate(UAVObjEvent *ev, UAVObjEventCallback cb, xQue
     objEntry->evInfo.queue       = queue;
     objEntry->updatePeriodMs     = periodMs;
     objEntry->timeToNextUpdateMs = randomizePeriod(periodMs); // avoid bunching of updates
-    // Add to list
+    objEntry->heapQueued = false;
+    heapSchedule(objEntry);
     LL_APPEND(mObjList, objEntry);
     // Release lock
     xSemaphoreGiveRecursive(mMutex);
@@ -270,6 +285,7 @@ static int32_t eventPeriodicUpdate(UAVObjEvent *ev, UAVObjEventCallback cb, xQue
             // Object found, update period
             objEntry->updatePeriodMs     = periodMs;
             objEntry->timeToNextUpdateMs = randomizePeriod(periodMs); // avoid bunching of updates
+            heapSchedule(objEntry);
             // Release lock
             xSemaphoreGiveRecursive(mMutex);
             return 0;
@@ -312,6 +328,7 @@ static void eventTask()
 
 /**
  * Handle periodic updates for all objects.
+ * Only the entries that are due are visited, they are taken from the top of the deadline heap.
  * \return The system time until the next update (in ms) or -1 if failed
  */
 static int32_t processPeriodicUpdates()
@@ -319,49 +336,167 @@ static int32_t processPeriodicUpdates()
     PeriodicObjectList *objEntry;
     int32_t timeNow;
     int32_t timeToNextUpdate;
-    int32_t offset;
+    int32_t lateness;
+    uint16_t processed = 0;
 
     // Get lock
     xSemaphoreTakeRecursive(mMutex, portMAX_DELAY);
 
-    // Iterate through each object and update its timer, if zero then transmit object.
-    // Also calculate smallest delay to next update.
-    timeToNextUpdate = xTaskGetTickCount() * portTICK_RATE_MS + MAX_UPDATE_PERIOD_MS;
-    LL_FOREACH(mObjList, objEntry) {
-        // If object is configured for periodic updates
-        if (objEntry->updatePeriodMs > 0) {
-            // Check if time for the next update
-            timeNow = xTaskGetTickCount() * portTICK_RATE_MS;
-            if (objEntry->timeToNextUpdateMs <= timeNow) {
-                // Reset timer
-                offset = (timeNow - objEntry->timeToNextUpdateMs) % objEntry->updatePeriodMs;
-                objEntry->timeToNextUpdateMs = timeNow + objEntry->updatePeriodMs - offset;
-                // Invoke callback, if one
-                if (objEntry->evInfo.cb != 0) {
-                    objEntry->evInfo.cb(&objEntry->evInfo.ev); // the function is expected to copy the event information
-                }
-                // Push event to queue, if one
-                if (objEntry->evInfo.queue != 0) {
-                    if (xQueueSend(objEntry->evInfo.queue, &objEntry->evInfo.ev, 0) != pdTRUE && !objEntry->evInfo.ev.lowPriority) { // do not block if queue is full
-                        if (objEntry->evInfo.ev.obj != NULL) {
-                            mStats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
-                        }
-                        ++mStats.eventErrors;
-                    }
+    timeNow = xTaskGetTickCount() * portTICK_RATE_MS;
+
+    // Each entry is processed at most once per wakeup, even if a callback reschedules it
+    uint16_t limit = mHeapSize;
+    while (mHeap && mHeap->timeToNextUpdateMs <= timeNow && processed < limit) {
+        objEntry = mHeap;
+        // Reset timer
+        lateness = timeNow - objEntry->timeToNextUpdateMs;
+        heapRemove(objEntry);
+        objEntry->timeToNextUpdateMs = timeNow + objEntry->updatePeriodMs - (lateness % objEntry->updatePeriodMs);
+        heapInsert(objEntry);
+        ++processed;
+        if ((uint32_t)lateness > mStats.periodicMaxLatenessMs) {
+            mStats.periodicMaxLatenessMs = lateness;
+        }
+        // Invoke callback, if one
+        if (objEntry->evInfo.cb != 0) {
+            objEntry->evInfo.cb(&objEntry->evInfo.ev); // the function is expected to copy the event information
+        }
+        // Push event to queue, if one
+        if (objEntry->evInfo.queue != 0) {
+            if (xQueueSend(objEntry->evInfo.queue, &objEntry->evInfo.ev, 0) != pdTRUE && !objEntry->evInfo.ev.lowPriority) { // do not block if queue is full
+                if (objEntry->evInfo.ev.obj != NULL) {
+                    mStats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
                 }
-            }
-            // Update minimum delay
-            if (objEntry->timeToNextUpdateMs < timeToNextUpdate) {
-                timeToNextUpdate = objEntry->timeToNextUpdateMs;
+                ++mStats.eventErrors;
             }
         }
     }
 
+    mStats.periodicLastProcessed = processed;
+    if (processed > mStats.periodicMaxProcessed) {
+        mStats.periodicMaxProcessed = processed;
+    }
+
+    // Calculate delay to next update
+    timeToNextUpdate = timeNow + MAX_UPDATE_PERIOD_MS;
+    if (mHeap && mHeap->timeToNextUpdateMs < timeToNextUpdate) {
+        timeToNextUpdate = mHeap->timeToNextUpdateMs;
+    }
+
     // Done
     xSemaphoreGiveRecursive(mMutex);
     return timeToNextUpdate;
 }
 
+/**
+ * Insert, move or remove an entry in the deadline heap after its period or
+ * next update time changed. Must be called with mMutex held.
+ */
+static void heapSchedule(PeriodicObjectList *objEntry)
+{
+    // The next update time can have moved in either direction
+    if (objEntry->heapQueued) {
+        heapRemove(objEntry);
+    }
+    if (objEntry->updatePeriodMs != 0) {
+        heapInsert(objEntry);
+    }
+}
+
+/**
+ * Meld two heaps, the later root becomes the first child of the earlier one
+ */
+static PeriodicObjectList *heapMeld(PeriodicObjectList *a, PeriodicObjectList *b)
+{
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+    if (b->timeToNextUpdateMs < a->timeToNextUpdateMs) {
+        PeriodicObjectList *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->heapNext = a->heapChild;
+    if (a->heapChild != NULL) {
+        a->heapChild->heapPrev = b;
+    }
+    b->heapPrev  = a;
+    a->heapChild = b;
+    return a;
+}
+
+/**
+ * Meld a list of siblings into one heap, in pairs from left to right and
+ * then the pairs from right to left
+ */
+static PeriodicObjectList *heapMergePairs(PeriodicObjectList *first)
+{
+    PeriodicObjectList *pairs = NULL;
+
+    while (first != NULL) {
+        PeriodicObjectList *a = first;
+        PeriodicObjectList *b = a->heapNext;
+        first = (b != NULL) ? b->heapNext : NULL;
+        a->heapNext = NULL;
+        a->heapPrev = NULL;
+        if (b != NULL) {
+            b->heapNext = NULL;
+            b->heapPrev = NULL;
+        }
+        a = heapMeld(a, b);
+        // the melded pairs are stacked through heapNext
+        a->heapNext = pairs;
+        pairs = a;
+    }
+
+    PeriodicObjectList *root = NULL;
+    while (pairs != NULL) {
+        PeriodicObjectList *next = pairs->heapNext;
+        pairs->heapNext = NULL;
+        root  = heapMeld(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+static void heapInsert(PeriodicObjectList *objEntry)
+{
+    objEntry->heapChild  = NULL;
+    objEntry->heapNext   = NULL;
+    objEntry->heapPrev   = NULL;
+    objEntry->heapQueued = true;
+    mHeap = heapMeld(mHeap, objEntry);
+    ++mHeapSize;
+}
+
+static void heapRemove(PeriodicObjectList *objEntry)
+{
+    PeriodicObjectList *children = heapMergePairs(objEntry->heapChild);
+
+    if (objEntry == mHeap) {
+        mHeap = children;
+    } else {
+        // unlink the subtree from its parent or previous sibling
+        if (objEntry->heapPrev->heapChild == objEntry) {
+            objEntry->heapPrev->heapChild = objEntry->heapNext;
+        } else {
+            objEntry->heapPrev->heapNext = objEntry->heapNext;
+        }
+        if (objEntry->heapNext != NULL) {
+            objEntry->heapNext->heapPrev = objEntry->heapPrev;
+        }
+        mHeap = heapMeld(mHeap, children);
+    }
+    objEntry->heapChild  = NULL;
+    objEntry->heapNext   = NULL;
+    objEntry->heapPrev   = NULL;
+    objEntry->heapQueued = false;
+    --mHeapSize;
+}
+
 /**
  * Return a psedorandom integer from 0 to periodMs
  * Based on the Park-Miller-Carta Pseudo-Random Number Generator
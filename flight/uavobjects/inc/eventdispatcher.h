@@ -33,6 +33,9 @@
 typedef struct {
     uint32_t lastErrorID;
     uint32_t eventErrors;
+    uint32_t periodicMaxLatenessMs; /** Worst delay of a periodic event past its due time */
+    uint16_t periodicLastProcessed; /** Periodic events processed by the last wakeup */
+    uint16_t periodicMaxProcessed; /** Most periodic events processed by a single wakeup */
 } EventStats;
 
 // Public functions
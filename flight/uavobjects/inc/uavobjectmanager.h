@@ -172,6 +172,15 @@ typedef void (*UAVObjEventCallback)(UAVObjEvent *ev);
  */
 typedef void (*UAVObjInitializeCallback)(UAVObjHandle obj_handle, uint16_t instId);
 
+/**
+ * Cached copy of the data of a single instance object, see UAVObjGetCachedData().
+ * Must be zero initialized.
+ */
+typedef struct {
+    uint16_t seq; /** Sequence counter of the object when the copy was taken */
+    bool     valid;
+} UAVObjDataCache;
+
 /**
  * Event manager statistics
  */
@@ -216,6 +225,7 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId, const vo
 int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, const void *dataIn, uint32_t offset, uint32_t size);
 int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId, void *dataOut);
 int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, void *dataOut, uint32_t offset, uint32_t size);
+int32_t UAVObjGetCachedData(UAVObjHandle obj_handle, UAVObjDataCache *cache, void *dataCache);
 int32_t UAVObjSetMetadata(UAVObjHandle obj_handle, const UAVObjMetadata *dataIn);
 int32_t UAVObjGetMetadata(UAVObjHandle obj_handle, UAVObjMetadata *dataOut);
 uint8_t UAVObjGetMetadataAccess(const UAVObjMetadata *dataOut);
@@ -245,6 +255,7 @@ void UAVObjInstanceUpdated(UAVObjHandle obj_handle, uint16_t instId);
 void UAVObjLogging(UAVObjHandle obj);
 void UAVObjInstanceLogging(UAVObjHandle obj_handle, uint16_t instId);
 void UAVObjIterate(void (*iterator)(UAVObjHandle obj));
+uint32_t UAVObjGetSettingsHash();
 void UAVObjInstanceWriteToLog(UAVObjHandle obj_handle, uint16_t instId);
 
 #endif // UAVOBJECTMANAGER_H
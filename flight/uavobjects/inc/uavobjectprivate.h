@@ -120,6 +120,11 @@ struct UAVOData {
      */
     struct UAVOMeta metaObj;
     uint16_t instance_size;
+    /*
+     * Sequence counter for the instance data, odd while a write is in progress.
+     * Lets readers copy the data without taking the object manager lock.
+     */
+    volatile uint16_t seq;
 } __attribute__((packed, aligned(4)));
 
 /* Augmented type for Single Instance Data UAVO */
@@ -169,5 +174,28 @@ struct UAVOMulti {
 // Private functions
 int32_t sendEvent(struct UAVOBase *obj, uint16_t instId, UAVObjEventType event);
 InstanceHandle getInstance(struct UAVOData *obj, uint16_t instId);
+void lockInstanceData(void);
+void unlockInstanceData(void);
+void settingsHashRemove(UAVObjHandle obj_handle, uint16_t instId, const void *data, uint32_t size);
+void settingsHashAdd(UAVObjHandle obj_handle, uint16_t instId, const void *data, uint32_t size);
+
+/**
+ * Mark the start of a write to the instance data of a data object.
+ * Writers must hold the object manager lock.
+ */
+static inline void instanceWriteBegin(struct UAVOData *obj)
+{
+    obj->seq++;
+    WRITE_MEMORY_BARRIER();
+}
+
+/**
+ * Mark the end of a write to the instance data of a data object.
+ */
+static inline void instanceWriteEnd(struct UAVOData *obj)
+{
+    WRITE_MEMORY_BARRIER();
+    obj->seq++;
+}
 
 #endif /* UAVOBJECTPRIVATE_H_ */
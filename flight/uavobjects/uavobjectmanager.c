@@ -34,12 +34,21 @@
 #include "openpilot.h"
 #include "pios_struct_helper.h"
 #include "inc/uavobjectprivate.h"
+#include "uavobjectsinit.h"
+#ifdef PIOS_INCLUDE_INSTRUMENTATION
+#include <pios_instrumentation.h>
+#endif
 
 // Private functions
 static InstanceHandle createInstance(struct UAVOData *obj, uint16_t instId);
 static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue, UAVObjEventCallback cb, uint8_t eventMask, bool fast);
 static int32_t disconnectObj(UAVObjHandle obj_handle, xQueueHandle queue, UAVObjEventCallback cb);
 static void instanceAutoUpdated(UAVObjHandle obj_handle, uint16_t instId);
+static uint16_t findSortedIndex(uint32_t id);
+static struct UAVOData *getByIDSorted(uint32_t id);
+static UAVObjHandle getByIDLinear(uint32_t id);
+static int32_t readInstance(struct UAVOData *obj, uint16_t instId, void *dataOut, uint32_t offset, uint32_t size);
+static uint32_t instanceHash(UAVObjHandle obj_handle, uint16_t instId, const void *data, uint32_t size);
 
 
 int32_t UAVObjPers_stub(__attribute__((unused)) UAVObjHandle obj_handle, __attribute__((unused))  uint16_t instId)
@@ -67,6 +76,23 @@ static const UAVObjMetadata defMetadata = {
 
 static UAVObjStats stats;
 
+#ifdef PIOS_INCLUDE_INSTRUMENTATION
+// Counter 0x55A00001: time spent waiting for the lock to access object data (us)
+static pios_counter_t counterLockWait;
+#endif
+
+// Object lookup table: the handles of the registered objects sorted by object ID.
+// It is allocated at init with one entry per _uavo_handles slot, that is per object
+// linked into the firmware, and is odd while an insertion is in progress.
+static struct UAVOData **uavo_sorted_handles;
+static uint16_t uavo_sorted_size;
+static volatile uint16_t uavo_sorted_count;
+static volatile uint16_t uavo_sorted_seq;
+// Set if an object did not fit in the lookup table
+static bool uavo_unsorted_registered = false;
+// Sum of the hashes of all settings instances and metaobjects, see UAVObjGetSettingsHash()
+static uint32_t settingsHash;
+
 
 static inline bool IsMetaobject(UAVObjHandle obj_handle)
 {
@@ -165,6 +191,24 @@ int32_t UAVObjInitialize()
     // Initialize the uavo handle table
     memset(__start__uavo_handles, 0,
            (uintptr_t)__stop__uavo_handles - (uintptr_t)__start__uavo_handles);
+    if (uavo_sorted_handles == NULL) {
+        uavo_sorted_size    = __stop__uavo_handles - __start__uavo_handles;
+        uavo_sorted_handles = (struct UAVOData * *)pios_malloc(uavo_sorted_size * sizeof(struct UAVOData *));
+        if (uavo_sorted_handles == NULL) {
+            uavo_sorted_size = 0;
+        }
+    }
+    uavo_sorted_count = 0;
+    uavo_sorted_seq   = 0;
+    uavo_unsorted_registered = false;
+    settingsHash = 0;
+
+#ifdef PIOS_INCLUDE_INSTRUMENTATION
+    counterLockWait = NULL;
+    if (pios_instrumentation_perf_counters) {
+        counterLockWait = PIOS_Instrumentation_CreateCounter(0x55A00001);
+    }
+#endif
 
     // Create mutex
     mutex = xSemaphoreCreateRecursiveMutex();
@@ -324,6 +368,10 @@ UAVObjHandle UAVObjRegister(uint32_t id,
     /* Initialize the embedded meta UAVO */
     UAVObjInitMetaData(&uavo_data->metaObj);
 
+    /* Account for the cleared instances, updates from here on are hashed as they happen */
+    settingsHash += instanceHash((UAVObjHandle) & (uavo_data->metaObj), 0, MetaDataPtr(&uavo_data->metaObj), MetaNumBytes);
+    settingsHash += instanceHash((UAVObjHandle)uavo_data, 0, InstanceData(getInstance(uavo_data, 0)), num_bytes);
+
     /* Initialize object fields and metadata to default values */
     if (initCb) {
         initCb((UAVObjHandle)uavo_data, 0);
@@ -341,17 +389,104 @@ UAVObjHandle UAVObjRegister(uint32_t id,
     instanceAutoUpdated((UAVObjHandle)uavo_data, 0);
     instanceAutoUpdated((UAVObjHandle) & (uavo_data->metaObj), 0);
 
+    /* Make the object visible to UAVObjGetByID() */
+    if (uavo_sorted_count < uavo_sorted_size) {
+        uint16_t idx = findSortedIndex(id);
+
+        // Entries are moved one at a time so that a concurrent lookup only
+        // ever sees valid handles, it retries if the sequence changed
+        uavo_sorted_seq++;
+        WRITE_MEMORY_BARRIER();
+        for (uint16_t n = uavo_sorted_count; n > idx; n--) {
+            uavo_sorted_handles[n] = uavo_sorted_handles[n - 1];
+        }
+        uavo_sorted_handles[idx] = uavo_data;
+        uavo_sorted_count++;
+        WRITE_MEMORY_BARRIER();
+        uavo_sorted_seq++;
+    } else {
+        uavo_unsorted_registered = true;
+    }
+
 unlock_exit:
     xSemaphoreGiveRecursive(mutex);
     return (UAVObjHandle)uavo_data;
 }
 
+/**
+ * Find the position of an object ID in the sorted handle table
+ * \param[in] The object ID
+ * \return The index of the first handle with an ID not lower than id
+ */
+static uint16_t findSortedIndex(uint32_t id)
+{
+    uint16_t low  = 0;
+    uint16_t high = uavo_sorted_count;
+
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        if (uavo_sorted_handles[mid]->id < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * Look up a data object in the sorted handle table
+ * \param[in] The object ID
+ * \return The object or NULL if not found.
+ */
+static struct UAVOData *getByIDSorted(uint32_t id)
+{
+    uint16_t idx = findSortedIndex(id);
+
+    if (idx < uavo_sorted_count && uavo_sorted_handles[idx]->id == id) {
+        return uavo_sorted_handles[idx];
+    }
+    return NULL;
+}
+
 /**
  * Retrieve an object from the list given its id
+ * Objects are looked up in the sorted handle table, this does not need the lock as
+ * table entries are only ever added once the object is completely initialized.
  * \param[in] The object ID
  * \return The object or NULL if not found.
  */
 UAVObjHandle UAVObjGetByID(uint32_t id)
+{
+    UAVObjHandle found_obj = NULL;
+    uint16_t seq = uavo_sorted_seq;
+
+    READ_MEMORY_BARRIER();
+    if ((seq & 1) == 0) {
+        // Look for a data object, then for the data object owning this meta object
+        struct UAVOData *obj = getByIDSorted(id);
+        if (obj) {
+            found_obj = (UAVObjHandle)obj;
+        } else if ((obj = getByIDSorted(id - 1)) != NULL && MetaObjectId(obj->id) == id) {
+            found_obj = (UAVObjHandle) & (obj->metaObj);
+        }
+        READ_MEMORY_BARRIER();
+        // Objects that did not fit in the table can only be found by a full scan
+        if (seq == uavo_sorted_seq && (found_obj || !uavo_unsorted_registered)) {
+            return found_obj;
+        }
+    }
+
+    // An object was being registered meanwhile
+    return getByIDLinear(id);
+}
+
+/**
+ * Retrieve an object from the list given its id by iterating over all objects
+ * \param[in] The object ID
+ * \return The object or NULL if not found.
+ */
+static UAVObjHandle getByIDLinear(uint32_t id)
 {
     UAVObjHandle *found_obj = (UAVObjHandle *)NULL;
 
@@ -523,7 +658,7 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId, const uint8_t *da
     PIOS_Assert(obj_handle);
 
     // Lock
-    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    lockInstanceData();
 
     int32_t rc = -1;
 
@@ -531,7 +666,9 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId, const uint8_t *da
         if (instId != 0) {
             goto unlock_exit;
         }
+        settingsHash -= instanceHash(obj_handle, instId, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
         memcpy(MetaDataPtr((struct UAVOMeta *)obj_handle), dataIn, MetaNumBytes);
+        settingsHash += instanceHash(obj_handle, instId, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
     } else {
         struct UAVOData *obj;
         InstanceHandle instEntry;
@@ -550,7 +687,11 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId, const uint8_t *da
             }
         }
         // Set the data
+        settingsHash -= instanceHash(obj_handle, instId, InstanceData(instEntry), obj->instance_size);
+        instanceWriteBegin(obj);
         memcpy(InstanceData(instEntry), dataIn, obj->instance_size);
+        instanceWriteEnd(obj);
+        settingsHash += instanceHash(obj_handle, instId, InstanceData(instEntry), obj->instance_size);
     }
 
     // Fire event
@@ -573,31 +714,21 @@ int32_t UAVObjPack(UAVObjHandle obj_handle, uint16_t instId, uint8_t *dataOut)
 {
     PIOS_Assert(obj_handle);
 
+    // Data objects are read without taking the lock
+    if (!IsMetaobject(obj_handle)) {
+        struct UAVOData *obj = (struct UAVOData *)obj_handle;
+        return readInstance(obj, instId, dataOut, 0, obj->instance_size);
+    }
+
     // Lock
     xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
     int32_t rc = -1;
 
-    if (IsMetaobject(obj_handle)) {
-        if (instId != 0) {
-            goto unlock_exit;
-        }
-        memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
-    } else {
-        struct UAVOData *obj;
-        InstanceHandle instEntry;
-
-        // Cast handle to object
-        obj = (struct UAVOData *)obj_handle;
-
-        // Get the instance
-        instEntry = getInstance(obj, instId);
-        if (instEntry == NULL) {
-            goto unlock_exit;
-        }
-        // Pack data
-        memcpy(dataOut, InstanceData(instEntry), obj->instance_size);
+    if (instId != 0) {
+        goto unlock_exit;
     }
+    memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
 
     rc = 0;
 
@@ -901,6 +1032,40 @@ int32_t UAVObjGetDataField(UAVObjHandle obj_handle, void *dataOut, uint32_t offs
     return UAVObjGetInstanceDataField(obj_handle, 0, dataOut, offset, size);
 }
 
+/**
+ * Refresh a cached copy of the object data, only when the object was written since
+ * the copy was taken. The sequence counter of the object serves as the version of
+ * the copy, so checking an unchanged object neither copies nor takes the lock.
+ * The same cache and data buffer must be passed on every call.
+ * \param[in] obj The object handle
+ * \param[in,out] cache The cache state, zero initialized before the first call
+ * \param[in,out] dataCache The cached copy of the object's data structure
+ * \return 1 if the copy was refreshed, 0 if it is up to date or -1 if failure
+ */
+int32_t UAVObjGetCachedData(UAVObjHandle obj_handle, UAVObjDataCache *cache, void *dataCache)
+{
+    PIOS_Assert(obj_handle);
+
+    if (IsMetaobject(obj_handle)) {
+        return -1;
+    }
+
+    struct UAVOData *obj = (struct UAVOData *)obj_handle;
+    uint16_t seq = obj->seq;
+    READ_MEMORY_BARRIER();
+    if (cache->valid && seq == cache->seq) {
+        return 0;
+    }
+
+    // A write racing with this read makes the next call refresh again
+    if (readInstance(obj, 0, dataCache, 0, obj->instance_size) < 0) {
+        return -1;
+    }
+    cache->seq   = seq;
+    cache->valid = true;
+    return 1;
+}
+
 /**
  * Set the data of a specific object instance
  * \param[in] obj The object handle
@@ -914,7 +1079,7 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
     PIOS_Assert(obj_handle);
 
     // Lock
-    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    lockInstanceData();
 
     int32_t rc = -1;
 
@@ -922,7 +1087,9 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
         if (instId != 0) {
             goto unlock_exit;
         }
+        settingsHash -= instanceHash(obj_handle, instId, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
         memcpy(MetaDataPtr((struct UAVOMeta *)obj_handle), dataIn, MetaNumBytes);
+        settingsHash += instanceHash(obj_handle, instId, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
     } else {
         struct UAVOData *obj;
         InstanceHandle instEntry;
@@ -940,7 +1107,11 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
             goto unlock_exit;
         }
         // Set data
+        settingsHash -= instanceHash(obj_handle, instId, InstanceData(instEntry), obj->instance_size);
+        instanceWriteBegin(obj);
         memcpy(InstanceData(instEntry), dataIn, obj->instance_size);
+        instanceWriteEnd(obj);
+        settingsHash += instanceHash(obj_handle, instId, InstanceData(instEntry), obj->instance_size);
     }
 
     // Fire event
@@ -964,7 +1135,7 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
     PIOS_Assert(obj_handle);
 
     // Lock
-    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    lockInstanceData();
 
     int32_t rc = -1;
 
@@ -980,7 +1151,9 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
         }
 
         // Set data
+        settingsHash -= instanceHash(obj_handle, instId, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
         memcpy(MetaDataPtr((struct UAVOMeta *)obj_handle) + offset, dataIn, size);
+        settingsHash += instanceHash(obj_handle, instId, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
     } else {
         struct UAVOData *obj;
         InstanceHandle instEntry;
@@ -1005,7 +1178,11 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
         }
 
         // Set data
+        settingsHash -= instanceHash(obj_handle, instId, InstanceData(instEntry), obj->instance_size);
+        instanceWriteBegin(obj);
         memcpy(InstanceData(instEntry) + offset, dataIn, size);
+        instanceWriteEnd(obj);
+        settingsHash += instanceHash(obj_handle, instId, InstanceData(instEntry), obj->instance_size);
     }
 
 
@@ -1030,33 +1207,23 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 {
     PIOS_Assert(obj_handle);
 
+    // Data objects are read without taking the lock
+    if (!IsMetaobject(obj_handle)) {
+        struct UAVOData *obj = (struct UAVOData *)obj_handle;
+        return readInstance(obj, instId, dataOut, 0, obj->instance_size);
+    }
+
     // Lock
     xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
     int32_t rc = -1;
 
-    if (IsMetaobject(obj_handle)) {
-        // Get instance information
-        if (instId != 0) {
-            goto unlock_exit;
-        }
-        // Set data
-        memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
-    } else {
-        struct UAVOData *obj;
-        InstanceHandle instEntry;
-
-        // Cast to object info
-        obj = (struct UAVOData *)obj_handle;
-
-        // Get instance information
-        instEntry = getInstance(obj, instId);
-        if (instEntry == NULL) {
-            goto unlock_exit;
-        }
-        // Set data
-        memcpy(dataOut, InstanceData(instEntry), obj->instance_size);
+    // Get instance information
+    if (instId != 0) {
+        goto unlock_exit;
     }
+    // Set data
+    memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
 
     rc = 0;
 
@@ -1076,51 +1243,102 @@ int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, voi
 {
     PIOS_Assert(obj_handle);
 
+    // Data objects are read without taking the lock
+    if (!IsMetaobject(obj_handle)) {
+        return readInstance((struct UAVOData *)obj_handle, instId, dataOut, offset, size);
+    }
+
     // Lock
     xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
     int32_t rc = -1;
 
-    if (IsMetaobject(obj_handle)) {
-        // Get instance information
-        if (instId != 0) {
-            goto unlock_exit;
-        }
+    // Get instance information
+    if (instId != 0) {
+        goto unlock_exit;
+    }
 
-        // Check for overrun
-        if ((size + offset) > MetaNumBytes) {
-            goto unlock_exit;
-        }
+    // Check for overrun
+    if ((size + offset) > MetaNumBytes) {
+        goto unlock_exit;
+    }
 
-        // Set data
-        memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle) + offset, size);
-    } else {
-        struct UAVOData *obj;
-        InstanceHandle instEntry;
+    // Set data
+    memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle) + offset, size);
 
-        // Cast to object info
-        obj = (struct UAVOData *)obj_handle;
+    rc = 0;
 
-        // Get instance information
-        instEntry = getInstance(obj, instId);
-        if (instEntry == NULL) {
-            goto unlock_exit;
-        }
+unlock_exit:
+    xSemaphoreGiveRecursive(mutex);
+    return rc;
+}
 
-        // Check for overrun
-        if ((size + offset) > obj->instance_size) {
-            goto unlock_exit;
-        }
+/**
+ * Read (part of) the data of a data object instance.
+ * The data is copied without taking the lock, the sequence counter of the object tells
+ * whether a writer modified it meanwhile. In that case the copy is repeated with the lock
+ * held: spinning would never let a lower priority writer complete.
+ * \param[in] obj The data object
+ * \param[in] instId The object instance ID
+ * \param[out] dataOut The destination buffer
+ * \param[in] offset Offset of the data to read in the instance
+ * \param[in] size Number of bytes to read
+ * \return 0 if success or -1 if failure
+ */
+static int32_t readInstance(struct UAVOData *obj, uint16_t instId, void *dataOut, uint32_t offset, uint32_t size)
+{
+    // Get instance information, instances are never removed so this is safe without the lock
+    InstanceHandle instEntry = getInstance(obj, instId);
 
-        // Set data
+    if (instEntry == NULL) {
+        return -1;
+    }
+
+    // Check for overrun
+    if ((size + offset) > obj->instance_size) {
+        return -1;
+    }
+
+    uint16_t seq = obj->seq;
+    READ_MEMORY_BARRIER();
+    if ((seq & 1) == 0) {
         memcpy(dataOut, InstanceData(instEntry) + offset, size);
+        READ_MEMORY_BARRIER();
+        if (seq == obj->seq) {
+            return 0;
+        }
     }
 
-    rc = 0;
+    // A write was in progress, wait for the writer to release the lock
+    lockInstanceData();
+    memcpy(dataOut, InstanceData(instEntry) + offset, size);
+    unlockInstanceData();
 
-unlock_exit:
+    return 0;
+}
+
+/**
+ * Take the lock to access object data, keeping track of the time spent waiting for it.
+ */
+void lockInstanceData(void)
+{
+#ifdef PIOS_INCLUDE_INSTRUMENTATION
+    if (counterLockWait) {
+        uint32_t start = PIOS_DELAY_GetRaw();
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+        PIOS_Instrumentation_updateCounter(counterLockWait, PIOS_DELAY_DiffuS(start));
+        return;
+    }
+#endif
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+}
+
+/**
+ * Release the lock taken by lockInstanceData().
+ */
+void unlockInstanceData(void)
+{
     xSemaphoreGiveRecursive(mutex);
-    return rc;
 }
 
 /**
@@ -1501,6 +1719,61 @@ void UAVObjInstanceLogging(UAVObjHandle obj_handle, uint16_t instId)
     xSemaphoreGiveRecursive(mutex);
 }
 
+/**
+ * Get the hash of all settings and metaobject instances. It is the sum of
+ * a hash per instance, updated whenever an instance is written, so it only
+ * changes when some setting or metadata actually changed.
+ * \return the hash
+ */
+uint32_t UAVObjGetSettingsHash()
+{
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    uint32_t hash = settingsHash;
+    xSemaphoreGiveRecursive(mutex);
+    return hash;
+}
+
+/**
+ * Remove an instance from the settings hash before its data is changed in place,
+ * settingsHashAdd() accounts for the new data. Must be called with the lock held.
+ */
+void settingsHashRemove(UAVObjHandle obj_handle, uint16_t instId, const void *data, uint32_t size)
+{
+    settingsHash -= instanceHash(obj_handle, instId, data, size);
+}
+
+/**
+ * Add an instance to the settings hash. Must be called with the lock held.
+ */
+void settingsHashAdd(UAVObjHandle obj_handle, uint16_t instId, const void *data, uint32_t size)
+{
+    settingsHash += instanceHash(obj_handle, instId, data, size);
+}
+
+/**
+ * FNV-1a hash of the object id, instance id (both little endian) and the
+ * instance data of a settings or metaobject instance, 0 for other objects.
+ * The GCS computes the same hash to validate its cached settings.
+ */
+static uint32_t instanceHash(UAVObjHandle obj_handle, uint16_t instId, const void *data, uint32_t size)
+{
+    if (!IsSettings(obj_handle) && !IsMetaobject(obj_handle)) {
+        return 0;
+    }
+
+    uint32_t id = UAVObjGetID(obj_handle);
+    const uint8_t key[6] = { id, id >> 8, id >> 16, id >> 24, instId, instId >> 8 };
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        hash = (hash ^ key[i]) * 16777619u;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ ((const uint8_t *)data)[i]) * 16777619u;
+    }
+    return hash;
+}
+
 /**
  * Iterate through all objects in the list.
  * \param iterator This function will be called once for each object,
@@ -1604,6 +1877,7 @@ static InstanceHandle createInstance(struct UAVOData *obj, uint16_t instId)
     }
     memset(instEntry, 0, size);
     LL_APPEND(((struct UAVOMulti *)obj)->instance0.next, instEntry);
+    settingsHash += instanceHash((UAVObjHandle)obj, instId, InstanceData(InstanceDataOffset(instEntry)), obj->instance_size);
 
     ((struct UAVOMulti *)obj)->num_instances++;
 
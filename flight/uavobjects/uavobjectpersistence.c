@@ -82,34 +82,47 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
 {
     PIOS_Assert(obj_handle);
 
+    // Lock, the data is loaded in place and other tasks may be accessing it
+    lockInstanceData();
+
+    int32_t rc = -1;
+
     if (UAVObjIsMetaobject(obj_handle)) {
         if (instId != 0) {
-            return -1;
+            goto unlock_exit;
         }
 
-        // Fire event on success
-        if (PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id, UAVObjGetID(obj_handle), instId, (uint8_t *)MetaDataPtr((struct UAVOMeta *)obj_handle), UAVObjGetNumBytes(obj_handle)) == 0) {
-            sendEvent((struct UAVOBase *)obj_handle, instId, EV_UNPACKED);
-        } else {
-            return -1;
-        }
+        UAVObjMetadata *metaData = MetaDataPtr((struct UAVOMeta *)obj_handle);
+
+        settingsHashRemove(obj_handle, instId, metaData, MetaNumBytes);
+        rc = PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id, UAVObjGetID(obj_handle), instId, (uint8_t *)metaData, UAVObjGetNumBytes(obj_handle));
+        settingsHashAdd(obj_handle, instId, metaData, MetaNumBytes);
     } else {
         InstanceHandle instEntry = getInstance((struct UAVOData *)obj_handle, instId);
 
         if (instEntry == NULL) {
-            return -1;
+            goto unlock_exit;
         }
 
-        // Fire event on success
-        if (PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id, UAVObjGetID(obj_handle), instId, InstanceData(instEntry), UAVObjGetNumBytes(obj_handle)) == 0) {
-            sendEvent((struct UAVOBase *)obj_handle, instId, EV_UNPACKED);
-        } else {
-            return -1;
-        }
+        uint32_t numBytes = UAVObjGetNumBytes(obj_handle);
+
+        settingsHashRemove(obj_handle, instId, InstanceData(instEntry), numBytes);
+        instanceWriteBegin((struct UAVOData *)obj_handle);
+        rc = PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id, UAVObjGetID(obj_handle), instId, InstanceData(instEntry), numBytes);
+        instanceWriteEnd((struct UAVOData *)obj_handle);
+        settingsHashAdd(obj_handle, instId, InstanceData(instEntry), numBytes);
     }
 
+    // Fire event on success
+    if (rc == 0) {
+        sendEvent((struct UAVOBase *)obj_handle, instId, EV_UNPACKED);
+    } else {
+        rc = -1;
+    }
 
-    return 0;
+unlock_exit:
+    unlockInstanceData();
+    return rc;
 }
 
 /**
@@ -1037,7 +1037,7 @@ static bool UAVTalkProcess_TIMESTAMP(__attribute__((unused)) UAVTalkConnectionDa
 
 static bool UAVTalkProcess_DATA(UAVTalkConnectionData *connection, UAVTalkInputProcessor *iproc, uint8_t *rxbuffer, uint8_t length, uint8_t *position)
 {
-    uint8_t toCopy = iproc->length - iproc->rxCount;
+    uint32_t toCopy = iproc->length - iproc->rxCount;
 
     if (toCopy > length - (*position)) {
         toCopy = length - (*position);
@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# Element access time of the UAVObjectField typed accessors over every
+# numeric field of the generated objects, compared with the QVariant
+# boxing getValue() and setValue()
+#
+#-------------------------------------------------
+
+TARGET = FieldAccessBenchmark
+QT -= gui
+
+include(../gcsbenchmark.pri)
+include(../../../plugins/uavobjects/uavobjects.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,140 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Access time per element of every numeric field of the generated
+ *             objects. Compares getValue().toDouble() and setValue(), which
+ *             box each element in a QVariant, with get<double>(), set<double>()
+ *             and copyElements(). The typed reads are checked against
+ *             getValue().
+ *
+ *             Usage: FieldAccessBenchmark [rounds]
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+
+enum AccessType { GET_VALUE, GET_TYPED, COPY_ELEMENTS, SET_VALUE, SET_TYPED };
+
+static QList<UAVObjectField *> fields;
+static qint64 elements;
+static volatile double sink;
+
+// Returns the sum of the values read, so the reads are not optimized away
+static double access(AccessType type, int rounds)
+{
+    double sum = 0;
+    QVector<double> buffer;
+
+    for (int round = 0; round < rounds; round++) {
+        foreach(UAVObjectField * field, fields) {
+            quint32 count = field->getNumElements();
+
+            switch (type) {
+            case GET_VALUE:
+                for (quint32 i = 0; i < count; i++) {
+                    sum += field->getValue(i).toDouble();
+                }
+                break;
+            case GET_TYPED:
+                for (quint32 i = 0; i < count; i++) {
+                    sum += field->get<double>(i);
+                }
+                break;
+            case COPY_ELEMENTS:
+                buffer.resize(count);
+                field->copyElements(buffer.data());
+                for (quint32 i = 0; i < count; i++) {
+                    sum += buffer[i];
+                }
+                break;
+            case SET_VALUE:
+                for (quint32 i = 0; i < count; i++) {
+                    field->setValue(QVariant((double)round), i);
+                }
+                break;
+            case SET_TYPED:
+                for (quint32 i = 0; i < count; i++) {
+                    field->set<double>(i, round);
+                }
+                break;
+            }
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int rounds = argc > 1 ? QString(argv[1]).toInt() : 1000;
+
+    UAVObjectManager *objManager = new UAVObjectManager();
+    UAVObjectsInitialize(objManager);
+    foreach(QList<UAVObject *> instances, objManager->getObjects()) {
+        foreach(UAVObject * obj, instances) {
+            foreach(UAVObjectField * field, obj->getFields()) {
+                // enums read as option names through getValue(), strings are not numbers
+                if (field->isNumeric()) {
+                    fields.append(field);
+                    elements += field->getNumElements();
+                }
+            }
+        }
+    }
+    out << fields.size() << " numeric fields, " << elements << " elements" << endl;
+
+    // the typed reads must match the QVariant ones, on the default values
+    int mismatches = 0;
+    foreach(UAVObjectField * field, fields) {
+        for (quint32 i = 0; i < field->getNumElements(); i++) {
+            if (field->get<double>(i) != field->getValue(i).toDouble()) {
+                mismatches++;
+            }
+        }
+    }
+    out << mismatches << " elements read differently by get<double>() and getValue()" << endl;
+
+    QElapsedTimer timer;
+    qint64 accesses = (qint64)rounds * elements;
+    const char *labels[] = {
+        "getValue().toDouble(): ",
+        "get<double>():         ",
+        "copyElements():        ",
+        "setValue():            ",
+        "set<double>():         "
+    };
+    foreach(AccessType type, QList<AccessType>() << GET_VALUE << GET_TYPED << COPY_ELEMENTS << SET_VALUE << SET_TYPED) {
+        timer.start();
+        sink = access(type, rounds);
+        out << labels[type] << QString::number(timer.nsecsElapsed() / (double)accesses, 'f', 1) << " ns/element" << endl;
+    }
+
+    delete objManager;
+    return 0;
+}
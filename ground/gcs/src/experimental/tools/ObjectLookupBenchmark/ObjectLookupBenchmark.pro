@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Lookups/s of the UAVObjectManager hash indices over every generated
+# object, from one and from several threads, compared with a linear
+# scan of the object list
+#
+#-------------------------------------------------
+
+TARGET = ObjectLookupBenchmark
+QT -= gui
+QT += concurrent
+
+include(../gcsbenchmark.pri)
+include(../../../plugins/uavobjects/uavobjects.pri)
+
+SOURCES += main.cpp
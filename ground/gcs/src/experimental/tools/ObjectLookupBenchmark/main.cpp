@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Lookup time of UAVObjectManager over every generated object, by
+ *             name and by object ID. Compares a linear scan of the object
+ *             list comparing names, as getObject() used to, with the hash
+ *             indices, from one thread and from all cores at once.
+ *
+ *             Usage: ObjectLookupBenchmark [rounds]
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QTextStream>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+
+enum LookupType { BY_NAME, BY_ID };
+
+static UAVObjectManager *objManager;
+static QStringList names;
+static QList<quint32> ids;
+
+// getObject() before the hash indices
+static UAVObject *linearLookup(const QList< QList<UAVObject *> > &objects, const QString &name)
+{
+    foreach(QList<UAVObject *> instances, objects) {
+        if (instances[0]->getName().compare(name) == 0) {
+            return instances[0];
+        }
+    }
+    return 0;
+}
+
+// Returns the number of objects found, so the lookups are not optimized away
+static int lookup(LookupType type, int rounds)
+{
+    int found = 0;
+
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < ids.size(); i++) {
+            UAVObject *obj = (type == BY_NAME) ? objManager->getObject(names.at(i)) : objManager->getObject(ids.at(i));
+            if (obj) {
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int rounds = argc > 1 ? QString(argv[1]).toInt() : 1000;
+
+    objManager = new UAVObjectManager();
+    UAVObjectsInitialize(objManager);
+    QList< QList<UAVObject *> > objects = objManager->getObjects();
+    foreach(QList<UAVObject *> instances, objects) {
+        names.append(instances[0]->getName());
+        ids.append(instances[0]->getObjID());
+    }
+    qint64 lookups = (qint64)rounds * ids.size();
+    out << ids.size() << " objects, metaobjects included" << endl;
+
+    QElapsedTimer timer;
+    int found = 0;
+    timer.start();
+    for (int round = 0; round < rounds; round++) {
+        foreach(const QString &name, names) {
+            if (linearLookup(objects, name)) {
+                found++;
+            }
+        }
+    }
+    out << "linear scan by name: " << QString::number(timer.nsecsElapsed() / (double)lookups, 'f', 1)
+        << " ns/lookup" << (found == lookups ? "" : ", objects missing") << endl;
+
+    int threads = QThread::idealThreadCount();
+    foreach(LookupType type, QList<LookupType>() << BY_NAME << BY_ID) {
+        const char *label = (type == BY_NAME) ? "by name" : "by ID  ";
+
+        timer.start();
+        found = lookup(type, rounds);
+        out << "index " << label << ", 1 thread:   " << QString::number(timer.nsecsElapsed() / (double)lookups, 'f', 1)
+            << " ns/lookup" << (found == lookups ? "" : ", objects missing") << endl;
+
+        // the lookups only take the read lock, they should scale with the threads
+        QList< QFuture<int> > futures;
+        timer.start();
+        for (int i = 0; i < threads; i++) {
+            futures.append(QtConcurrent::run(lookup, type, rounds));
+        }
+        found = 0;
+        foreach(QFuture<int> future, futures) {
+            found += future.result();
+        }
+        out << "index " << label << ", " << threads << " threads: "
+            << QString::number(timer.nsecsElapsed() / (double)(lookups * threads), 'f', 1)
+            << " ns/lookup" << (found == lookups * threads ? "" : ", objects missing") << endl;
+    }
+
+    delete objManager;
+    return 0;
+}
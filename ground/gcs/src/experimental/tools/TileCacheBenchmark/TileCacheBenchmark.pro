@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Tiles/s of the opmapcontrol SQLite tile cache, one connection per call
+# with a rollback journal compared with the per thread WAL connections,
+# with and without batched writes, and reads while tiles are written
+#
+#-------------------------------------------------
+
+TARGET = TileCacheBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QT += sql concurrent
+
+OPMAP_CORE = ../../../libs/opmapcontrol/src/core
+INCLUDEPATH += $$OPMAP_CORE
+
+SOURCES += main.cpp \
+    $$OPMAP_CORE/pureimagecache.cpp \
+    $$OPMAP_CORE/point.cpp
+
+HEADERS += $$OPMAP_CORE/pureimagecache.h \
+    $$OPMAP_CORE/maptype.h
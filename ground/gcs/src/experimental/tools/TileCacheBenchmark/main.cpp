@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Tiles/s of the map tile cache database. Compares a connection
+ *             opened per call with a rollback journal, as PureImageCache
+ *             used to work, with its per thread WAL connections, writing one
+ *             tile per transaction and batches as the TileCacheQueue does.
+ *             Reads are measured alone and while a thread writes tiles.
+ *
+ *             Usage: TileCacheBenchmark [tiles] [reader threads]
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "pureimagecache.h"
+
+using namespace core;
+
+#define TILE_BYTES 20000 // a typical 256x256 PNG tile
+#define BATCH_SIZE 64 // MAX_BATCH_SIZE of the TileCacheQueue
+
+static const MapType::Types TILE_TYPE = MapType::GoogleSatellite;
+
+static QByteArray tile(TILE_BYTES, 'x');
+static qlonglong connectionId;
+
+// PutImageToCache() before the per thread connections
+static bool oldPut(const QString &db, const Point &pos, int zoom)
+{
+    QString name = QString("old%1").arg(++connectionId);
+    bool ret     = false;
+    {
+        QSqlDatabase cn = QSqlDatabase::addDatabase("QSQLITE", name);
+        cn.setDatabaseName(db);
+        cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
+        if (cn.open()) {
+            {
+                QSqlQuery query(cn);
+                query.prepare("INSERT INTO Tiles(X, Y, Zoom, Type,Date) VALUES(?, ?, ?, ?,?)");
+                query.addBindValue(pos.X());
+                query.addBindValue(pos.Y());
+                query.addBindValue(zoom);
+                query.addBindValue((int)TILE_TYPE);
+                query.addBindValue(QDateTime::currentDateTime().toString());
+                query.exec();
+            }
+            {
+                QSqlQuery query(cn);
+                query.prepare("INSERT INTO TilesData(id, Tile) VALUES((SELECT last_insert_rowid()), ?)");
+                query.addBindValue(tile);
+                ret = query.exec();
+            }
+            cn.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    return ret;
+}
+
+// GetImageFromCache() before the per thread connections
+static QByteArray oldGet(const QString &db, const Point &pos, int zoom)
+{
+    QString name = QString("old%1").arg(++connectionId);
+    QByteArray ar;
+    {
+        QSqlDatabase cn = QSqlDatabase::addDatabase("QSQLITE", name);
+        cn.setDatabaseName(db);
+        cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
+        if (cn.open()) {
+            {
+                QSqlQuery query(cn);
+                query.exec(QString("SELECT Tile FROM TilesData WHERE id = (SELECT id FROM Tiles WHERE X=%1 AND Y=%2 AND Zoom=%3 AND Type=%4)")
+                           .arg(pos.X()).arg(pos.Y()).arg(zoom).arg((int)TILE_TYPE));
+                if (query.next()) {
+                    ar = query.value(0).toByteArray();
+                }
+            }
+            cn.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    return ar;
+}
+
+// Writes the tiles [first, first + count) of a zoom level, batch 1 is one transaction per tile
+static int put(PureImageCache *cache, int zoom, int first, int count, int batch)
+{
+    int written = 0;
+
+    for (int i = first; i < first + count; i += batch) {
+        if (batch > 1) {
+            cache->BeginTransaction();
+        }
+        for (int j = i; j < qMin(i + batch, first + count); j++) {
+            if (cache->PutImageToCache(tile, TILE_TYPE, Point(j, j), zoom)) {
+                written++;
+            }
+        }
+        if (batch > 1) {
+            cache->CommitTransaction();
+        }
+    }
+    return written;
+}
+
+// Returns the number of tiles found
+static int get(PureImageCache *cache, int zoom, int count)
+{
+    int found = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (cache->GetImageFromCache(TILE_TYPE, Point(i, i), zoom).size() == TILE_BYTES) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static QString rate(int tiles, qint64 nsecs)
+{
+    return QString::number(tiles / (qMax(nsecs, (qint64)1) / 1e9), 'f', 0) + " tiles/s";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int tiles   = argc > 1 ? QString(argv[1]).toInt() : 500;
+    int readers = argc > 2 ? QString(argv[2]).toInt() : 4;
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "unable to create a temporary directory" << endl;
+        return 1;
+    }
+    out << tiles << " tiles of " << TILE_BYTES << " bytes, cache in " << dir.path() << endl;
+
+    QElapsedTimer timer;
+    int done;
+
+    // a database of its own, the WAL mode stays with a database once set
+    QString oldDb = dir.path() + "/Old.qmdb";
+    PureImageCache::CreateEmptyDB(oldDb);
+    timer.start();
+    done = 0;
+    for (int i = 0; i < tiles; i++) {
+        done += oldPut(oldDb, Point(i, i), 1) ? 1 : 0;
+    }
+    out << "connection per call, write:     " << rate(done, timer.nsecsElapsed()) << endl;
+    timer.start();
+    done = 0;
+    for (int i = 0; i < tiles; i++) {
+        done += oldGet(oldDb, Point(i, i), 1).size() == TILE_BYTES ? 1 : 0;
+    }
+    out << "connection per call, read:      " << rate(done, timer.nsecsElapsed()) << endl;
+
+    PureImageCache cache;
+    cache.setGtileCache(dir.path() + "/");
+
+    timer.start();
+    done = put(&cache, 1, 0, tiles, 1);
+    out << "WAL, one tile per transaction:  " << rate(done, timer.nsecsElapsed()) << endl;
+    timer.start();
+    done = put(&cache, 2, 0, tiles, BATCH_SIZE);
+    out << "WAL, " << BATCH_SIZE << " tiles per transaction: " << rate(done, timer.nsecsElapsed()) << endl;
+    timer.start();
+    done = get(&cache, 2, tiles);
+    out << "WAL, read:                      " << rate(done, timer.nsecsElapsed()) << endl;
+
+    // the readers should not wait for the batches being written
+    timer.start();
+    QFuture<int> writer = QtConcurrent::run(put, &cache, 3, 0, tiles, BATCH_SIZE);
+    QList< QFuture<int> > futures;
+    for (int i = 0; i < readers; i++) {
+        futures.append(QtConcurrent::run(get, &cache, 2, tiles));
+    }
+    done = 0;
+    foreach(QFuture<int> future, futures) {
+        done += future.result();
+    }
+    qint64 readTime = timer.nsecsElapsed();
+    int written     = writer.result();
+    out << "WAL, " << readers << " readers during writes:  " << rate(done, readTime)
+        << ", writer " << rate(written, timer.nsecsElapsed()) << endl;
+
+    return 0;
+}
@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# Tiles/s of the opmapcontrol TileFetcher against a local stand-in
+# tile server with configurable latency, compared with one network
+# access manager per tile
+#
+#-------------------------------------------------
+
+TARGET = TileFetchBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QT -= gui
+QT += network
+
+OPMAP_CORE = ../../../libs/opmapcontrol/src/core
+INCLUDEPATH += $$OPMAP_CORE
+
+SOURCES += main.cpp \
+    tileserver.cpp \
+    $$OPMAP_CORE/tilefetcher.cpp \
+    $$OPMAP_CORE/rawtile.cpp \
+    $$OPMAP_CORE/point.cpp \
+    $$OPMAP_CORE/size.cpp
+
+HEADERS += tileserver.h \
+    loader.h \
+    $$OPMAP_CORE/tilefetcher.h \
+    $$OPMAP_CORE/maptype.h
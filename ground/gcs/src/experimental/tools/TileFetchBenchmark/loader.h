@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ *
+ * @file       loader.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Stand-in for the map loader threads, downloads tiles either
+ *             through a shared TileFetcher or with a network access
+ *             manager per tile, like OPMaps::GetImageFrom() used to
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QEventLoop>
+#include <QUrl>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include "tilefetcher.h"
+
+using namespace core;
+
+class Loader : public QThread {
+public:
+    Loader(TileFetcher *fetcher, quint16 port, int tiles, QAtomicInt *next, QAtomicInt *received)
+        : fetcher(fetcher), port(port), tiles(tiles), next(next), received(received) {}
+
+protected:
+    void run()
+    {
+        int i;
+
+        // every tile is asked for twice in a row, like the same tile
+        // requested again by a map that was scrolled back and forth
+        while ((i = next->fetchAndAddOrdered(1)) < tiles) {
+            RawTile tile(MapType::GoogleMap, Point(i / 2, 0), 17);
+            QNetworkRequest request(QUrl(QString("http://127.0.0.1:%1/tile/%2").arg(port).arg(i / 2)));
+            QByteArray data;
+
+            if (fetcher) {
+                fetcher->Get(tile, request, 30000, data);
+            } else {
+                QNetworkAccessManager network;
+                QNetworkReply *reply = network.get(request);
+                QEventLoop loop;
+                connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+                loop.exec();
+                if (reply->error() == QNetworkReply::NoError) {
+                    data = reply->readAll();
+                }
+                delete reply;
+            }
+            if (!data.isEmpty()) {
+                received->ref();
+            }
+        }
+    }
+
+private:
+    TileFetcher *fetcher;
+    quint16 port;
+    int tiles;
+    QAtomicInt *next;
+    QAtomicInt *received;
+};
+
+#endif // LOADER_H
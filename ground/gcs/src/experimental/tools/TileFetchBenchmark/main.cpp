@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Tiles/s of the map tile download against a local stand-in
+ *             tile server with a configurable latency.
+ *
+ *             Usage: TileFetchBenchmark [tiles] [latency ms] [loader threads]
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QList>
+#include <QTextStream>
+#include <QTimer>
+
+#include "tileserver.h"
+#include "loader.h"
+
+#define TILE_BYTES 20000 // a typical 256x256 PNG tile
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int tiles   = argc > 1 ? QString(argv[1]).toInt() : 400;
+    int latency = argc > 2 ? QString(argv[2]).toInt() : 50;
+    int threads = argc > 3 ? QString(argv[3]).toInt() : 10;
+
+    out << tiles << " tiles, " << latency << " ms latency, " << threads << " loader threads" << endl;
+
+    for (int pass = 0; pass < 2; pass++) {
+        TileServer server(latency, TILE_BYTES);
+        if (!server.listen(QHostAddress::LocalHost)) {
+            out << "listen failed: " << server.errorString() << endl;
+            return 1;
+        }
+        TileFetcher *fetcher = (pass == 1) ? new TileFetcher() : 0;
+        QAtomicInt next(0);
+        QAtomicInt received(0);
+        QList<Loader *> loaders;
+
+        // the server runs in this thread, keep its event loop going until
+        // all loaders are done
+        QEventLoop loop;
+        QTimer poll;
+        QObject::connect(&poll, SIGNAL(timeout()), &loop, SLOT(quit()));
+        poll.start(50);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < threads; i++) {
+            Loader *loader = new Loader(fetcher, server.serverPort(), tiles, &next, &received);
+            QObject::connect(loader, SIGNAL(finished()), &loop, SLOT(quit()));
+            loaders.append(loader);
+            loader->start();
+        }
+        bool running = true;
+        while (running) {
+            loop.exec();
+            running = false;
+            foreach(Loader * loader, loaders) {
+                running |= !loader->isFinished();
+            }
+        }
+        qint64 elapsed = timer.elapsed();
+
+        out << (fetcher ? "shared fetcher:      " : "manager per tile:    ")
+            << received.load() << " tiles in " << elapsed << " ms, "
+            << QString::number(received.load() * 1000.0 / qMax(elapsed, (qint64)1), 'f', 1) << " tiles/s, "
+            << server.Requests() << " requests on " << server.Connections() << " connections";
+        if (fetcher) {
+            out << ", " << fetcher->GetStatistics().coalesced << " coalesced";
+        }
+        out << endl;
+
+        qDeleteAll(loaders);
+        delete fetcher;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tileserver.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Minimal HTTP/1.1 tile server answering every request with
+ *             the same tile after a fixed latency
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "tileserver.h"
+#include <QTimer>
+
+TileServer::TileServer(int latency, int tileSize) : latency(latency), connections(0), requests(0)
+{
+    QByteArray tile(tileSize, 'x');
+
+    response  = "HTTP/1.1 200 OK\r\n"
+                "Content-Type: image/png\r\n"
+                "Connection: keep-alive\r\n"
+                "Content-Length: " + QByteArray::number(tile.size()) + "\r\n\r\n";
+    response += tile;
+}
+
+void TileServer::incomingConnection(qintptr socketDescriptor)
+{
+    QTcpSocket *socket = new QTcpSocket(this);
+
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+    ++connections;
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readRequests()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(disconnected()));
+}
+
+void TileServer::readRequests()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray &buffer = received[socket];
+    int end;
+
+    buffer += socket->readAll();
+    // GET requests have no body, a request ends with an empty line
+    while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+        buffer.remove(0, end + 4);
+        ++requests;
+        waiting.enqueue(socket);
+        QTimer::singleShot(latency, this, SLOT(respond()));
+    }
+}
+
+void TileServer::respond()
+{
+    QPointer<QTcpSocket> socket = waiting.dequeue();
+
+    if (socket) {
+        socket->write(response);
+    }
+}
+
+void TileServer::disconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+
+    received.remove(socket);
+    socket->deleteLater();
+}
@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tileserver.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Minimal HTTP/1.1 tile server answering every request with
+ *             the same tile after a fixed latency
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef TILESERVER_H
+#define TILESERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QPointer>
+#include <QQueue>
+#include <QHash>
+
+class TileServer : public QTcpServer {
+    Q_OBJECT
+public:
+    TileServer(int latency, int tileSize);
+
+    int Connections() const
+    {
+        return connections;
+    }
+    int Requests() const
+    {
+        return requests;
+    }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor);
+
+private slots:
+    void readRequests();
+    void respond();
+    void disconnected();
+
+private:
+    int latency; // ms
+    QByteArray response;
+    int connections;
+    int requests;
+    QHash<QTcpSocket *, QByteArray> received;
+    // sockets waiting for a response, in the order the requests came in,
+    // all responses have the same latency so timers fire in that order too
+    QQueue<QPointer<QTcpSocket> > waiting;
+};
+
+#endif // TILESERVER_H
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Paint time of the opmapcontrol tile layer on a synthetic tile set,
+# decoding every tile on every frame versus blitting decoded tiles
+#
+#-------------------------------------------------
+
+TARGET = TilePaintBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OPMAP_CORE = ../../../libs/opmapcontrol/src/core
+INCLUDEPATH += $$OPMAP_CORE
+
+SOURCES += main.cpp \
+    $$OPMAP_CORE/pureimage.cpp \
+    $$OPMAP_CORE/decodedtilecache.cpp \
+    $$OPMAP_CORE/rawtile.cpp \
+    $$OPMAP_CORE/point.cpp \
+    $$OPMAP_CORE/size.cpp
+
+HEADERS += $$OPMAP_CORE/maptype.h
@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Paint time of the map tile layer on a synthetic tile set.
+ *             Compares decoding every tile on every frame, as
+ *             MapGraphicItem::DrawMap2D used to, with blitting tiles
+ *             decoded once into a DecodedTileCache.
+ *
+ *             Usage: TilePaintBenchmark [frames] [width] [height]
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QGuiApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QList>
+#include <QPainter>
+#include <QTextStream>
+
+#include "pureimage.h"
+#include "decodedtilecache.h"
+#include "rawtile.h"
+
+#define TILE_SIZE  256
+#define TILE_COUNT 16 // synthetic tiles per side
+
+using namespace core;
+
+// A tile with some structure so the PNG encoder does not collapse it
+static QByteArray makeTile(int x, int y, bool labels)
+{
+    QImage image(TILE_SIZE, TILE_SIZE, labels ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    QPainter painter(&image);
+
+    if (labels) {
+        image.fill(Qt::transparent);
+        painter.setPen(QColor(40, 40, 40, 200));
+        for (int i = 0; i < 12; i++) {
+            painter.drawLine((x * 37 + i * 53) % TILE_SIZE, 0, (y * 29 + i * 71) % TILE_SIZE, TILE_SIZE);
+        }
+    } else {
+        QLinearGradient gradient(0, 0, TILE_SIZE, TILE_SIZE);
+        gradient.setColorAt(0, QColor::fromHsv((x * 23) % 360, 80, 220));
+        gradient.setColorAt(1, QColor::fromHsv((y * 41) % 360, 120, 160));
+        painter.fillRect(image.rect(), gradient);
+        for (int i = 0; i < TILE_SIZE; i += 8) {
+            painter.setPen(QColor::fromHsv((i + x * y) % 360, 60, 200));
+            painter.drawEllipse(QPoint((i * 7 + x) % TILE_SIZE, (i * 13 + y) % TILE_SIZE), i % 40, i % 30);
+        }
+    }
+    painter.end();
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return data;
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int frames = argc > 1 ? QString(argv[1]).toInt() : 100;
+    int width  = argc > 2 ? QString(argv[2]).toInt() : 1920;
+    int height = argc > 3 ? QString(argv[3]).toInt() : 1080;
+
+    // two layers per tile, like the hybrid map types
+    QList<QByteArray> base;
+    QList<QByteArray> labels;
+    for (int y = 0; y < TILE_COUNT; y++) {
+        for (int x = 0; x < TILE_COUNT; x++) {
+            base.append(makeTile(x, y, false));
+            labels.append(makeTile(x, y, true));
+        }
+    }
+
+    QImage target(width, height, QImage::Format_ARGB32_Premultiplied);
+    int columns = width / TILE_SIZE + 2;
+    int rows    = height / TILE_SIZE + 2;
+    DecodedTileCache cache;
+    QElapsedTimer timer;
+
+    // every frame pans by a few pixels, crossing into new tiles now and then
+    for (int pass = 0; pass < 2; pass++) {
+        bool decoded = (pass == 1);
+        qint64 decodeTime = 0;
+        timer.start();
+        for (int frame = 0; frame < frames; frame++) {
+            QPainter painter(&target);
+            int panX = frame * 7;
+            int panY = frame * 3;
+            for (int j = 0; j < rows; j++) {
+                for (int i = 0; i < columns; i++) {
+                    int tx    = (i + panX / TILE_SIZE) % TILE_COUNT;
+                    int ty    = (j + panY / TILE_SIZE) % TILE_COUNT;
+                    QRect rect(i * TILE_SIZE - panX % TILE_SIZE, j * TILE_SIZE - panY % TILE_SIZE, TILE_SIZE, TILE_SIZE);
+                    int index = ty * TILE_COUNT + tx;
+                    if (decoded) {
+                        RawTile baseTile(MapType::GoogleSatellite, Point(tx, ty), 0);
+                        RawTile labelTile(MapType::GoogleLabels, Point(tx, ty), 0);
+                        QImage img = cache.Get(baseTile);
+                        if (img.isNull()) {
+                            // done by the loader threads in the map widget
+                            QElapsedTimer decode;
+                            decode.start();
+                            cache.Add(baseTile, PureImageProxy::Decode(base.at(index)));
+                            cache.Add(labelTile, PureImageProxy::Decode(labels.at(index)));
+                            decodeTime += decode.nsecsElapsed();
+                            img = cache.Get(baseTile);
+                        }
+                        painter.drawImage(rect, img);
+                        painter.drawImage(rect, cache.Get(labelTile));
+                    } else {
+                        painter.drawPixmap(rect, PureImageProxy::FromStream(base.at(index)));
+                        painter.drawPixmap(rect, PureImageProxy::FromStream(labels.at(index)));
+                    }
+                }
+            }
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+        out << (decoded ? "decoded once:      " : "decoded per frame: ")
+            << QString::number((elapsed - decodeTime) / 1e6 / frames, 'f', 3) << " ms/frame";
+        if (decoded) {
+            out << ", " << QString::number(decodeTime / 1e6, 'f', 1) << " ms decoding, "
+                << QString::number(cache.MemoryCacheSize(), 'f', 1) << " MB cached";
+        }
+        out << endl;
+    }
+    return 0;
+}
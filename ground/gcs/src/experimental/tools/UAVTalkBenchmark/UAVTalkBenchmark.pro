@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# Parse throughput of UAVTalk on a stream of every generated object,
+# handed to processInputStream() in blocks of different sizes
+#
+#-------------------------------------------------
+
+TARGET = UAVTalkBenchmark
+QT -= gui
+QT += network
+
+include(../gcsbenchmark.pri)
+include(../../../plugins/uavtalk/uavtalk.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,148 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Parse throughput of UAVTalk on a stream holding every generated
+ *             object. The stream is handed to processInputStream() in blocks
+ *             of 1 byte, as the parser used to read it, up to the blocks of a
+ *             log replay.
+ *
+ *             Usage: UAVTalkBenchmark [megabytes]
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <extensionsystem/pluginmanager.h>
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "uavtalk.h"
+
+// Makes the stream readable one block at a time, like a serial port does
+class StreamDevice : public QIODevice {
+public:
+    StreamDevice(const QByteArray &stream) : m_stream(stream), m_pos(0), m_end(0)
+    {
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    bool isSequential() const
+    {
+        return true;
+    }
+
+    qint64 bytesAvailable() const
+    {
+        return m_end - m_pos + QIODevice::bytesAvailable();
+    }
+
+    bool feed(qint64 size)
+    {
+        if (m_end >= m_stream.size()) {
+            return false;
+        }
+        m_end = qMin(m_end + size, (qint64)m_stream.size());
+        emit readyRead();
+        return true;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize)
+    {
+        qint64 size = qMin(maxSize, m_end - m_pos);
+
+        memcpy(data, m_stream.constData() + m_pos, size);
+        m_pos += size;
+        return size;
+    }
+
+    qint64 writeData(const char *, qint64)
+    {
+        return -1;
+    }
+
+private:
+    const QByteArray &m_stream;
+    qint64 m_pos;
+    qint64 m_end;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int megabytes = argc > 1 ? QString(argv[1]).toInt() : 4;
+
+    // UAVTalk looks up the Core settings through the plugin manager
+    ExtensionSystem::PluginManager pluginManager;
+    UAVObjectManager objManager;
+    UAVObjectsInitialize(&objManager);
+
+    // one packet per object instance, metaobjects included
+    QByteArray packets;
+    QBuffer buffer(&packets);
+    buffer.open(QIODevice::WriteOnly);
+    UAVTalk sender(&buffer, &objManager);
+    quint32 objectsPerPass = 0;
+    foreach(QList<UAVObject *> instances, objManager.getObjects()) {
+        foreach(UAVObject * obj, instances) {
+            sender.sendObject(obj, false, false);
+            objectsPerPass++;
+        }
+    }
+    buffer.close();
+
+    QByteArray stream;
+    quint32 objects = 0;
+    while (stream.size() < megabytes * 1024 * 1024) {
+        stream.append(packets);
+        objects += objectsPerPass;
+    }
+    out << objectsPerPass << " objects, " << packets.size() << " bytes per pass, "
+        << stream.size() << " bytes in total" << endl;
+
+    QElapsedTimer timer;
+    foreach(qint64 blockSize, QList<qint64>() << 1 << 16 << 256 << 4096 << 65536) {
+        StreamDevice device(stream);
+        UAVTalk receiver(&device, &objManager);
+        QObject::connect(&device, SIGNAL(readyRead()), &receiver, SLOT(processInputStream()));
+
+        timer.start();
+        while (device.feed(blockSize)) {
+            ;
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+
+        UAVTalk::ComStats stats = receiver.getStats();
+        out << "blocks of " << QString::number(blockSize).rightJustified(5) << " bytes: "
+            << QString::number(stream.size() / (elapsed / 1e9) / (1024 * 1024), 'f', 1) << " MB/s, "
+            << QString::number(stats.rxObjects / (elapsed / 1e9), 'f', 0) << " objects/s";
+        if (stats.rxObjects != objects || stats.rxErrors || stats.rxCrcErrors) {
+            out << " (" << stats.rxObjects << " of " << objects << " objects, "
+                << stats.rxErrors << " errors, " << stats.rxCrcErrors << " CRC errors)";
+        }
+        out << endl;
+    }
+    return 0;
+}
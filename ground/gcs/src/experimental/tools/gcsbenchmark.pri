@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Common settings of the benchmarks of GCS plugin code. They link the
+# libraries and plugins of a GCS build, point qmake at it with
+#   qmake GCS_BUILD_TREE=<GCS build directory> <benchmark>.pro
+#
+#-------------------------------------------------
+
+include(../../../gcs.pri)
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+LIBS += -L$$GCS_PLUGIN_PATH/$$ORG_BIG_NAME
+
+linux-* {
+    QMAKE_LFLAGS += -Wl,-rpath,$$GCS_LIBRARY_PATH -Wl,-rpath,$$GCS_PLUGIN_PATH/$$ORG_BIG_NAME
+}
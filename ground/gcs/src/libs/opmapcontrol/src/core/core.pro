@@ -16,6 +16,8 @@ SOURCES += opmaps.cpp \
     point.cpp \
     size.cpp \
     kibertilecache.cpp \
+    tilefetcher.cpp \
+    decodedtilecache.cpp \
     diagnostics.cpp
 HEADERS += opmaps.h \
     size.h \
@@ -36,6 +38,8 @@ HEADERS += opmaps.h \
     placemark.h \
     point.h \
     kibertilecache.h \
+    tilefetcher.h \
+    decodedtilecache.h \
     debugheader.h \
     diagnostics.h
 
@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ *
+ * @file       decodedtilecache.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Memory bounded LRU of decoded tile images
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   OPMapWidget
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "decodedtilecache.h"
+
+
+namespace core {
+DecodedTileCache::DecodedTileCache()
+{
+    images.setMaxCost(44 * 1024);
+}
+
+void DecodedTileCache::setMemoryCacheCapacity(const int &value)
+{
+    QMutexLocker locker(&mutex);
+
+    images.setMaxCost(value * 1024);
+}
+int DecodedTileCache::MemoryCacheCapacity()
+{
+    QMutexLocker locker(&mutex);
+
+    return images.maxCost() / 1024;
+}
+double DecodedTileCache::MemoryCacheSize()
+{
+    QMutexLocker locker(&mutex);
+
+    return images.totalCost() / 1024.0;
+}
+
+QImage DecodedTileCache::Get(const RawTile &tile)
+{
+    QMutexLocker locker(&mutex);
+    // object() also makes the tile the most recently used one
+    QImage *image = images.object(tile);
+
+    return image ? *image : QImage();
+}
+void DecodedTileCache::Add(const RawTile &tile, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+    QMutexLocker locker(&mutex);
+    // QCache evicts the least recently used images to make room
+    images.insert(tile, new QImage(image), qMax(1, image.byteCount() / 1024));
+#ifdef DEBUG_MEMORY_CACHE
+    qDebug() << "Decoded tiles=" << images.count() << " occupying " << images.totalCost() << " kB";
+#endif
+}
+void DecodedTileCache::Clear()
+{
+    QMutexLocker locker(&mutex);
+
+    images.clear();
+}
+}
@@ -0,0 +1,59 @@
+/**
+ ******************************************************************************
+ *
+ * @file       decodedtilecache.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Memory bounded LRU of decoded tile images
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   OPMapWidget
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef DECODEDTILECACHE_H
+#define DECODEDTILECACHE_H
+
+#include "rawtile.h"
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QDebug>
+#include "debugheader.h"
+namespace core {
+/**
+ * Tiles decoded by the loader threads, ready to be drawn without touching
+ * the PNG/JPEG bytes again. Kept next to the KiberTileCache of encoded
+ * tiles so a tile scrolled back into view is not decoded a second time.
+ * Images are accounted by their size in memory, least recently used
+ * images are dropped first.
+ */
+class DecodedTileCache {
+public:
+    DecodedTileCache();
+
+    void setMemoryCacheCapacity(const int &value);
+    int MemoryCacheCapacity();
+    double MemoryCacheSize();
+    QImage Get(const RawTile &tile);
+    void Add(const RawTile &tile, const QImage &image);
+    void Clear();
+private:
+    QMutex mutex;
+    QCache<RawTile, QImage> images; // cost in kB
+};
+}
+#endif // DECODEDTILECACHE_H
@@ -25,6 +25,7 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 #include "opmaps.h"
+#include "pureimage.h"
 
 
 namespace core {
@@ -99,16 +100,14 @@ QByteArray OPMaps::GetImageFrom(const MapType::Types &type, const Point &pos, co
             }
         }
         if (accessmode != AccessMode::CacheOnly) {
-            QNetworkReply *reply;
             QNetworkRequest qheader;
-            QNetworkAccessManager network;
             // This SSL Hack is half assed... technically bad *security* joojoo.
             // Required due to a QT5 bug on linux and Mac
             //
             QSslConfiguration conf = qheader.sslConfiguration();
             conf.setPeerVerifyMode(QSslSocket::VerifyNone);
             qheader.setSslConfiguration(conf);
-            network.setProxy(Proxy);
+            tileFetcher.setProxy(Proxy);
 #ifdef DEBUG_GMAPS
             qDebug() << "Try Tile from the Internet";
 #endif // DEBUG_GMAPS
@@ -185,27 +184,22 @@ QByteArray OPMaps::GetImageFrom(const MapType::Types &type, const Point &pos, co
             qDebug() << "Timeout is " << Timeout;
             qDebug() << "Get " << qheader.url();
 #endif // DEBUG_GMAPS
-            reply = network.get(qheader);
+            TileFetcher::Status status = tileFetcher.Get(RawTile(type, pos, zoom), qheader, Timeout * 6, ret);
 #ifdef DEBUG_GMAPS
-            qDebug() << "reply " << reply;
+            qDebug() << "Finished?" << status;
 #endif // DEBUG_GMAPS
-
-            QTime time;
-            while ((!(reply->isFinished()) || (time.elapsed() > (6 * Timeout)))) {
-                QCoreApplication::processEvents(QEventLoop::AllEvents);
-            }
-
-#ifdef DEBUG_GMAPS
-            qDebug() << "Finished?" << reply->error() << " abort?" << (time.elapsed() > Timeout * 6);
-#endif // DEBUG_GMAPS
-            // If you are seeing Error 6 here you are dealing with a QT SSL Bug!!!
-            if ((reply->error() != QNetworkReply::NoError) | (time.elapsed() > Timeout * 6)) {
-                qWarning() << "Reply error: " << reply->errorString() << qheader.url();
-                return ret;
+            if (status != TileFetcher::Ok) {
+                if (status != TileFetcher::Cancelled) {
+                    errorvars.lock();
+                    if (status == TileFetcher::TimedOut) {
+                        ++diag.timeouts;
+                    } else {
+                        ++diag.networkerrors;
+                    }
+                    errorvars.unlock();
+                }
+                return QByteArray();
             }
-            ret = reply->readAll();
-            // qDebug() << "ret " << ret;
-            reply->deleteLater(); // TODO can't this be global??
 
             if (ret.isEmpty()) {
 #ifdef DEBUG_GMAPS
@@ -243,6 +237,32 @@ QByteArray OPMaps::GetImageFrom(const MapType::Types &type, const Point &pos, co
     return ret;
 }
 
+/**
+ * Same as GetImageFrom() but returns the tile decoded, ready to be drawn.
+ * Decoded tiles are kept in DecodedTilesInMemory so the PNG/JPEG data of
+ * a tile is only decoded once as long as it stays in that cache.
+ */
+QImage OPMaps::GetDecodedImageFrom(const MapType::Types &type, const Point &pos, const int &zoom)
+{
+    QImage image;
+
+    if (useMemoryCache) {
+        image = DecodedTilesInMemory.Get(RawTile(type, pos, zoom));
+        if (!image.isNull()) {
+            return image;
+        }
+    }
+    QByteArray data = GetImageFrom(type, pos, zoom);
+    if (data.isEmpty()) {
+        return image;
+    }
+    image = PureImageProxy::Decode(data);
+    if (useMemoryCache) {
+        DecodedTilesInMemory.Add(RawTile(type, pos, zoom), image);
+    }
+    return image;
+}
+
 bool OPMaps::ExportToGMDB(const QString &file)
 {
     return Cache::Instance()->ImageCache.ExportMapDataToDB(Cache::Instance()->ImageCache.GtileCache() + QDir::separator() + "Data.qmdb", file);
@@ -259,6 +279,9 @@ diagnostics OPMaps::GetDiagnostics()
     errorvars.lock();
     i = diag;
     errorvars.unlock();
+    TileFetcher::Statistics stats = tileFetcher.GetStatistics();
+    i.tilesCoalesced = stats.coalesced;
+    i.tilesCancelled = stats.cancelled;
     return i;
 }
 }
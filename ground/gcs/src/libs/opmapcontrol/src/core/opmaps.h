@@ -36,6 +36,7 @@
 #include "languagetype.h"
 #include "cacheitemqueue.h"
 #include "tilecachequeue.h"
+#include "tilefetcher.h"
 #include "pureimagecache.h"
 #include "alllayersoftype.h"
 #include "urlfactory.h"
@@ -57,6 +58,7 @@ public: ~OPMaps();
 
 
     QByteArray GetImageFrom(const MapType::Types &type, const core::Point &pos, const int &zoom);
+    QImage GetDecodedImageFrom(const MapType::Types &type, const core::Point &pos, const int &zoom);
     bool UseMemoryCache()
     {
         return useMemoryCache;
@@ -83,6 +85,10 @@ public: ~OPMaps();
     }
     int RetryLoadTile;
     diagnostics GetDiagnostics();
+    void CancelTilesNotIn(const QVector<MapType::Types> &types, const int &zoom, const QList<core::Point> &keep)
+    {
+        tileFetcher.CancelNotIn(types, zoom, keep);
+    }
 
 private:
     bool useMemoryCache;
@@ -90,6 +96,7 @@ private:
     AccessMode::Types accessmode;
     // PureImageCache ImageCacheLocal;//TODO Criar acesso Get Set
     TileCacheQueue TileDBcacheQueue;
+    TileFetcher tileFetcher;
     OPMaps();
     OPMaps(OPMaps const &) {}
     OPMaps & operator=(OPMaps const &)
@@ -35,6 +35,19 @@ QPixmap PureImageProxy::FromStream(const QByteArray &array)
 {
     return QPixmap::fromImage(QImage::fromData(array));
 }
+/**
+ * Decode a tile in a format the raster paint engine blits without
+ * converting it first. Safe to call outside of the GUI thread.
+ */
+QImage PureImageProxy::Decode(const QByteArray &array)
+{
+    QImage image = QImage::fromData(array);
+
+    if (image.isNull()) {
+        return image;
+    }
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+}
 bool PureImageProxy::Save(const QByteArray &array, QPixmap &pic)
 {
     pic = QPixmap::fromImage(QImage::fromData(array));
@@ -28,6 +28,7 @@
 #define PUREIMAGE_H
 
 #include <QPixmap>
+#include <QImage>
 #include <QByteArray>
 
 
@@ -36,6 +37,7 @@ class PureImageProxy {
 public:
     PureImageProxy();
     static QPixmap FromStream(const QByteArray &array);
+    static QImage Decode(const QByteArray &array);
     static bool Save(const QByteArray &array, QPixmap &pic);
 };
 }
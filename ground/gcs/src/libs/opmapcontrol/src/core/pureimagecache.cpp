@@ -137,6 +137,14 @@ bool PureImageCache::CreateEmptyDB(const QString &file)
     if (query.numRowsAffected() == -1) {
 #ifdef DEBUG_PUREIMAGECACHE
         qDebug() << "CreateEmptyDB: " << query.lastError().driverText();
+#endif // DEBUG_PUREIMAGECACHE
+        db.close();
+        return false;
+    }
+    query.exec("CREATE INDEX IF NOT EXISTS IndexOfTiles ON Tiles (X, Y, Zoom, Type)");
+    if (query.lastError().isValid()) {
+#ifdef DEBUG_PUREIMAGECACHE
+        qDebug() << "CreateEmptyDB: " << query.lastError().driverText();
 #endif // DEBUG_PUREIMAGECACHE
         db.close();
         return false;
@@ -158,6 +166,78 @@ bool PureImageCache::CreateEmptyDB(const QString &file)
     QSqlDatabase::removeDatabase(QLatin1String("CreateConn"));
     return true;
 }
+/**
+ * Get the connection of the calling thread to the cache database, opening it
+ * with its prepared statements the first time or when the cache moved.
+ * Returns 0 when the database cannot be opened, the next call tries again.
+ * Must be called with lock held.
+ */
+PureImageCache::Connection *PureImageCache::connection()
+{
+    QString db = gtilecache + "Data.qmdb";
+    Connection *conn = connections.localData();
+
+    if (conn && conn->file == db) {
+        return conn;
+    }
+    // setLocalData() deletes the previous connection of this thread
+    connections.setLocalData(0);
+
+    Mcounter.lock();
+    qlonglong id = ++ConnCounter;
+    Mcounter.unlock();
+
+    conn = new Connection;
+    conn->name       = QString("PureImageCache%1").arg(id);
+    conn->file       = db;
+    conn->select     = 0;
+    conn->insertTile = 0;
+    conn->insertData = 0;
+    connections.setLocalData(conn);
+
+    QSqlDatabase cn = QSqlDatabase::addDatabase("QSQLITE", conn->name);
+    cn.setDatabaseName(db);
+    cn.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    if (!cn.open()) {
+#ifdef DEBUG_PUREIMAGECACHE
+        qDebug() << "connection: Unable to open " << db << cn.lastError().driverText();
+#endif // DEBUG_PUREIMAGECACHE
+        // drop the failed connection so the next call retries, cn must be
+        // released first for the destructor to remove the database
+        cn = QSqlDatabase();
+        connections.setLocalData(0);
+        return 0;
+    }
+    {
+        // WAL lets the tile loaders read while the cache queue writes
+        QSqlQuery query(cn);
+        query.exec("PRAGMA journal_mode=WAL");
+        query.exec("PRAGMA synchronous=NORMAL");
+        // caches created before the index existed
+        query.exec("CREATE INDEX IF NOT EXISTS IndexOfTiles ON Tiles (X, Y, Zoom, Type)");
+    }
+    conn->select     = new QSqlQuery(cn);
+    conn->select->prepare("SELECT Tile FROM TilesData WHERE id = (SELECT id FROM Tiles WHERE X=? AND Y=? AND Zoom=? AND Type=?)");
+    conn->insertTile = new QSqlQuery(cn);
+    conn->insertTile->prepare("INSERT INTO Tiles(X, Y, Zoom, Type, Date) VALUES(?, ?, ?, ?, ?)");
+    conn->insertData = new QSqlQuery(cn);
+    conn->insertData->prepare("INSERT INTO TilesData(id, Tile) VALUES(?, ?)");
+    return conn;
+}
+
+PureImageCache::Connection::~Connection()
+{
+    // the queries must be gone before the connection can be removed
+    delete select;
+    delete insertTile;
+    delete insertData;
+    {
+        QSqlDatabase cn = QSqlDatabase::database(name, false);
+        cn.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+}
+
 bool PureImageCache::PutImageToCache(const QByteArray &tile, const MapType::Types &type, const Point &pos, const int &zoom)
 {
     if (gtilecache.isEmpty() | gtilecache.isNull()) {
@@ -167,78 +247,75 @@ bool PureImageCache::PutImageToCache(const QByteArray &tile, const MapType::Type
 #ifdef DEBUG_PUREIMAGECACHE
     qDebug() << "PutImageToCache Start:"; // <<pos;
 #endif // DEBUG_PUREIMAGECACHE
-    Mcounter.lock();
-    qlonglong id = ++ConnCounter;
-    Mcounter.unlock();
-    {
-        QSqlDatabase cn;
-        cn = QSqlDatabase::addDatabase("QSQLITE", QString::number(id));
-        QString db = gtilecache + "Data.qmdb";
-        cn.setDatabaseName(db);
-        cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-        if (cn.open()) {
-            {
-                QSqlQuery query(cn);
-                query.prepare("INSERT INTO Tiles(X, Y, Zoom, Type,Date) VALUES(?, ?, ?, ?,?)");
-                query.addBindValue(pos.X());
-                query.addBindValue(pos.Y());
-                query.addBindValue(zoom);
-
-                query.addBindValue((int)type);
-                query.addBindValue(QDateTime::currentDateTime().toString());
-                query.exec();
-            }
-            {
-                QSqlQuery query(cn);
-                query.prepare("INSERT INTO TilesData(id, Tile) VALUES((SELECT last_insert_rowid()), ?)");
-                query.addBindValue(tile);
-                query.exec();
-            }
-            cn.close();
+    Connection *conn = connection();
+    bool ret = false;
+    if (conn) {
+        conn->insertTile->addBindValue(pos.X());
+        conn->insertTile->addBindValue(pos.Y());
+        conn->insertTile->addBindValue(zoom);
+        conn->insertTile->addBindValue((int)type);
+        conn->insertTile->addBindValue(QDateTime::currentDateTime().toString());
+        if (conn->insertTile->exec()) {
+            conn->insertData->addBindValue(conn->insertTile->lastInsertId());
+            conn->insertData->addBindValue(tile);
+            ret = conn->insertData->exec();
         }
     }
-    QSqlDatabase::removeDatabase(QString::number(id));
     lock.unlock();
-    return true;
+    return ret;
 }
-QByteArray PureImageCache::GetImageFromCache(MapType::Types type, Point pos, int zoom)
+
+/**
+ * Group the following PutImageToCache() calls of this thread in one
+ * transaction, it saves a disk sync per tile
+ */
+bool PureImageCache::BeginTransaction()
+{
+    if (gtilecache.isEmpty() | gtilecache.isNull()) {
+        return false;
+    }
+    lock.lockForRead();
+    Connection *conn = connection();
+    bool ret = conn && QSqlDatabase::database(conn->name, false).transaction();
+    lock.unlock();
+    return ret;
+}
+
+bool PureImageCache::CommitTransaction()
 {
+    if (gtilecache.isEmpty() | gtilecache.isNull()) {
+        return false;
+    }
     lock.lockForRead();
+    Connection *conn = connection();
+    bool ret = conn && QSqlDatabase::database(conn->name, false).commit();
+    lock.unlock();
+    return ret;
+}
+
+QByteArray PureImageCache::GetImageFromCache(MapType::Types type, Point pos, int zoom)
+{
     QByteArray ar;
+
     if (gtilecache.isEmpty() | gtilecache.isNull()) {
         return ar;
     }
-    QString dir  = gtilecache;
-    Mcounter.lock();
-    qlonglong id = ++ConnCounter;
-    Mcounter.unlock();
+    lock.lockForRead();
 #ifdef DEBUG_PUREIMAGECACHE
-    qDebug() << "Cache dir=" << dir << " Try to GET:" << pos.X() + "," + pos.Y();
+    qDebug() << "Cache dir=" << gtilecache << " Try to GET:" << pos.X() + "," + pos.Y();
 #endif // DEBUG_PUREIMAGECACHE
 
-    {
-        QString db = dir + "Data.qmdb";
-        {
-            QSqlDatabase cn;
-
-            cn = QSqlDatabase::addDatabase("QSQLITE", QString::number(id));
-
-            cn.setDatabaseName(db);
-            cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-            if (cn.open()) {
-                {
-                    QSqlQuery query(cn);
-                    query.exec(QString("SELECT Tile FROM TilesData WHERE id = (SELECT id FROM Tiles WHERE X=%1 AND Y=%2 AND Zoom=%3 AND Type=%4)").arg(pos.X()).arg(pos.Y()).arg(zoom).arg((int)type));
-                    query.next();
-                    if (query.isValid()) {
-                        ar = query.value(0).toByteArray();
-                    }
-                }
-                cn.close();
-            }
+    Connection *conn = connection();
+    if (conn) {
+        conn->select->addBindValue(pos.X());
+        conn->select->addBindValue(pos.Y());
+        conn->select->addBindValue(zoom);
+        conn->select->addBindValue((int)type);
+        if (conn->select->exec() && conn->select->next()) {
+            ar = conn->select->value(0).toByteArray();
         }
+        conn->select->finish();
     }
-    QSqlDatabase::removeDatabase(QString::number(id));
     lock.unlock();
     return ar;
 }
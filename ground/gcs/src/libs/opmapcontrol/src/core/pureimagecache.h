@@ -42,22 +42,38 @@
 #include <QList>
 #include <QMutex>
 #include <QReadWriteLock>
+#include <QThreadStorage>
 namespace core {
 class PureImageCache {
 public:
     PureImageCache();
     static bool CreateEmptyDB(const QString &file);
     bool PutImageToCache(const QByteArray &tile, const MapType::Types &type, const core::Point &pos, const int &zoom);
+    bool BeginTransaction();
+    bool CommitTransaction();
     QByteArray GetImageFromCache(MapType::Types type, core::Point pos, int zoom);
     QString GtileCache();
     void setGtileCache(const QString &value);
     static bool ExportMapDataToDB(QString sourceFile, QString destFile);
     void deleteOlderTiles(int const & days);
 private:
+    // Connection of one thread to the cache database, kept open until the thread ends
+    struct Connection {
+        QString name;
+        QString file;
+        QSqlQuery *select;
+        QSqlQuery *insertTile;
+        QSqlQuery *insertData;
+        ~Connection();
+    };
+
     QString gtilecache;
     QMutex Mcounter;
     QReadWriteLock lock;
+    QThreadStorage<Connection *> connections;
     static qlonglong ConnCounter;
+
+    Connection *connection();
 };
 }
 #endif // PUREIMAGECACHE_H
@@ -29,6 +29,9 @@
 
 // #define DEBUG_TILECACHEQUEUE
 
+// Most tiles written per transaction
+#define MAX_BATCH_SIZE 64
+
 namespace core {
 TileCacheQueue::TileCacheQueue()
 {}
@@ -76,15 +79,23 @@ void TileCacheQueue::run()
         qDebug() << "Cache";
 #endif // DEBUG_TILECACHEQUEUE
         if (tileCacheQueue.count() > 0) {
+            // Write everything queued so far in one transaction
+            QList<CacheItemQueue *> batch;
             mutex.lock();
-            task = tileCacheQueue.dequeue();
+            while (!tileCacheQueue.isEmpty() && batch.count() < MAX_BATCH_SIZE) {
+                batch.append(tileCacheQueue.dequeue());
+            }
             mutex.unlock();
+            Cache::Instance()->ImageCache.BeginTransaction();
+            foreach(task, batch) {
 #ifdef DEBUG_TILECACHEQUEUE
-            qDebug() << "Cache engine Put:" << task->GetPosition().X() << "," << task->GetPosition().Y();
+                qDebug() << "Cache engine Put:" << task->GetPosition().X() << "," << task->GetPosition().Y();
 #endif // DEBUG_TILECACHEQUEUE
-            Cache::Instance()->ImageCache.PutImageToCache(task->GetImg(), task->GetMapType(), task->GetPosition(), task->GetZoom());
+                Cache::Instance()->ImageCache.PutImageToCache(task->GetImg(), task->GetMapType(), task->GetPosition(), task->GetZoom());
+            }
+            Cache::Instance()->ImageCache.CommitTransaction();
+            qDeleteAll(batch);
             usleep(44);
-            delete task;
         } else {
 #ifdef DEBUG_TILECACHEQUEUE
             qDebug() << "Cache engine BEGIN WAIT";
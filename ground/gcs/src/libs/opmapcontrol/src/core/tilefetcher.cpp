@@ -0,0 +1,243 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tilefetcher.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Shared asynchronous HTTP fetcher of map tiles
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   OPMapWidget
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "tilefetcher.h"
+#include <QElapsedTimer>
+
+// #define DEBUG_TILEFETCHER
+
+namespace core {
+TileFetcher::TileFetcher() : network(0), proxyChanged(false)
+{
+    moveToThread(&thread);
+    // the network manager has to go away in the thread it lives in
+    connect(&thread, SIGNAL(finished()), this, SLOT(threadFinished()), Qt::DirectConnection);
+    thread.start();
+}
+TileFetcher::~TileFetcher()
+{
+    thread.quit();
+    thread.wait();
+}
+
+/**
+ * Download a tile, blocks until it arrived, failed, was cancelled or
+ * timeout ms passed. A request nobody waits for any more is cancelled.
+ * @param tile identifies the tile, requests for the same tile are coalesced
+ * @param request url and headers of the tile
+ * @param timeout in ms
+ * @param data set to the tile data if Ok is returned
+ */
+TileFetcher::Status TileFetcher::Get(const RawTile &tile, const QNetworkRequest &request, const int &timeout, QByteArray &data)
+{
+    QMutexLocker locker(&mutex);
+    RequestPtr r = inflight.value(tile);
+
+    if (r.isNull()) {
+        r = RequestPtr(new Request(tile, request));
+        inflight.insert(tile, r);
+        queued.append(r);
+        if (queued.count() == 1) {
+            QMetaObject::invokeMethod(this, "startQueued", Qt::QueuedConnection);
+        }
+    } else {
+        ++stats.coalesced;
+#ifdef DEBUG_TILEFETCHER
+        qDebug() << "TileFetcher: already downloading" << r->tile.ToString();
+#endif // DEBUG_TILEFETCHER
+    }
+    ++r->waiters;
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!r->done) {
+        qint64 left = timeout - timer.elapsed();
+        if (left <= 0) {
+            break;
+        }
+        finished.wait(&mutex, left);
+    }
+    --r->waiters;
+
+    if (!r->done) {
+        if (r->waiters == 0) {
+            cancel(r);
+        }
+        return TimedOut;
+    }
+    data = r->data;
+    return r->status;
+}
+
+/**
+ * Cancel the downloads of tiles of the given map types that are no longer
+ * in view, waiting loader threads return Cancelled.
+ * @param types map types the view is made of
+ * @param zoom zoom level of the view
+ * @param keep tiles in view
+ */
+void TileFetcher::CancelNotIn(const QVector<MapType::Types> &types, const int &zoom, const QList<core::Point> &keep)
+{
+    QMutexLocker locker(&mutex);
+    QList<RequestPtr> cancelled;
+
+    foreach(RequestPtr r, inflight) {
+        if (types.contains(r->tile.Type()) && (r->tile.Zoom() != zoom || !keep.contains(r->tile.Pos()))) {
+            cancelled.append(r);
+        }
+    }
+    foreach(RequestPtr r, cancelled) {
+        cancel(r);
+    }
+}
+
+void TileFetcher::setProxy(const QNetworkProxy &value)
+{
+    QMutexLocker locker(&mutex);
+
+    if (!(proxy == value)) {
+        proxy = value;
+        proxyChanged = true;
+    }
+}
+
+TileFetcher::Statistics TileFetcher::GetStatistics()
+{
+    QMutexLocker locker(&mutex);
+
+    return stats;
+}
+
+// call with mutex locked
+void TileFetcher::finish(const RequestPtr &request, Status status)
+{
+    request->status = status;
+    request->done   = true;
+    if (inflight.value(request->tile) == request) {
+        inflight.remove(request->tile);
+    }
+    finished.wakeAll();
+}
+
+// call with mutex locked, the reply is aborted later on the fetcher thread
+void TileFetcher::cancel(const RequestPtr &request)
+{
+    if (request->done) {
+        return;
+    }
+    request->cancelled = true;
+    ++stats.cancelled;
+    finish(request, Cancelled);
+    QMetaObject::invokeMethod(this, "abortCancelled", Qt::QueuedConnection);
+}
+
+void TileFetcher::startQueued()
+{
+    if (!network) {
+        network = new QNetworkAccessManager(this);
+    }
+
+    QList<RequestPtr> start;
+    mutex.lock();
+    foreach(RequestPtr r, queued) {
+        if (!r->cancelled) {
+            start.append(r);
+        }
+    }
+    queued.clear();
+    stats.requests += start.count();
+    if (proxyChanged) {
+        network->setProxy(proxy);
+        proxyChanged = false;
+    }
+    mutex.unlock();
+
+    foreach(RequestPtr r, start) {
+        QNetworkRequest request = r->request;
+        request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+        QNetworkReply *reply = network->get(request);
+        connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+        replies.insert(reply, r);
+#ifdef DEBUG_TILEFETCHER
+        qDebug() << "TileFetcher: get" << request.url();
+#endif // DEBUG_TILEFETCHER
+    }
+}
+
+void TileFetcher::abortCancelled()
+{
+    QList<QNetworkReply *> abort;
+
+    mutex.lock();
+    for (QHash<QNetworkReply *, RequestPtr>::const_iterator i = replies.constBegin(); i != replies.constEnd(); ++i) {
+        if (i.value()->cancelled) {
+            abort.append(i.key());
+        }
+    }
+    mutex.unlock();
+    // finished() is emitted right away, replyFinished() cleans up
+    foreach(QNetworkReply * reply, abort) {
+        reply->abort();
+    }
+}
+
+void TileFetcher::replyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+
+    if (!reply) {
+        return;
+    }
+    RequestPtr r = replies.take(reply);
+    reply->deleteLater();
+    if (r.isNull()) {
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+    if (r->done) {
+        // cancelled
+        return;
+    }
+    // If you are seeing Error 6 here you are dealing with a QT SSL Bug!!!
+    if (reply->error() != QNetworkReply::NoError) {
+        qWarning() << "Reply error: " << reply->errorString() << reply->url();
+        ++stats.failed;
+        finish(r, Failed);
+        return;
+    }
+    r->data = reply->readAll();
+    ++stats.completed;
+    finish(r, Ok);
+}
+
+void TileFetcher::threadFinished()
+{
+    delete network;
+    network = 0;
+    replies.clear();
+}
+}
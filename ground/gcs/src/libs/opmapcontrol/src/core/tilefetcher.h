@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tilefetcher.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @brief      Shared asynchronous HTTP fetcher of map tiles
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   OPMapWidget
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef TILEFETCHER_H
+#define TILEFETCHER_H
+
+#include "rawtile.h"
+#include "maptype.h"
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QSharedPointer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QDebug>
+#include "debugheader.h"
+
+namespace core {
+/**
+ * Downloads tiles of all map types with one long lived
+ * QNetworkAccessManager running the event loop of its own thread.
+ * Connections to a tile server are kept alive and shared by all tiles
+ * of that host, requests may be pipelined on them.
+ *
+ * Get() blocks the calling loader thread on a wait condition until the
+ * tile arrived. Loader threads asking for a tile that is already being
+ * downloaded wait for that request instead of starting a second one.
+ * Get() must not be called from the fetcher thread itself.
+ */
+class TileFetcher : public QObject {
+    Q_OBJECT
+public:
+    enum Status {
+        Ok,
+        Failed,
+        TimedOut,
+        Cancelled
+    };
+    struct Statistics {
+        Statistics() : requests(0), coalesced(0), completed(0), failed(0), cancelled(0) {}
+        quint64 requests; // requests sent to the servers
+        quint64 coalesced; // Get() calls served by a request already in flight
+        quint64 completed;
+        quint64 failed;
+        quint64 cancelled;
+    };
+
+    TileFetcher();
+    ~TileFetcher();
+
+    Status Get(const RawTile &tile, const QNetworkRequest &request, const int &timeout, QByteArray &data);
+    void CancelNotIn(const QVector<MapType::Types> &types, const int &zoom, const QList<core::Point> &keep);
+    void setProxy(const QNetworkProxy &value);
+    Statistics GetStatistics();
+
+private slots:
+    void startQueued();
+    void abortCancelled();
+    void replyFinished();
+    void threadFinished();
+
+private:
+    struct Request {
+        Request(const RawTile &tile, const QNetworkRequest &request)
+            : tile(tile), request(request), status(Ok), done(false), cancelled(false), waiters(0) {}
+        RawTile tile;
+        QNetworkRequest request;
+        QByteArray data;
+        Status status;
+        bool done;
+        bool cancelled;
+        int  waiters;
+    };
+    typedef QSharedPointer<Request> RequestPtr;
+
+    void finish(const RequestPtr &request, Status status);
+    void cancel(const RequestPtr &request);
+
+    QThread thread;
+    QNetworkAccessManager *network; // created in and only used by thread
+    QNetworkProxy proxy;
+    bool proxyChanged;
+
+    QMutex mutex; // protects everything below but replies
+    QWaitCondition finished;
+    QHash<RawTile, RequestPtr> inflight; // requests not done yet, by tile
+    QList<RequestPtr> queued; // requests not sent yet
+    Statistics stats;
+
+    QHash<QNetworkReply *, RequestPtr> replies; // fetcher thread only
+};
+}
+#endif // TILEFETCHER_H
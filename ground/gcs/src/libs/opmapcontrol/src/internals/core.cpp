@@ -34,12 +34,14 @@ using namespace projections;
 
 namespace internals {
 Core::Core() : MouseWheelZooming(false), currentPosition(0, 0), currentPositionPixel(0, 0), LastLocationInBounds(-1, -1), sizeOfMapArea(0, 0)
-    , minOfTiles(0, 0), maxOfTiles(0, 0), zoom(0), isDragging(false), TooltipTextPadding(10, 10), loaderLimit(5), maxzoom(21), runningThreads(0), started(false)
+    , minOfTiles(0, 0), maxOfTiles(0, 0), zoom(0), isDragging(false), TooltipTextPadding(10, 10), loaderLimit(12), maxzoom(21), runningThreads(0), started(false)
 {
     mousewheelzoomtype = MouseWheelZoomType::MousePositionAndCenter;
     SetProjection(new MercatorProjection());
     this->setAutoDelete(false);
-    ProcessLoadTaskCallback.setMaxThreadCount(10);
+    // loader threads waiting for the network only sleep on a wait condition,
+    // the downloads themselves share the connections of OPMaps' TileFetcher
+    ProcessLoadTaskCallback.setMaxThreadCount(16);
     renderOffset = Point(0, 0);
     dragPoint    = Point(0, 0);
     CanDragMap   = true;
@@ -109,22 +111,27 @@ void Core::run()
                             int retry = 0;
 
                             do {
-                                QByteArray img;
+                                QImage img;
+
+                                if (!IsInView(task)) {
+                                    // scrolled out of view while waiting
+                                    break;
+                                }
 
 #ifdef DEBUG_CORE
                                 qDebug() << "start getting image" << " ID=" << debug;
 #endif // DEBUG_CORE
-                                img = OPMaps::Instance()->GetImageFrom(tl, task.Pos, task.Zoom);
+                                img = OPMaps::Instance()->GetDecodedImageFrom(tl, task.Pos, task.Zoom);
 #ifdef DEBUG_CORE
-                                qDebug() << "Core::run:gotimage size:" << img.count() << " ID=" << debug << " time=" << t.elapsed();
+                                qDebug() << "Core::run:gotimage size:" << img.byteCount() << " ID=" << debug << " time=" << t.elapsed();
 #endif // DEBUG_CORE
 
-                                if (img.length() != 0) {
+                                if (!img.isNull()) {
                                     Moverlays.lock();
                                     {
                                         t->Overlays.append(img);
 #ifdef DEBUG_CORE
-                                        qDebug() << "Core::run append img:" << img.length() << " to tile:" << t->GetPos().ToString() << " now has " << t->Overlays.count() << " overlays" << " ID=" << debug;
+                                        qDebug() << "Core::run append img:" << img.byteCount() << " to tile:" << t->GetPos().ToString() << " now has " << t->Overlays.count() << " overlays" << " ID=" << debug;
 #endif // DEBUG_CORE
                                     }
                                     Moverlays.unlock();
@@ -528,6 +535,7 @@ void Core::UpdateBounds()
     MtileDrawingList.lock();
     {
         FindTilesAround(tileDrawingList);
+        OPMaps::Instance()->CancelTilesNotIn(OPMaps::Instance()->GetAllLayersOfType(GetMapType()), Zoom(), tileDrawingList);
 
 #ifdef DEBUG_CORE
         qDebug() << "OnTileLoadStart: " << tileDrawingList.count() << " tiles to load at zoom " << Zoom() << ", time: " << QDateTime::currentDateTime().date();
@@ -559,6 +567,12 @@ void Core::UpdateBounds()
     MtileDrawingList.unlock();
     UpdateGroundResolution();
 }
+bool Core::IsInView(const LoadTask &task)
+{
+    QMutexLocker locker(&MtileDrawingList);
+
+    return task.Zoom == Zoom() && tileDrawingList.contains(task.Pos);
+}
 void Core::FindTilesAround(QList<Point> &list)
 {
     list.clear();;
@@ -292,6 +292,8 @@ public:
 
     void FindTilesAround(QList<core::Point> &list);
 
+    bool IsInView(const LoadTask &task);
+
     void UpdateGroundResolution();
 
     TileMatrix Matrix;
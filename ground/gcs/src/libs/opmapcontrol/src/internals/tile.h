@@ -66,7 +66,8 @@ public:
     {
         return !(zoom == 0);
     }
-    QList<QByteArray> Overlays;
+    // decoded by the loader threads, painting only blits them
+    QList<QImage> Overlays;
 protected:
 
     QMutex mutex;
@@ -152,6 +152,27 @@ public:
         core::OPMaps::Instance()->TilesInMemory.setMemoryCacheCapacity(value);
     }
 
+    /**
+     * @brief  Returns the memory currently used for decoded tiles
+     *
+     * @return memory in Mb
+     */
+    double DecodedTileMemoryUsed() const
+    {
+        return core::OPMaps::Instance()->DecodedTilesInMemory.MemoryCacheSize();
+    }
+
+    /**
+     * @brief  Sets the size of the memory for decoded tiles, ready to be drawn
+     *
+     * @param  value size in Mb to use for decoded tiles
+     * @return
+     */
+    void SetDecodedTileMemorySize(int const & value)
+    {
+        core::OPMaps::Instance()->DecodedTilesInMemory.setMemoryCacheCapacity(value);
+    }
+
     /**
      * @brief Sets the location for the SQLite Database used for caching and the geocoding cache files
      *
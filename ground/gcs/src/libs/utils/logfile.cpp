@@ -1,6 +1,44 @@
 #include "logfile.h"
 #include <QDebug>
 #include <QtGlobal>
+#include <QHash>
+#include <QtConcurrent/QtConcurrentRun>
+
+// Every record is the timestamp, the packet size and the packet itself
+static const qint64 RECORD_HEADER_SIZE    = sizeof(quint32) + sizeof(qint64);
+static const qint64 MAX_RECORD_SIZE       = 1024 * 1024;
+static const qint64 MAX_RECORD_GAP_MS     = 60 * 60 * 1000;
+// Records hold complete UAVTalk packets: sync, type, length, object id and instance id
+static const int PACKET_HEADER_SIZE       = 10;
+static const quint8 PACKET_SYNC           = 0x3C;
+static const quint8 PACKET_TYPE_OBJ       = 0x20;
+static const quint8 PACKET_TYPE_OBJ_ACK   = 0x22;
+static const quint32 SNAPSHOT_INTERVAL_MS = 1000;
+static const qint64 INDEX_CHUNK_SIZE      = 1024 * 1024;
+// Bytes released per timer tick when replaying as fast as possible
+static const qint64 MAX_SPEED_CHUNK_SIZE  = 1024 * 1024;
+static const int THROUGHPUT_REPORT_MS     = 1000;
+
+/**
+ * Get the object instance updated by a logged packet.
+ * \return false if the packet does not carry object data
+ */
+static bool packetObjectKey(const char *packet, qint64 size, quint64 &key)
+{
+    if (size < PACKET_HEADER_SIZE || (quint8)packet[0] != PACKET_SYNC) {
+        return false;
+    }
+    quint8 type = (quint8)packet[1];
+    if (type != PACKET_TYPE_OBJ && type != PACKET_TYPE_OBJ_ACK) {
+        return false;
+    }
+    quint32 objId;
+    quint16 instId;
+    memcpy(&objId, packet + 4, sizeof(objId));
+    memcpy(&instId, packet + 8, sizeof(instId));
+    key = ((quint64)objId << 16) | instId;
+    return true;
+}
 
 LogFile::LogFile(QObject *parent) :
     QIODevice(parent),
@@ -9,9 +47,21 @@ LogFile::LogFile(QObject *parent) :
     m_timeOffset(0),
     m_playbackSpeed(1.0),
     m_nextTimeStamp(0),
-    m_useProvidedTimeStamp(false)
+    m_useProvidedTimeStamp(false),
+    m_replayStart(0),
+    m_replayEnd(0),
+    m_map(NULL),
+    m_mapSize(0),
+    m_mapPos(0),
+    m_mapReadPos(0),
+    m_mapReadyEnd(0),
+    m_maxSpeed(false),
+    m_throughputReported(0),
+    m_replayedBytes(0),
+    m_replayedPackets(0)
 {
     connect(&m_timer, SIGNAL(timeout()), this, SLOT(timerFired()));
+    connect(&m_indexWatcher, SIGNAL(finished()), this, SLOT(indexBuilt()));
 }
 
 /**
@@ -54,7 +104,13 @@ void LogFile::close()
     if (m_timer.isActive()) {
         m_timer.stop();
     }
+    // closing the file unmaps it, wait for the packets handed out to be processed
+    m_mapLock.lockForWrite();
+    m_map = NULL;
+    m_mapReadPos  = 0;
+    m_mapReadyEnd = 0;
     m_file.close();
+    m_mapLock.unlock();
     QIODevice::close();
 }
 
@@ -97,14 +153,30 @@ qint64 LogFile::bytesAvailable() const
 void LogFile::timerFired()
 {
     qint64 dataSize;
+    qint64 released = 0;
+
+    if (m_maxSpeed && !replayDrained()) {
+        // let the decoder catch up, nothing is buffered ahead of it
+        return;
+    }
+    if (m_maxSpeed && m_throughputTime.elapsed() - m_throughputReported >= THROUGHPUT_REPORT_MS) {
+        reportThroughput(false);
+    }
+    if (m_map) {
+        replayMapped();
+        return;
+    }
 
     if (m_file.bytesAvailable() > 4) {
         int time;
         time = m_myTime.elapsed();
 
-        // TODO: going back in time will be a problem
-        while ((m_lastPlayed + ((time - m_timeOffset) * m_playbackSpeed) > m_lastTimeStamp)) {
-            m_lastPlayed += ((time - m_timeOffset) * m_playbackSpeed);
+        while (replayDue(time, released)) {
+            if (m_maxSpeed) {
+                m_lastPlayed = m_lastTimeStamp;
+            } else {
+                m_lastPlayed += ((time - m_timeOffset) * m_playbackSpeed);
+            }
             if (m_file.bytesAvailable() < (qint64)sizeof(dataSize)) {
                 stopReplay();
                 return;
@@ -112,7 +184,7 @@ void LogFile::timerFired()
 
             m_file.read((char *)&dataSize, sizeof(dataSize));
 
-            if (dataSize < 1 || dataSize > (1024 * 1024)) {
+            if (dataSize < 1 || dataSize > MAX_RECORD_SIZE) {
                 qDebug() << "Error: Logfile corrupted! Unlikely packet size: " << dataSize << "\n";
                 stopReplay();
                 return;
@@ -126,6 +198,9 @@ void LogFile::timerFired()
             m_mutex.lock();
             m_dataBuffer.append(m_file.read(dataSize));
             m_mutex.unlock();
+            released += dataSize;
+            m_replayedBytes += dataSize;
+            m_replayedPackets++;
 
             emit readyRead();
 
@@ -138,7 +213,7 @@ void LogFile::timerFired()
             m_file.read((char *)&m_lastTimeStamp, sizeof(m_lastTimeStamp));
             // some validity checks
             if (m_lastTimeStamp < save // logfile goes back in time
-                || (m_lastTimeStamp - save) > (60 * 60 * 1000)) { // gap of more than 60 minutes)
+                || (m_lastTimeStamp - save) > MAX_RECORD_GAP_MS) { // gap of more than 60 minutes)
                 qDebug() << "Error: Logfile corrupted! Unlikely timestamp " << m_lastTimeStamp << " after " << save << "\n";
                 stopReplay();
                 return;
@@ -147,6 +222,7 @@ void LogFile::timerFired()
             m_timeOffset = time;
             time = m_myTime.elapsed();
         }
+        emit replayPositionChanged(m_lastPlayed);
     } else {
         stopReplay();
     }
@@ -154,12 +230,35 @@ void LogFile::timerFired()
 
 bool LogFile::startReplay()
 {
+    // The replay starts right away, seeking is enabled once the log is indexed
+    m_snapshots.clear();
+    m_replayStart = 0;
+    m_replayEnd   = 0;
+    m_indexWatcher.setFuture(QtConcurrent::run(&LogFile::buildIndex, m_file.fileName()));
+
     m_dataBuffer.clear();
     m_myTime.restart();
     m_timeOffset = 0;
     m_lastPlayed = 0;
     m_file.read((char *)&m_lastTimeStamp, sizeof(m_lastTimeStamp));
-    m_timer.setInterval(10);
+
+    // Map the log when possible, the packets are then handed out without copies
+    m_mapSize = m_file.size();
+    m_mapLock.lockForWrite();
+    m_map = m_mapSize > 0 ? m_file.map(0, m_mapSize) : NULL;
+    m_mapLock.unlock();
+    if (m_map == NULL) {
+        qDebug() << "Unable to map " << m_file.fileName() << ", replaying from the file";
+    }
+    m_mapPos      = 0;
+    m_mapReadPos  = 0;
+    m_mapReadyEnd = 0;
+
+    m_replayedBytes   = 0;
+    m_replayedPackets = 0;
+    m_throughputReported = 0;
+    m_throughputTime.start();
+    m_timer.setInterval(m_maxSpeed ? 0 : 10);
     m_timer.start();
     emit replayStarted();
     return true;
@@ -167,6 +266,9 @@ bool LogFile::startReplay()
 
 bool LogFile::stopReplay()
 {
+    if (m_maxSpeed) {
+        reportThroughput(true);
+    }
     close();
     emit replayFinished();
     return true;
@@ -182,3 +284,359 @@ void LogFile::resumeReplay()
     m_timeOffset = m_myTime.elapsed();
     m_timer.start();
 }
+
+/**
+ * Replay the log as fast as it can be decoded instead of following its
+ * timestamps. The throughput is reported every THROUGHPUT_REPORT_MS, when
+ * the mode is left and when the replay finishes.
+ */
+void LogFile::setMaxSpeedReplay(bool maxSpeed)
+{
+    if (m_maxSpeed && !maxSpeed) {
+        reportThroughput(true);
+    }
+    if (maxSpeed && !m_maxSpeed) {
+        m_replayedBytes   = 0;
+        m_replayedPackets = 0;
+        m_throughputReported = 0;
+        m_throughputTime.start();
+    }
+    m_maxSpeed = maxSpeed;
+    // continue in real time from where the fast replay is
+    m_timeOffset = m_myTime.elapsed();
+    m_timer.setInterval(m_maxSpeed ? 0 : 10);
+}
+
+/**
+ * Jump to a time of the log being replayed. The last packet of every object
+ * instance logged before that time is replayed first so the objects show the
+ * state they had, then the replay continues from there.
+ * \param[in] timestamp Log time to go to, in ms
+ * \return true if the replay is now at the requested time
+ */
+bool LogFile::seekReplay(quint32 timestamp)
+{
+    if (!m_file.isOpen() || m_file.isWritable() || m_snapshots.isEmpty()) {
+        return false;
+    }
+
+    // Find the last snapshot at or before the requested time
+    int first = 0;
+    int last  = m_snapshots.size() - 1;
+    while (first < last) {
+        int middle = (first + last + 1) / 2;
+        if (m_snapshots[middle].timestamp <= timestamp) {
+            first = middle;
+        } else {
+            last = middle - 1;
+        }
+    }
+    const Snapshot &snapshot = m_snapshots[first];
+    qint64 end = (first + 1 < m_snapshots.size()) ? m_snapshots[first + 1].offset : m_file.size();
+
+    // Bring the snapshot forward to the requested time, at most one snapshot interval of records
+    if (!m_file.seek(snapshot.offset)) {
+        return false;
+    }
+    QByteArray records = m_file.read(end - snapshot.offset);
+    QHash<quint64, qint64> latest;
+    qint64 target = snapshot.offset;
+    qint64 pos    = 0;
+    while (pos + RECORD_HEADER_SIZE <= records.size()) {
+        quint32 recordTimeStamp;
+        qint64 dataSize;
+        memcpy(&recordTimeStamp, records.constData() + pos, sizeof(recordTimeStamp));
+        memcpy(&dataSize, records.constData() + pos + sizeof(recordTimeStamp), sizeof(dataSize));
+        if (recordTimeStamp >= timestamp || dataSize < 1 || pos + RECORD_HEADER_SIZE + dataSize > records.size()) {
+            break;
+        }
+        quint64 key;
+        if (packetObjectKey(records.constData() + pos + RECORD_HEADER_SIZE, dataSize, key)) {
+            latest.insert(key, snapshot.offset + pos);
+        }
+        pos += RECORD_HEADER_SIZE + dataSize;
+    }
+    target += pos;
+
+    // Records are replayed in log order so an object updated after the snapshot ends with its latest value
+    QVector<qint64> objects = snapshot.objects;
+    objects += latest.values().toVector();
+    qSort(objects);
+
+    QByteArray state;
+    QByteArray packet;
+    foreach(qint64 offset, objects) {
+        if (readRecord(offset, packet)) {
+            state.append(packet);
+        }
+    }
+
+    // Leave the file where timerFired() expects it, after the timestamp of the next record
+    if (!m_file.seek(target)) {
+        return false;
+    }
+    if (m_file.read((char *)&m_lastTimeStamp, sizeof(m_lastTimeStamp)) != sizeof(m_lastTimeStamp)) {
+        m_lastTimeStamp = m_replayEnd;
+    }
+
+    m_mutex.lock();
+    m_dataBuffer = state;
+    m_mapPos      = target;
+    m_mapReadPos  = target;
+    m_mapReadyEnd = target;
+    m_mutex.unlock();
+
+    m_lastPlayed = timestamp;
+    m_timeOffset = m_myTime.elapsed();
+
+    if (!m_dataBuffer.isEmpty()) {
+        emit readyRead();
+    }
+    emit replayPositionChanged(m_lastPlayed);
+    return true;
+}
+
+/**
+ * Install the index built by buildIndex() if its replay is still running
+ */
+void LogFile::indexBuilt()
+{
+    if (!m_file.isOpen() || m_file.isWritable()) {
+        return;
+    }
+    Index index = m_indexWatcher.result();
+    if (index.snapshots.isEmpty()) {
+        qDebug() << "Unable to index " << m_file.fileName() << ", seeking is disabled";
+        return;
+    }
+    qDebug() << "Indexed" << index.snapshots.size() << "snapshots";
+    m_snapshots   = index.snapshots;
+    m_replayStart = index.start;
+    m_replayEnd   = index.end;
+    emit replayIndexed();
+}
+
+/**
+ * Scan the whole log once and take a snapshot of the object state every
+ * SNAPSHOT_INTERVAL_MS, only packet offsets are kept, not their content.
+ * Runs on a worker thread with its own handle to the log.
+ */
+LogFile::Index LogFile::buildIndex(const QString &fileName)
+{
+    Index index;
+    QFile file(fileName);
+    QHash<quint64, qint64> latest;
+    QByteArray chunk;
+    qint64 chunkStart     = 0;
+    qint64 offset         = 0;
+    qint64 fileSize       = 0;
+    quint32 lastTimeStamp = 0;
+    quint32 nextSnapshot  = 0;
+
+    index.start = 0;
+    index.end   = 0;
+    if (!file.open(QIODevice::ReadOnly)) {
+        return index;
+    }
+    fileSize = file.size();
+
+    forever {
+        qint64 pos = offset - chunkStart;
+
+        // Read ahead when the next record header is not completely in the chunk
+        if (pos + RECORD_HEADER_SIZE + PACKET_HEADER_SIZE > chunk.size()) {
+            if (!file.seek(offset)) {
+                break;
+            }
+            chunk = file.read(INDEX_CHUNK_SIZE);
+            chunkStart = offset;
+            pos = 0;
+            if (chunk.size() < RECORD_HEADER_SIZE) {
+                break;
+            }
+        }
+
+        quint32 timestamp;
+        qint64 dataSize;
+        memcpy(&timestamp, chunk.constData() + pos, sizeof(timestamp));
+        memcpy(&dataSize, chunk.constData() + pos + sizeof(timestamp), sizeof(dataSize));
+
+        // Stop at the first record the replay would reject
+        if (dataSize < 1 || dataSize > MAX_RECORD_SIZE || offset + RECORD_HEADER_SIZE + dataSize > fileSize
+            || (!index.snapshots.isEmpty() && (timestamp < lastTimeStamp || timestamp - lastTimeStamp > MAX_RECORD_GAP_MS))) {
+            break;
+        }
+
+        if (index.snapshots.isEmpty() || timestamp >= nextSnapshot) {
+            Snapshot snapshot;
+            snapshot.timestamp = timestamp;
+            snapshot.offset    = offset;
+            snapshot.objects   = latest.values().toVector();
+            qSort(snapshot.objects);
+            if (index.snapshots.isEmpty()) {
+                index.start = timestamp;
+            }
+            index.snapshots.append(snapshot);
+            nextSnapshot = timestamp + SNAPSHOT_INTERVAL_MS;
+        }
+
+        quint64 key;
+        if (pos + RECORD_HEADER_SIZE + PACKET_HEADER_SIZE <= chunk.size()
+            && packetObjectKey(chunk.constData() + pos + RECORD_HEADER_SIZE, dataSize, key)) {
+            latest.insert(key, offset);
+        }
+
+        lastTimeStamp = timestamp;
+        offset += RECORD_HEADER_SIZE + dataSize;
+    }
+
+    index.end = lastTimeStamp;
+    return index;
+}
+
+/**
+ * Read the packet of the record at offset
+ */
+bool LogFile::readRecord(qint64 offset, QByteArray &data)
+{
+    qint64 dataSize;
+
+    if (!m_file.seek(offset + sizeof(quint32))
+        || m_file.read((char *)&dataSize, sizeof(dataSize)) != sizeof(dataSize)
+        || dataSize < 1 || dataSize > MAX_RECORD_SIZE) {
+        return false;
+    }
+    data = m_file.read(dataSize);
+    return data.size() == dataSize;
+}
+
+/**
+ * Get the next packet of a mapped replay, must be called between
+ * lockPackets() and unlockPackets()
+ * \param[out] data The packet, pointing into the mapped log
+ * \param[out] size Size of the packet
+ * \return false if no more packets are due
+ */
+bool LogFile::nextPacket(const char * &data, qint64 &size)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_map == NULL || m_mapReadPos >= m_mapReadyEnd) {
+        return false;
+    }
+    // the record was checked when it was released by replayMapped()
+    memcpy(&size, m_map + m_mapReadPos + sizeof(quint32), sizeof(size));
+    data = (const char *)m_map + m_mapReadPos + RECORD_HEADER_SIZE;
+    m_mapReadPos += RECORD_HEADER_SIZE + size;
+    return true;
+}
+
+/**
+ * Mapped version of timerFired(), due records are checked and released to
+ * nextPacket() by moving m_mapReadyEnd, nothing is copied.
+ */
+void LogFile::replayMapped()
+{
+    qint64 dataSize;
+    qint64 released = 0;
+    int time = m_myTime.elapsed();
+
+    if (m_mapPos + RECORD_HEADER_SIZE > m_mapSize) {
+        // end of the log, stop once everything released was decoded
+        if (replayDrained()) {
+            stopReplay();
+        }
+        return;
+    }
+
+    while (replayDue(time, released)) {
+        if (m_maxSpeed) {
+            m_lastPlayed = m_lastTimeStamp;
+        } else {
+            m_lastPlayed += ((time - m_timeOffset) * m_playbackSpeed);
+        }
+
+        memcpy(&dataSize, m_map + m_mapPos + sizeof(quint32), sizeof(dataSize));
+        if (dataSize < 1 || dataSize > MAX_RECORD_SIZE) {
+            qDebug() << "Error: Logfile corrupted! Unlikely packet size: " << dataSize << "\n";
+            stopReplay();
+            return;
+        }
+        if (m_mapPos + RECORD_HEADER_SIZE + dataSize > m_mapSize) {
+            // truncated last record, end the replay before it
+            m_mapSize = m_mapPos;
+            break;
+        }
+
+        m_mapPos += RECORD_HEADER_SIZE + dataSize;
+        released += dataSize;
+        m_replayedBytes += dataSize;
+        m_replayedPackets++;
+
+        if (m_mapPos + RECORD_HEADER_SIZE > m_mapSize) {
+            break;
+        }
+
+        qint32 save = m_lastTimeStamp;
+        memcpy(&m_lastTimeStamp, m_map + m_mapPos, sizeof(m_lastTimeStamp));
+        // some validity checks
+        if (m_lastTimeStamp < save // logfile goes back in time
+            || (m_lastTimeStamp - save) > MAX_RECORD_GAP_MS) { // gap of more than 60 minutes)
+            qDebug() << "Error: Logfile corrupted! Unlikely timestamp " << m_lastTimeStamp << " after " << save << "\n";
+            stopReplay();
+            return;
+        }
+
+        m_timeOffset = time;
+        time = m_myTime.elapsed();
+    }
+
+    if (released > 0) {
+        m_mutex.lock();
+        m_mapReadyEnd = m_mapPos;
+        m_mutex.unlock();
+        emit readyRead();
+    }
+    emit replayPositionChanged(m_lastPlayed);
+}
+
+/**
+ * Whether the next record is due, in real time or when replaying as fast as possible
+ * \param[in] time Current replay time
+ * \param[in] released Bytes released by this timer tick so far
+ */
+bool LogFile::replayDue(int time, qint64 released) const
+{
+    if (m_maxSpeed) {
+        return released < MAX_SPEED_CHUNK_SIZE;
+    }
+    return m_lastPlayed + ((time - m_timeOffset) * m_playbackSpeed) > m_lastTimeStamp;
+}
+
+/**
+ * Whether everything released so far has been read
+ */
+bool LogFile::replayDrained()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_dataBuffer.isEmpty() && m_mapReadPos >= m_mapReadyEnd;
+}
+
+/**
+ * Emit the throughput of the replay at maximum speed so far
+ * \param[in] finished Whether the fast replay ended, it is then logged as well
+ */
+void LogFile::reportThroughput(bool finished)
+{
+    m_throughputReported = m_throughputTime.elapsed();
+    double seconds = qMax(m_throughputReported, 1) / 1000.0;
+    double megabytesPerSecond = m_replayedBytes / seconds / (1024 * 1024);
+    double packetsPerSecond   = m_replayedPackets / seconds;
+
+    if (finished) {
+        qDebug() << "Replayed" << m_replayedPackets << "packets," << m_replayedBytes << "bytes in" << seconds << "s:"
+                 << megabytesPerSecond << "MB/s," << packetsPerSecond << "packets/s";
+    }
+    emit replayThroughput(megabytesPerSecond, packetsPerSecond);
+}
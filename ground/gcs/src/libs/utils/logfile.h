@@ -5,12 +5,16 @@
 #include <QTime>
 #include <QTimer>
 #include <QMutexLocker>
+#include <QReadWriteLock>
 #include <QDebug>
 #include <QBuffer>
 #include <QFile>
+#include <QFutureWatcher>
+#include <QVector>
 #include "utils_global.h"
+#include "packetsource.h"
 
-class QTCREATOR_UTILS_EXPORT LogFile : public QIODevice {
+class QTCREATOR_UTILS_EXPORT LogFile : public QIODevice, public Utils::PacketSource {
     Q_OBJECT
 public:
     explicit LogFile(QObject *parent = 0);
@@ -40,6 +44,33 @@ public:
         m_nextTimeStamp = nextTimestamp;
     }
 
+    // Log time of the first and the last record, known once replayIndexed() was emitted
+    quint32 replayStart() const
+    {
+        return m_replayStart;
+    }
+
+    quint32 replayEnd() const
+    {
+        return m_replayEnd;
+    }
+
+    quint32 replayPosition() const
+    {
+        return m_lastPlayed;
+    }
+
+    // Zero copy access to the packets of a mapped log replay
+    void lockPackets()
+    {
+        m_mapLock.lockForRead();
+    }
+    void unlockPackets()
+    {
+        m_mapLock.unlock();
+    }
+    bool nextPacket(const char * &data, qint64 &size);
+
 public slots:
     void setReplaySpeed(double val)
     {
@@ -48,14 +79,22 @@ public slots:
     };
     void pauseReplay();
     void resumeReplay();
+    bool seekReplay(quint32 timestamp);
+    void setMaxSpeedReplay(bool maxSpeed);
 
 protected slots:
     void timerFired();
 
+private slots:
+    void indexBuilt();
+
 signals:
     void readReady();
     void replayStarted();
+    void replayIndexed();
     void replayFinished();
+    void replayPositionChanged(quint32 timestamp);
+    void replayThroughput(double megabytesPerSecond, double packetsPerSecond);
 
 protected:
     QByteArray m_dataBuffer;
@@ -71,8 +110,47 @@ protected:
     double m_playbackSpeed;
 
 private:
+    // Object state of the log at a given record, built when the replay starts
+    struct Snapshot {
+        quint32 timestamp; // timestamp of the record at offset
+        qint64  offset; // file offset of the first record not covered by objects
+        QVector<qint64> objects; // offsets of the last record of each object instance, sorted
+    };
+
+    struct Index {
+        QVector<Snapshot> snapshots;
+        quint32 start;
+        quint32 end;
+    };
+
     quint32 m_nextTimeStamp;
     bool m_useProvidedTimeStamp;
+    quint32 m_replayStart;
+    quint32 m_replayEnd;
+    QVector<Snapshot> m_snapshots;
+    QFutureWatcher<Index> m_indexWatcher;
+
+    // Mapped replay: records up to m_mapPos were played, the packets from
+    // m_mapReadPos to m_mapReadyEnd are waiting for nextPacket()
+    uchar *m_map;
+    qint64 m_mapSize;
+    qint64 m_mapPos;
+    qint64 m_mapReadPos;
+    qint64 m_mapReadyEnd;
+    QReadWriteLock m_mapLock;
+
+    bool m_maxSpeed;
+    QTime m_throughputTime;
+    int m_throughputReported;
+    qint64 m_replayedBytes;
+    qint64 m_replayedPackets;
+
+    static Index buildIndex(const QString &fileName);
+    bool readRecord(qint64 offset, QByteArray &data);
+    void replayMapped();
+    bool replayDue(int time, qint64 released) const;
+    bool replayDrained();
+    void reportThroughput(bool finished);
 };
 
 #endif // LOGFILE_H
@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ *
+ * @file       packetsource.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup CorePlugin Core Plugin
+ * @{
+ * @brief Zero copy packet access for telemetry devices
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PACKETSOURCE_H
+#define PACKETSOURCE_H
+
+#include "utils_global.h"
+
+#include <QtGlobal>
+
+namespace Utils {
+/**
+ * Implemented by telemetry devices that can hand out whole packets in
+ * place, next to what they make readable through QIODevice.
+ */
+class QTCREATOR_UTILS_EXPORT PacketSource {
+public:
+    virtual ~PacketSource() {}
+
+    // The packets are only valid between lockPackets() and unlockPackets()
+    virtual void lockPackets()   = 0;
+    virtual void unlockPackets() = 0;
+
+    /**
+     * Get the next packet due
+     * \param[out] data The packet
+     * \param[out] size Size of the packet
+     * \return false if no packet is due
+     */
+    virtual bool nextPacket(const char * &data, qint64 &size) = 0;
+};
+}
+
+#endif // PACKETSOURCE_H
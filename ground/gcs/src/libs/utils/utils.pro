@@ -1,7 +1,7 @@
 TEMPLATE = lib
 TARGET = Utils
 
-QT += network xml svg gui widgets qml quick quickwidgets
+QT += network xml svg gui widgets qml quick quickwidgets concurrent
 
 DEFINES += QTCREATOR_UTILS_LIB
 
@@ -119,6 +119,7 @@ HEADERS += \
     svgimageprovider.h \
     hostosinfo.h \
     logfile.h \
+    packetsource.h \
     crc.h \
     mustache.h \
     textbubbleslider.h \
@@ -33,6 +33,10 @@
 #include <QXmlStreamReader>
 #include <QMessageBox>
 #include <QDebug>
+#include <QEventLoop>
+#include <QTimer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include "debuglogcontrol.h"
 #include "uavobjecthelper.h"
@@ -68,6 +72,13 @@ FlightLogManager::FlightLogManager(QObject *parent) :
 
     m_flightLogEntry    = DebugLogEntry::GetInstance(m_objectManager);
     Q_ASSERT(m_flightLogEntry);
+    m_streamFlight    = -1;
+    m_streamFirst     = 0;
+    m_streamRequested = 0;
+    m_streamEnd       = -1;
+    m_streamAcked     = true;
+    m_streamStarted   = false;
+    m_streamFailed    = false;
 
     m_flightLogSettings = DebugLogSettings::GetInstance(m_objectManager);
     Q_ASSERT(m_flightLogSettings);
@@ -186,6 +197,57 @@ void FlightLogManager::clearLogList()
     }
 }
 
+/**
+ * Turn retrieved entries into ExtendedDebugLogEntry, splitting the entries that hold
+ * several objects. Runs in a worker thread during a streamed download so the
+ * entries are handed over to the GUI thread.
+ */
+static QList<ExtendedDebugLogEntry *> decodeLogEntries(const QVector<DebugLogEntry::DataFields> &entries, UAVObjectManager *objectManager)
+{
+    QList<ExtendedDebugLogEntry *> logEntries;
+    QThread *guiThread = QApplication::instance()->thread();
+
+    foreach(const DebugLogEntry::DataFields &data, entries) {
+        ExtendedDebugLogEntry *logEntry = new ExtendedDebugLogEntry();
+
+        logEntry->setData(data, objectManager);
+        logEntries << logEntry;
+        if (logEntry->getData().Type == DebugLogEntry::TYPE_MULTIPLEUAVOBJECTS) {
+            const quint32 total_len  = sizeof(DebugLogEntry::DataFields);
+            const quint32 data_len   = sizeof(((DebugLogEntry::DataFields *)0)->Data);
+            const quint32 header_len = total_len - data_len;
+
+            DebugLogEntry::DataFields fields;
+            quint32 start = logEntry->getData().Size;
+
+            // cycle until there is space for another object
+            while (start + header_len + 1 < data_len) {
+                memset(&fields, 0xFF, total_len);
+                memcpy(&fields, &logEntry->getData().Data[start], header_len);
+                // check wether a packed object is found
+                // note that empty data blocks are set as 0xFF in flight side to minimize flash wearing
+                // thus as soon as this read outside of used area, the test will fail as lenght would be 0xFFFF
+                quint32 toread = header_len + fields.Size;
+                if (!(toread + start > data_len)) {
+                    memcpy(&fields, &logEntry->getData().Data[start], toread);
+                    ExtendedDebugLogEntry *subEntry = new ExtendedDebugLogEntry();
+                    subEntry->setData(fields, objectManager);
+                    logEntries << subEntry;
+                }
+                start += toread;
+            }
+        }
+    }
+
+    foreach(ExtendedDebugLogEntry * logEntry, logEntries) {
+        logEntry->moveToThread(guiThread);
+        if (logEntry->uavObject()) {
+            logEntry->uavObject()->moveToThread(guiThread);
+        }
+    }
+    return logEntries;
+}
+
 void FlightLogManager::retrieveLogs(int flightToRetrieve)
 {
     setDisableControls(true);
@@ -193,6 +255,8 @@ void FlightLogManager::retrieveLogs(int flightToRetrieve)
     m_cancelDownload = false;
     UAVObjectUpdaterHelper updateHelper;
     UAVObjectRequestHelper requestHelper;
+    QList<QFuture<QList<ExtendedDebugLogEntry *> > > decoders;
+    bool streaming = true;
 
     clearLogList();
 
@@ -200,69 +264,70 @@ void FlightLogManager::retrieveLogs(int flightToRetrieve)
     int startFlight = (flightToRetrieve == -1) ? 0 : flightToRetrieve;
     int endFlight   = (flightToRetrieve == -1) ? m_flightLogStatus->getFlight() : flightToRetrieve;
 
-    // Prepare to send request for event retrieval
-    m_flightLogControl->setOperation(DebugLogControl::OPERATION_RETRIEVE);
     for (int flight = startFlight; flight <= endFlight; flight++) {
         m_flightLogControl->setFlight(flight);
         bool gotLast = false;
         int slot     = 0;
+        if (streaming) {
+            startStream(flight);
+        }
         while (!gotLast) {
-            // Send request for loading flight entry on flight side and wait for ack/nack
-            m_flightLogControl->setEntry(slot);
-
-            if (updateHelper.doObjectAndWait(m_flightLogControl, UAVTALK_TIMEOUT) == UAVObjectUpdaterHelper::SUCCESS &&
-                requestHelper.doObjectAndWait(m_flightLogEntry, UAVTALK_TIMEOUT) == UAVObjectUpdaterHelper::SUCCESS) {
-                if (m_flightLogEntry->getType() != DebugLogEntry::TYPE_EMPTY) {
-                    // Ok, we retrieved the entry, and it was the correct one. clone it and add it to the list
-                    ExtendedDebugLogEntry *logEntry = new ExtendedDebugLogEntry();
-
-                    logEntry->setData(m_flightLogEntry->getData(), m_objectManager);
-                    m_logEntries << logEntry;
-                    if (logEntry->getData().Type == DebugLogEntry::TYPE_MULTIPLEUAVOBJECTS) {
-                        const quint32 total_len  = sizeof(DebugLogEntry::DataFields);
-                        const quint32 data_len   = sizeof(((DebugLogEntry::DataFields *)0)->Data);
-                        const quint32 header_len = total_len - data_len;
-
-                        DebugLogEntry::DataFields fields;
-                        quint32 start = logEntry->getData().Size;
-
-                        // cycle until there is space for another object
-                        while (start + header_len + 1 < data_len) {
-                            memset(&fields, 0xFF, total_len);
-                            memcpy(&fields, &logEntry->getData().Data[start], header_len);
-                            // check wether a packed object is found
-                            // note that empty data blocks are set as 0xFF in flight side to minimize flash wearing
-                            // thus as soon as this read outside of used area, the test will fail as lenght would be 0xFFFF
-                            quint32 toread = header_len + fields.Size;
-                            if (!(toread + start > data_len)) {
-                                memcpy(&fields, &logEntry->getData().Data[start], toread);
-                                ExtendedDebugLogEntry *subEntry = new ExtendedDebugLogEntry();
-                                subEntry->setData(fields, m_objectManager);
-                                m_logEntries << subEntry;
-                            }
-                            start += toread;
-                        }
+            if (streaming) {
+                QVector<DebugLogEntry::DataFields> window;
+                if (streamWindow(window)) {
+                    slot += window.count();
+                    if (window.last().Type == DebugLogEntry::TYPE_EMPTY) {
+                        // We are done, not more entries on this flight
+                        window.removeLast();
+                        gotLast = true;
                     }
-
-                    // Increment to get next entry from flight side
-                    slot++;
+                    // Decode in the background while the next window is transferred
+                    decoders << QtConcurrent::run(decodeLogEntries, window, m_objectManager);
                 } else {
-                    // We are done, not more entries on this flight
-                    gotLast = true;
+                    // The flight side could not allocate the instances to stream to, or
+                    // entries got lost, go on entry by entry. Firmware without streaming
+                    // can not get here, its DebugLogControl has another object ID.
+                    qDebug() << "FlightLogManager: streaming failed, retrieving entries one by one";
+                    stopStream();
+                    streaming = false;
                 }
             } else {
-                // We failed for some reason
-                break;
+                // Send request for loading flight entry on flight side and wait for ack/nack
+                m_flightLogControl->setOperation(DebugLogControl::OPERATION_RETRIEVE);
+                m_flightLogControl->setEntry(slot);
+
+                if (updateHelper.doObjectAndWait(m_flightLogControl, UAVTALK_TIMEOUT) == UAVObjectUpdaterHelper::SUCCESS &&
+                    requestHelper.doObjectAndWait(m_flightLogEntry, UAVTALK_TIMEOUT) == UAVObjectUpdaterHelper::SUCCESS) {
+                    if (m_flightLogEntry->getType() != DebugLogEntry::TYPE_EMPTY) {
+                        // Ok, we retrieved the entry, and it was the correct one. clone it and add it to the list
+                        decoders << QtConcurrent::run(decodeLogEntries, QVector<DebugLogEntry::DataFields>() << m_flightLogEntry->getData(), m_objectManager);
+
+                        // Increment to get next entry from flight side
+                        slot++;
+                    } else {
+                        // We are done, not more entries on this flight
+                        gotLast = true;
+                    }
+                } else {
+                    // We failed for some reason
+                    break;
+                }
             }
             if (m_cancelDownload) {
                 break;
             }
         }
+        stopStream();
         if (m_cancelDownload) {
             break;
         }
     }
 
+    // Collect the decoded entries in download order
+    for (int i = 0; i < decoders.count(); i++) {
+        m_logEntries << decoders[i].result();
+    }
+
     if (m_cancelDownload) {
         clearLogList();
         m_cancelDownload = false;
@@ -275,6 +340,173 @@ void FlightLogManager::retrieveLogs(int flightToRetrieve)
     setDisableControls(false);
 }
 
+/**
+ * Start streaming the entries of a flight. STREAM_DEPTH requests of STREAM_WINDOW
+ * entries are kept in flight so the link does not idle while a window is handed
+ * out and the next one is requested.
+ */
+void FlightLogManager::startStream(int flight)
+{
+    m_streamFlight    = flight;
+    m_streamFirst     = 0;
+    m_streamRequested = 0;
+    m_streamEnd       = -1;
+    // m_streamAcked is kept, a request of the previous flight can still wait for its ack
+    m_streamStarted   = true;
+    m_streamFailed    = false;
+    m_streamEntries.fill(DebugLogEntry::DataFields(), STREAM_DEPTH * STREAM_WINDOW);
+    m_streamReceived.fill(false, STREAM_DEPTH * STREAM_WINDOW);
+
+    // The firmware streams entry n to the DebugLogEntry instance n modulo its window
+    for (int i = 0; i < STREAM_DEPTH * STREAM_WINDOW; i++) {
+        DebugLogEntry *instance = DebugLogEntry::GetInstance(m_objectManager, i);
+        if (!instance) {
+            m_objectManager->registerObject(m_flightLogEntry->clone(i));
+            instance = DebugLogEntry::GetInstance(m_objectManager, i);
+        }
+        if (!instance) {
+            m_streamFailed = true;
+            return;
+        }
+        connect(instance, SIGNAL(objectUnpacked(UAVObject *)), this, SLOT(logEntryStreamed(UAVObject *)), Qt::UniqueConnection);
+    }
+    connect(m_flightLogControl, SIGNAL(transactionCompleted(UAVObject *, bool)),
+            this, SLOT(streamRequestCompleted(UAVObject *, bool)), Qt::UniqueConnection);
+    continueStream();
+}
+
+/**
+ * Ignore the entries still in flight
+ */
+void FlightLogManager::stopStream()
+{
+    m_streamFlight = -1;
+}
+
+void FlightLogManager::requestStreamWindow()
+{
+    m_streamAcked   = false;
+    m_streamStarted = false;
+    m_flightLogControl->setOperation(DebugLogControl::OPERATION_STREAM);
+    m_flightLogControl->setFlight(m_streamFlight);
+    m_flightLogControl->setEntry(m_streamRequested);
+    m_flightLogControl->setCount(STREAM_WINDOW);
+    m_flightLogControl->updated();
+    m_streamRequested += STREAM_WINDOW;
+}
+
+/**
+ * Request the next window if there is room for it. The firmware has to be done with
+ * the last request first: DebugLogControl holds one request only, and telemetry does
+ * not send an update while the previous one waits for its ack.
+ */
+void FlightLogManager::continueStream()
+{
+    if (m_streamFlight >= 0 && !m_streamFailed && m_streamEnd < 0 && m_streamAcked && m_streamStarted &&
+        m_streamRequested - m_streamFirst < STREAM_DEPTH * STREAM_WINDOW) {
+        requestStreamWindow();
+    }
+}
+
+/**
+ * Wait for the oldest window of the stream and hand it out, the following windows
+ * keep coming in meanwhile. The window is cut after the first empty entry, which
+ * is included.
+ * \return false if the window could not be received completely
+ */
+bool FlightLogManager::streamWindow(QVector<DebugLogEntry::DataFields> &window)
+{
+    if (!m_streamFailed && !streamWindowComplete()) {
+        QEventLoop loop;
+        QTimer timer;
+        timer.setSingleShot(true);
+        connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+        connect(this, SIGNAL(streamWindowReceived()), &loop, SLOT(quit()));
+        timer.start(UAVTALK_TIMEOUT);
+        loop.exec();
+    }
+    if (m_streamFailed || !streamWindowComplete()) {
+        return false;
+    }
+
+    int size = streamWindowSize();
+    window = m_streamEntries.mid(0, size);
+    m_streamEntries.remove(0, size);
+    m_streamEntries.resize(STREAM_DEPTH * STREAM_WINDOW);
+    m_streamReceived.remove(0, size);
+    m_streamReceived.resize(STREAM_DEPTH * STREAM_WINDOW);
+    m_streamFirst += size;
+    continueStream();
+    return true;
+}
+
+/**
+ * Number of entries of the oldest window, it ends early at the empty entry
+ */
+int FlightLogManager::streamWindowSize()
+{
+    int size = STREAM_WINDOW;
+
+    if (m_streamEnd >= 0) {
+        size = qMin(size, m_streamEnd - m_streamFirst);
+    }
+    return qMin(size, m_streamRequested - m_streamFirst);
+}
+
+bool FlightLogManager::streamWindowComplete()
+{
+    int size = streamWindowSize();
+
+    if (m_streamFlight < 0 || size <= 0) {
+        return false;
+    }
+    for (int i = 0; i < size; i++) {
+        if (!m_streamReceived[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FlightLogManager::logEntryStreamed(UAVObject *obj)
+{
+    DebugLogEntry::DataFields fields = static_cast<DebugLogEntry *>(obj)->getData();
+    int index = fields.Entry - m_streamFirst;
+
+    if (m_streamFlight < 0 || fields.Flight != m_streamFlight || index < 0 ||
+        fields.Entry >= m_streamRequested || m_streamReceived[index]) {
+        return;
+    }
+    m_streamEntries[index]  = fields;
+    m_streamReceived[index] = true;
+    if (fields.Type == DebugLogEntry::TYPE_EMPTY && (m_streamEnd < 0 || fields.Entry < m_streamEnd)) {
+        m_streamEnd = fields.Entry + 1;
+    }
+    if (fields.Entry >= m_streamRequested - STREAM_WINDOW) {
+        m_streamStarted = true;
+        continueStream();
+    }
+    if (streamWindowComplete()) {
+        emit streamWindowReceived();
+    }
+}
+
+void FlightLogManager::streamRequestCompleted(UAVObject *obj, bool success)
+{
+    Q_UNUSED(obj);
+
+    m_streamAcked = true;
+    if (m_streamFlight < 0) {
+        return;
+    }
+    if (!success) {
+        m_streamFailed = true;
+        emit streamWindowReceived();
+        return;
+    }
+    continueStream();
+}
+
 void FlightLogManager::exportToOPL(QString fileName)
 {
     // Fix the file name
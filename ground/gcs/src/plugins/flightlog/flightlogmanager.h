@@ -35,6 +35,7 @@
 #include <QSemaphore>
 #include <QXmlStreamWriter>
 #include <QTextStream>
+#include <QVector>
 
 #include "uavobjectmanager.h"
 #include "uavobjectutilmanager.h"
@@ -261,6 +262,8 @@ signals:
     void logStatusesChanged(QStringList arg);
     void loggingEnabledChanged(int arg);
 
+    void streamWindowReceived();
+
 public slots:
     void clearAllLogs();
     void retrieveLogs(int flightToRetrieve = -1);
@@ -319,6 +322,8 @@ private slots:
     void setupLogStatuses();
     void connectionStatusChanged();
     bool updateLogWrapper(QString name, int level, int period);
+    void logEntryStreamed(UAVObject *obj);
+    void streamRequestCompleted(UAVObject *obj, bool success);
 
 private:
     UAVObjectManager *m_objectManager;
@@ -341,8 +346,30 @@ private:
     void exportToOPL(QString fileName);
     void exportToCSV(QString fileName);
     void exportToXML(QString fileName);
+    void startStream(int flight);
+    void stopStream();
+    void requestStreamWindow();
+    void continueStream();
+    bool streamWindow(QVector<DebugLogEntry::DataFields> &window);
+    int streamWindowSize();
+    bool streamWindowComplete();
+
+    // Entries requested and not handed out yet, indexed from m_streamFirst
+    QVector<DebugLogEntry::DataFields> m_streamEntries;
+    QVector<bool> m_streamReceived;
+    int m_streamFlight; // -1 when no flight is streamed
+    int m_streamFirst;
+    int m_streamRequested; // first entry not requested yet
+    int m_streamEnd; // entry after the empty one, -1 until it was received
+    bool m_streamAcked; // the last request was acked
+    bool m_streamStarted; // an entry of the last request was received
+    bool m_streamFailed;
 
     static const int UAVTALK_TIMEOUT = 4000;
+    // Entries pushed per stream request and requests kept in flight. The firmware has
+    // 8 (STREAM_MAX_ENTRIES) instances to stream to, the entries in flight must fit.
+    static const int STREAM_WINDOW   = 4;
+    static const int STREAM_DEPTH    = 2;
     static const int LOG_SETTINGS_FILE_VERSION = 1;
     bool m_disableControls;
     bool m_disableExport;
@@ -58,6 +58,13 @@ void LoggingGadgetWidget::setPlugin(LoggingPlugin *p)
     connect(m_logging->pauseButton, SIGNAL(clicked()), p->getLogfile(), SLOT(pauseReplay()));
     connect(m_logging->pauseButton, SIGNAL(clicked()), scpPlugin, SLOT(stopPlotting()));
     connect(m_logging->playbackSpeed, SIGNAL(valueChanged(double)), p->getLogfile(), SLOT(setReplaySpeed(double)));
+    connect(m_logging->maxSpeed, SIGNAL(toggled(bool)), p->getLogfile(), SLOT(setMaxSpeedReplay(bool)));
+    connect(p->getLogfile(), SIGNAL(replayStarted()), this, SLOT(replayStarted()));
+    connect(p->getLogfile(), SIGNAL(replayIndexed()), this, SLOT(replayIndexed()));
+    connect(p->getLogfile(), SIGNAL(replayFinished()), this, SLOT(replayStopped()));
+    connect(p->getLogfile(), SIGNAL(replayPositionChanged(quint32)), this, SLOT(replayPositionChanged(quint32)));
+    connect(p->getLogfile(), SIGNAL(replayThroughput(double, double)), this, SLOT(replayThroughput(double, double)));
+    connect(m_logging->positionSlider, SIGNAL(sliderMoved(int)), this, SLOT(seekReplay(int)));
     void pauseReplay();
     void resumeReplay();
 }
@@ -68,6 +75,68 @@ void LoggingGadgetWidget::stateChanged(QString status)
     m_logging->statusLabel->setText(status);
 }
 
+static QString formatReplayTime(quint32 timestamp)
+{
+    quint32 seconds = timestamp / 1000;
+
+    return QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+void LoggingGadgetWidget::replayStarted()
+{
+    // the log is indexed in the background, seeking waits for it
+    m_logging->positionSlider->setEnabled(false);
+    m_logging->throughputLabel->clear();
+    replayPositionChanged(0);
+}
+
+void LoggingGadgetWidget::replayIndexed()
+{
+    LogFile *logFile = loggingPlugin->getLogfile();
+
+    // logs do not have to start at time 0, on board logs keep the flight time
+    m_logging->positionSlider->setRange(logFile->replayStart(), logFile->replayEnd());
+    m_logging->positionSlider->setValue(logFile->replayPosition());
+    m_logging->positionSlider->setEnabled(true);
+    replayPositionChanged(logFile->replayPosition());
+}
+
+void LoggingGadgetWidget::replayStopped()
+{
+    m_logging->positionSlider->setEnabled(false);
+}
+
+void LoggingGadgetWidget::replayPositionChanged(quint32 timestamp)
+{
+    // Do not fight the user while the slider is dragged
+    if (!m_logging->positionSlider->isSliderDown()) {
+        m_logging->positionSlider->setValue(timestamp);
+    }
+    LogFile *logFile = loggingPlugin->getLogfile();
+    quint32 start    = logFile->replayStart();
+    QString duration = m_logging->positionSlider->isEnabled() ? formatReplayTime(logFile->replayEnd() - start) : QString("--:--");
+    m_logging->positionLabel->setText(QString("%1 / %2").arg(formatReplayTime(timestamp > start ? timestamp - start : 0))
+                                      .arg(duration));
+}
+
+/**
+ * Show how fast the log is decoded when it is replayed as fast as possible,
+ * the last value stays once the replay finished
+ */
+void LoggingGadgetWidget::replayThroughput(double megabytesPerSecond, double packetsPerSecond)
+{
+    m_logging->throughputLabel->setText(tr("%1 MB/s, %2 packets/s").arg(megabytesPerSecond, 0, 'f', 1)
+                                        .arg(packetsPerSecond, 0, 'f', 0));
+}
+
+/**
+ * Scrub the replay while the position slider is moved
+ */
+void LoggingGadgetWidget::seekReplay(int timestamp)
+{
+    loggingPlugin->getLogfile()->seekReplay(timestamp);
+}
+
 /**
  * @}
  * @}
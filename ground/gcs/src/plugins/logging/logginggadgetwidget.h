@@ -47,6 +47,12 @@ public:
 
 protected slots:
     void stateChanged(QString status);
+    void replayStarted();
+    void replayIndexed();
+    void replayStopped();
+    void replayPositionChanged(quint32 timestamp);
+    void replayThroughput(double megabytesPerSecond, double packetsPerSecond);
+    void seekReplay(int timestamp);
 
 signals:
     void pause();
@@ -30,15 +30,199 @@
 #include <math.h>
 #include <QDebug>
 
+#define GROWABLE_INITIAL_CAPACITY 1024
+
+PlotSeriesData::PlotSeriesData(bool indexAsX, int capacity) :
+    m_indexAsX(indexAsX), m_fixedCapacity(capacity > 0), m_head(0), m_size(0),
+    m_columnCount(0), m_columnWidth(0.0), m_sequence(0)
+{
+    if (!m_fixedCapacity) {
+        capacity = GROWABLE_INITIAL_CAPACITY;
+    }
+    m_y.resize(capacity);
+    if (!m_indexAsX) {
+        m_x.resize(capacity);
+    }
+}
+
+size_t PlotSeriesData::size() const
+{
+    return isDecimated() ? 4 * m_columns.size() : m_size;
+}
+
+QPointF PlotSeriesData::sample(size_t i) const
+{
+    if (!isDecimated()) {
+        return QPointF(x(i), m_y[(m_head + i) % m_y.size()]);
+    }
+
+    const Column &column = m_columns.at(i / 4);
+    QPointF point;
+    switch (i % 4) {
+    case 0:
+        point = column.first;
+        break;
+    case 1:
+        point = column.min.x() <= column.max.x() ? column.min : column.max;
+        break;
+    case 2:
+        point = column.min.x() <= column.max.x() ? column.max : column.min;
+        break;
+    default:
+        point = column.last;
+        break;
+    }
+    if (m_indexAsX) {
+        // sequence number to position in the buffer
+        point.rx() -= m_sequence - m_size;
+    }
+    return point;
+}
+
+QRectF PlotSeriesData::boundingRect() const
+{
+    if (d_boundingRect.width() < 0.0) {
+        d_boundingRect = qwtBoundingRect(*this);
+    }
+    return d_boundingRect;
+}
+
+void PlotSeriesData::append(double x, double y)
+{
+    if (m_size == m_y.size()) {
+        if (m_fixedCapacity) {
+            removeFirst();
+        } else {
+            grow();
+        }
+    }
+    int tail = (m_head + m_size) % m_y.size();
+    m_y[tail] = y;
+    if (!m_indexAsX) {
+        m_x[tail] = x;
+    }
+    m_size++;
+    if (m_columnCount > 0) {
+        addToColumn(m_indexAsX ? m_sequence : x, y);
+    }
+    m_sequence++;
+    d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+}
+
+void PlotSeriesData::removeFirst()
+{
+    if (m_size > 0) {
+        m_head = (m_head + 1) % m_y.size();
+        m_size--;
+        if (m_columnCount > 0) {
+            removeFromColumn();
+        }
+        d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+    }
+}
+
+void PlotSeriesData::clear()
+{
+    m_head     = 0;
+    m_size     = 0;
+    m_sequence = 0;
+    m_columns.clear();
+    d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+}
+
+/**
+ * Set the number of columns the plot window of the given x span is drawn
+ * with, 0 disables decimation. The column summary is rebuilt from the
+ * buffered samples when the resolution changes.
+ */
+void PlotSeriesData::setResolution(double span, int columns)
+{
+    double columnWidth = (columns > 0 && span > 0.0) ? span / columns : 0.0;
+
+    if (columnWidth <= 0.0) {
+        columns = 0;
+    }
+    if (columns == m_columnCount && columnWidth == m_columnWidth) {
+        return;
+    }
+    m_columnCount = columns;
+    m_columnWidth = columnWidth;
+    m_columns.clear();
+    if (m_columnCount > 0) {
+        quint64 firstSequence = m_sequence - m_size;
+        for (int i = 0; i < m_size; i++) {
+            addToColumn(m_indexAsX ? firstSequence + i : x(i), m_y[(m_head + i) % m_y.size()]);
+        }
+    }
+    d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+}
+
+void PlotSeriesData::addToColumn(double key, double y)
+{
+    QPointF point(key, y);
+
+    if (m_columns.isEmpty() || key >= m_columns.last().start + m_columnWidth) {
+        Column column;
+        column.start = floor(key / m_columnWidth) * m_columnWidth;
+        column.count = 0;
+        m_columns.append(column);
+    }
+    Column &column = m_columns.last();
+    if (column.count == 0) {
+        column.first = column.min = column.max = point;
+    } else if (y < column.min.y()) {
+        column.min = point;
+    } else if (y > column.max.y()) {
+        column.max = point;
+    }
+    column.last = point;
+    column.count++;
+}
+
+void PlotSeriesData::removeFromColumn()
+{
+    // the min/max of the first column may still include dropped samples,
+    // which is at most one column off
+    if (!m_columns.isEmpty() && --m_columns.first().count <= 0) {
+        m_columns.removeFirst();
+    }
+}
+
+void PlotSeriesData::grow()
+{
+    // unwrap the samples into a buffer twice as large
+    int capacity = m_y.size();
+    QVector<double> y(capacity * 2);
+    QVector<double> x(m_indexAsX ? 0 : capacity * 2);
+
+    for (int i = 0; i < m_size; i++) {
+        int index = (m_head + i) % capacity;
+        y[i] = m_y[index];
+        if (!m_indexAsX) {
+            x[i] = m_x[index];
+        }
+    }
+    m_y    = y;
+    m_x    = x;
+    m_head = 0;
+}
+
 PlotData::PlotData(UAVObject *object, UAVObjectField *field, int element,
                    int scaleOrderFactor, int meanSamples, QString mathFunction,
-                   double plotDataSize, QPen pen, bool antialiased) :
-    m_scalePower(scaleOrderFactor), m_meanSamples(meanSamples),
-    m_meanSum(0.0f), m_mathFunction(mathFunction), m_correctionSum(0.0f),
-    m_correctionCount(0), m_plotDataSize(plotDataSize),
+                   double plotDataSize, QPen pen, bool antialiased, PlotSeriesData *data) :
+    m_scalePower(scaleOrderFactor), m_meanSamples(qMax(1, meanSamples)),
+    m_mathFunction(NoMathFunction), m_plotDataSize(plotDataSize), m_data(data), m_columns(0),
     m_object(object), m_field(field), m_element(element),
     m_plotCurve(NULL), m_isVisible(true), m_pen(pen), m_isEnumPlot(false)
 {
+    if (mathFunction == "Boxcar average") {
+        m_mathFunction = BoxcarAverage;
+    } else if (mathFunction == "Standard deviation") {
+        m_mathFunction = StandardDeviation;
+    }
+    m_history.resize(m_meanSamples);
+    resetMathFunction();
+
     if (m_field->getNumElements() > 1) {
         m_elementName = m_field->getElementNames().at(m_element);
     }
@@ -62,7 +246,8 @@ PlotData::PlotData(UAVObject *object, UAVObjectField *field, int element,
     }
 
     m_plotCurve->setPen(m_pen);
-    m_plotCurve->setSamples(m_xDataEntries, m_yDataEntries);
+    // the curve takes ownership of the series
+    m_plotCurve->setData(m_data);
     m_isEnumPlot = m_field->getType() == UAVObjectField::ENUM;
 }
 
@@ -90,16 +275,21 @@ void PlotData::setVisible(bool visible)
 
 void PlotData::updatePlotData()
 {
-    m_plotCurve->setSamples(m_xDataEntries, m_yDataEntries);
+    m_plotCurve->itemChanged();
+}
+
+void PlotData::setResolution(int columns)
+{
+    if (columns != m_columns) {
+        m_columns = columns;
+        m_data->setResolution(m_plotDataSize, m_columns);
+    }
 }
 
 void PlotData::clear()
 {
-    m_meanSum = 0.0f;
-    m_correctionSum   = 0.0f;
-    m_correctionCount = 0;
-    m_xDataEntries.clear();
-    m_yDataEntries.clear();
+    resetMathFunction();
+    m_data->clear();
     while (!m_enumMarkerList.isEmpty()) {
         QwtPlotMarker *marker = m_enumMarkerList.takeFirst();
         marker->detach();
@@ -113,7 +303,7 @@ void PlotData::clear()
 bool PlotData::hasData() const
 {
     if (!m_isEnumPlot) {
-        return !m_xDataEntries.isEmpty();
+        return !m_data->isEmpty();
     } else {
         return !m_enumMarkerList.isEmpty();
     }
@@ -122,7 +312,7 @@ bool PlotData::hasData() const
 QString PlotData::lastDataAsString()
 {
     if (!m_isEnumPlot) {
-        return QString().sprintf("%3.10g", m_yDataEntries.last());
+        return QString().sprintf("%3.10g", m_data->lastY());
     } else {
         return m_enumMarkerList.last()->title().text();
     }
@@ -142,37 +332,54 @@ void PlotData::visibilityChanged(QwtPlotItem *item)
     }
 }
 
-void PlotData::calcMathFunction(double currentValue)
+void PlotData::resetMathFunction()
 {
-    // Put the new value at the back
-    m_yDataHistory.append(currentValue);
-
-    // calculate average value
-    m_meanSum += currentValue;
-    if (m_yDataHistory.size() > m_meanSamples) {
-        m_meanSum -= m_yDataHistory.first();
-        m_yDataHistory.pop_front();
-    }
-    // make sure to correct the sum every meanSamples steps to prevent it
-    // from running away due to floating point rounding errors
-    m_correctionSum += currentValue;
-    if (++m_correctionCount >= m_meanSamples) {
-        m_meanSum = m_correctionSum;
-        m_correctionSum = 0.0f;
-        m_correctionCount = 0;
-    }
-
-    double boxcarAvg = m_meanSum / m_yDataHistory.size();
-    if (m_mathFunction == "Standard deviation") {
-        // Calculate square of sample standard deviation, with Bessel's correction
-        double stdSum = 0;
-        for (int i = 0; i < m_yDataHistory.size(); i++) {
-            stdSum += pow(m_yDataHistory.at(i) - boxcarAvg, 2) / (m_meanSamples - 1);
-        }
-        m_yDataEntries.append(sqrt(stdSum));
+    m_historyHead  = 0;
+    m_historyCount = 0;
+    m_mean = 0.0;
+    m_m2   = 0.0;
+    m_resyncCount  = 0;
+}
+
+double PlotData::calcMathFunction(double currentValue)
+{
+    // Update the running mean and sum of squared deviations (Welford)
+    if (m_historyCount < m_meanSamples) {
+        m_history[(m_historyHead + m_historyCount) % m_meanSamples] = currentValue;
+        m_historyCount++;
+        double delta = currentValue - m_mean;
+        m_mean += delta / m_historyCount;
+        m_m2   += delta * (currentValue - m_mean);
     } else {
-        m_yDataEntries.append(boxcarAvg);
+        // window is full, the new value replaces the oldest one
+        double oldest  = m_history[m_historyHead];
+        double oldMean = m_mean;
+        m_history[m_historyHead] = currentValue;
+        m_historyHead = (m_historyHead + 1) % m_meanSamples;
+        m_mean += (currentValue - oldest) / m_historyCount;
+        m_m2   += (currentValue - oldest) * (currentValue - m_mean + oldest - oldMean);
     }
+
+    // recompute from the history every meanSamples steps to prevent the
+    // running values from drifting due to floating point rounding errors
+    if (++m_resyncCount >= m_meanSamples) {
+        double sum = 0.0;
+        for (int i = 0; i < m_historyCount; i++) {
+            sum += m_history[i];
+        }
+        m_mean = sum / m_historyCount;
+        m_m2   = 0.0;
+        for (int i = 0; i < m_historyCount; i++) {
+            m_m2 += (m_history[i] - m_mean) * (m_history[i] - m_mean);
+        }
+        m_resyncCount = 0;
+    }
+
+    if (m_mathFunction == StandardDeviation) {
+        // Sample standard deviation, with Bessel's correction
+        return m_historyCount > 1 ? sqrt(qMax(0.0, m_m2 / (m_historyCount - 1))) : 0.0;
+    }
+    return m_mean;
 }
 
 QwtPlotMarker *PlotData::createMarker(QString value)
@@ -207,22 +414,15 @@ bool SequentialPlotData::append(UAVObject *obj)
 
     if (m_object == obj && m_field) {
         if (!m_isEnumPlot) {
-            double currentValue = m_field->getValue(m_element).toDouble() * pow(10, m_scalePower);
+            double currentValue = m_field->get<double>(m_element) * pow(10, m_scalePower);
 
             // Perform scope math, if necessary
-            if (m_mathFunction == "Boxcar average" || m_mathFunction == "Standard deviation") {
-                calcMathFunction(currentValue);
-            } else {
-                m_yDataEntries.append(currentValue);
+            if (m_mathFunction != NoMathFunction) {
+                currentValue = calcMathFunction(currentValue);
             }
 
-            if (m_yDataEntries.size() > m_plotDataSize) {
-                // If new data overflows the window, remove old data...
-                m_yDataEntries.pop_front();
-            } else {
-                // ...otherwise, add a new y point at position xData
-                m_xDataEntries.insert(m_xDataEntries.size(), m_xDataEntries.size());
-            }
+            // The series has a fixed capacity and drops old data when the window overflows
+            m_data->append(0, currentValue);
             return true;
         } else {
             // Enum markers
@@ -256,16 +456,14 @@ bool ChronoPlotData::append(UAVObject *obj)
 
         double xValue = NOW.toTime_t() + NOW.time().msec() / 1000.0;
         if (!m_isEnumPlot) {
-            double currentValue = m_field->getValue(m_element).toDouble() * pow(10, m_scalePower);
+            double currentValue = m_field->get<double>(m_element) * pow(10, m_scalePower);
 
             // Perform scope math, if necessary
-            if (m_mathFunction == "Boxcar average" || m_mathFunction == "Standard deviation") {
-                calcMathFunction(currentValue);
-            } else {
-                m_yDataEntries.append(currentValue);
+            if (m_mathFunction != NoMathFunction) {
+                currentValue = calcMathFunction(currentValue);
             }
 
-            m_xDataEntries.append(xValue);
+            m_data->append(xValue, currentValue);
         } else {
             // Enum markers
             QString value = m_field->getValue(m_element).toString();
@@ -289,10 +487,9 @@ bool ChronoPlotData::append(UAVObject *obj)
 
 void ChronoPlotData::removeStaleData()
 {
-    while (!m_xDataEntries.isEmpty() &&
-           (m_xDataEntries.last() - m_xDataEntries.first()) > m_plotDataSize) {
-        m_yDataEntries.pop_front();
-        m_xDataEntries.pop_front();
+    while (!m_data->isEmpty() &&
+           (m_data->lastX() - m_data->firstX()) > m_plotDataSize) {
+        m_data->removeFirst();
     }
     while (!m_enumMarkerList.isEmpty() &&
            (m_enumMarkerList.last()->xValue() - m_enumMarkerList.first()->xValue()) > m_plotDataSize) {
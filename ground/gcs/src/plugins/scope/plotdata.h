@@ -36,6 +36,7 @@
 #include "qwt/src/qwt_scale_draw.h"
 #include "qwt/src/qwt_scale_widget.h"
 #include <qwt/src/qwt_plot_marker.h>
+#include <qwt/src/qwt_series_data.h>
 
 #include <QTimer>
 #include <QTime>
@@ -47,6 +48,90 @@
  */
 enum PlotType { SequentialPlot, ChronoPlot };
 
+/*!
+   \brief Defines the math function applied to the samples of a curve.
+ */
+enum MathFunction { NoMathFunction, BoxcarAverage, StandardDeviation };
+
+/*!
+   \brief Ring buffer of curve samples, handed to Qwt without copying.
+
+   With a capacity the oldest sample is dropped once the buffer is full,
+   without one the buffer grows as needed. When indexAsX is set the x value
+   of a sample is its position in the buffer and only y values are stored.
+
+   Once a resolution is set, the buffer also keeps a min/max summary per
+   column of the plot window, updated as samples arrive. When there are
+   more samples than the columns can show, Qwt is handed the first, min,
+   max and last sample of each column instead of the raw samples, so the
+   cost of a replot depends on the plot width and not on the sample count.
+ */
+class PlotSeriesData : public QwtSeriesData<QPointF> {
+public:
+    PlotSeriesData(bool indexAsX, int capacity = 0);
+
+    size_t size() const;
+    QPointF sample(size_t i) const;
+    QRectF boundingRect() const;
+
+    void append(double x, double y);
+    void removeFirst();
+    void clear();
+    void setResolution(double span, int columns);
+
+    bool isEmpty() const
+    {
+        return m_size == 0;
+    }
+    double firstX() const
+    {
+        return x(0);
+    }
+    double lastX() const
+    {
+        return x(m_size - 1);
+    }
+    double lastY() const
+    {
+        return m_y[(m_head + m_size - 1) % m_y.size()];
+    }
+
+private:
+    struct Column {
+        double  start;
+        int     count;
+        QPointF first;
+        QPointF min;
+        QPointF max;
+        QPointF last;
+    };
+
+    bool m_indexAsX;
+    bool m_fixedCapacity;
+    QVector<double> m_x;
+    QVector<double> m_y;
+    int m_head;
+    int m_size;
+
+    // level of detail summary, keyed by x or by sample sequence number when indexAsX is set
+    int m_columnCount;
+    double m_columnWidth;
+    quint64 m_sequence;
+    QList<Column> m_columns;
+
+    double x(int i) const
+    {
+        return m_indexAsX ? i : m_x[(m_head + i) % m_x.size()];
+    }
+    bool isDecimated() const
+    {
+        return m_columnCount > 0 && m_size > 4 * m_columnCount;
+    }
+    void grow();
+    void addToColumn(double key, double y);
+    void removeFromColumn();
+};
+
 /*!
    \brief Base class that keeps the data for each curve in the plot.
  */
@@ -55,7 +140,7 @@ class PlotData : public QObject {
 
 public:
     PlotData(UAVObject *object, UAVObjectField *field, int element, int scaleOrderFactor, int meanSamples,
-             QString mathFunction, double plotDataSize, QPen pen, bool antialiased);
+             QString mathFunction, double plotDataSize, QPen pen, bool antialiased, PlotSeriesData *data);
     ~PlotData();
 
     QString plotName() const
@@ -94,6 +179,7 @@ public:
 
     void updatePlotData();
     void clear();
+    void setResolution(int columns);
 
     bool hasData() const;
     QString lastDataAsString();
@@ -107,15 +193,20 @@ protected:
     // This is the power to which each value must be raised
     int m_scalePower;
     int m_meanSamples;
-    double m_meanSum;
-    QString m_mathFunction;
-    double m_correctionSum;
-    int m_correctionCount;
+    MathFunction m_mathFunction;
     double m_plotDataSize;
 
-    QVector<double> m_xDataEntries;
-    QVector<double> m_yDataEntries;
-    QVector<double> m_yDataHistory;
+    // owned by m_plotCurve
+    PlotSeriesData *m_data;
+    int m_columns;
+
+    // last m_meanSamples values, with their running mean and sum of squared deviations
+    QVector<double> m_history;
+    int m_historyHead;
+    int m_historyCount;
+    double m_mean;
+    double m_m2;
+    int m_resyncCount;
 
     UAVObject *m_object;
     UAVObjectField *m_field;
@@ -127,7 +218,8 @@ protected:
     bool m_isVisible;
     QPen m_pen;
     bool m_isEnumPlot;
-    virtual void calcMathFunction(double currentValue);
+    virtual double calcMathFunction(double currentValue);
+    void resetMathFunction();
     QwtPlotMarker *createMarker(QString value);
 };
 
@@ -142,7 +234,8 @@ public:
                        int scaleFactor, int meanSamples, QString mathFunction,
                        double plotDataSize, QPen pen, bool antialiased)
         : PlotData(object, field, element, scaleFactor, meanSamples,
-                   mathFunction, plotDataSize, pen, antialiased) {}
+                   mathFunction, plotDataSize, pen, antialiased,
+                   new PlotSeriesData(true, qMax(1, (int)plotDataSize))) {}
     ~SequentialPlotData() {}
 
     bool append(UAVObject *obj);
@@ -163,7 +256,8 @@ public:
                    int scaleFactor, int meanSamples, QString mathFunction,
                    double plotDataSize, QPen pen, bool antialiased)
         : PlotData(object, field, element, scaleFactor, meanSamples,
-                   mathFunction, plotDataSize, pen, antialiased)
+                   mathFunction, plotDataSize, pen, antialiased,
+                   new PlotSeriesData(false))
     {}
     ~ChronoPlotData() {}
 
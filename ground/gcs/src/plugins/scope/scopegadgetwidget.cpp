@@ -430,7 +430,9 @@ void ScopeGadgetWidget::replotNewData()
     }
 
     QMutexLocker locker(&m_mutex);
+    int columns = canvas()->width();
     foreach(PlotData * plotData, m_curvesData.values()) {
+        plotData->setResolution(columns);
         plotData->removeStaleData();
         plotData->updatePlotData();
     }
@@ -60,6 +60,7 @@ MonitorWidget *MonitorGadgetFactory::createMonitorWidget(QWidget *parent)
     connect(tm, SIGNAL(connected()), widget, SLOT(telemetryConnected()));
     connect(tm, SIGNAL(disconnected()), widget, SLOT(telemetryDisconnected()));
     connect(tm, SIGNAL(telemetryUpdated(double, double)), widget, SLOT(telemetryUpdated(double, double)));
+    connect(tm, SIGNAL(connectTimeMeasured(int)), widget, SLOT(telemetryConnectTime(int)));
 
     // and connect widget to connection manager (for retro compatibility)
     Core::ConnectionManager *cm = Core::ICore::instance()->connectionManager();
@@ -68,6 +69,7 @@ MonitorWidget *MonitorGadgetFactory::createMonitorWidget(QWidget *parent)
     connect(cm, SIGNAL(deviceDisconnected()), widget, SLOT(telemetryDisconnected()));
 
     if (tm->isConnected()) {
+        widget->telemetryConnectTime(tm->connectTime());
         widget->telemetryConnected();
     }
 
@@ -174,7 +174,8 @@ MonitorWidget::MonitorWidget(QWidget *parent) :
         // scene->setSceneRect(graph->boundingRect());
     }
 
-    connected = false;
+    connected   = false;
+    connectTime = -1;
 
     setMin(0.0);
     setMax(1200.0);
@@ -203,7 +204,7 @@ void MonitorWidget::telemetryConnected()
     qDebug() << "telemetry connected";
     if (!connected) {
         // flash the lights
-        setToolTip(tr("Connected"));
+        setToolTip(connectTime < 0 ? tr("Connected") : tr("Connected in %1 ms").arg(connectTime));
         telemetryUpdated(maxValue, maxValue);
         connected = true;
     }
@@ -224,6 +225,14 @@ void MonitorWidget::telemetryDisconnected()
     }
 }
 
+/*!
+   \brief Called before telemetryConnected() with the time the connection took
+ */
+void MonitorWidget::telemetryConnectTime(int msecs)
+{
+    connectTime = msecs;
+}
+
 /*!
    \brief Called by the UAVObject which got updated
 
@@ -235,7 +244,11 @@ void MonitorWidget::telemetryUpdated(double txRate, double rxRate)
     double rxIndex = (rxRate - minValue) / (maxValue - minValue) * rxNodes.count();
 
     if (connected) {
-        this->setToolTip(QString("Tx: %0 bytes/s, Rx: %1 bytes/s").arg(txRate).arg(rxRate));
+        QString toolTip = QString("Tx: %0 bytes/s, Rx: %1 bytes/s").arg(txRate).arg(rxRate);
+        if (connectTime >= 0) {
+            toolTip += tr(", connected in %1 ms").arg(connectTime);
+        }
+        this->setToolTip(toolTip);
     }
 
     for (int i = 0; i < txNodes.count(); i++) {
@@ -38,6 +38,7 @@ public slots:
     void telemetryConnected();
     void telemetryDisconnected();
     void telemetryUpdated(double txRate, double rxRate);
+    void telemetryConnectTime(int msecs);
 
 protected:
     void showEvent(QShowEvent *event);
@@ -45,6 +46,7 @@ protected:
 
 private:
     bool connected;
+    int connectTime; // ms the last connection took, -1 if unknown
 
     double minValue;
     double maxValue;
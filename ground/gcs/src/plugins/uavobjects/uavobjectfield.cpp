@@ -34,6 +34,54 @@
 #include <QJsonObject>
 #include <QJsonArray>
 
+#include <limits>
+
+template<typename S, typename T> static inline T readAs(const quint8 *element)
+{
+    S value;
+
+    memcpy(&value, element, sizeof(S));
+    return static_cast<T>(value);
+}
+
+// Round like QVariant does when storing a floating point value in an integer
+// field. Overloaded rather than a qRound64() call in a conditional, qRound64()
+// only takes floating point values and both branches get instantiated.
+static inline qint64 toInteger(double value)
+{
+    return qRound64(value);
+}
+static inline qint64 toInteger(float value)
+{
+    return qRound64(value);
+}
+static inline qint64 toInteger(qint32 value)
+{
+    return value;
+}
+static inline qint64 toInteger(quint32 value)
+{
+    return value;
+}
+static inline qint64 toInteger(qint64 value)
+{
+    return value;
+}
+
+template<typename S, typename T> static inline void writeAs(quint8 *element, T value)
+{
+    S tmp = std::numeric_limits<S>::is_integer ? static_cast<S>(toInteger(value)) : static_cast<S>(value);
+
+    memcpy(element, &tmp, sizeof(S));
+}
+
+template<typename S> static inline void copyAs(const quint8 *elements, quint32 count, double *out)
+{
+    for (quint32 index = 0; index < count; ++index) {
+        out[index] = readAs<S, double>(&elements[sizeof(S) * index]);
+    }
+}
+
 UAVObjectField::UAVObjectField(const QString & name, const QString & description, const QString & units, FieldType type, quint32 numElements, const QStringList & options, const QString &limits)
 {
     QStringList elementNames;
@@ -1184,10 +1232,166 @@ void UAVObjectField::setValue(const QVariant & value, quint32 index)
 
 double UAVObjectField::getDouble(quint32 index)
 {
+    if (isNumeric()) {
+        return get<double>(index);
+    }
     return getValue(index).toDouble();
 }
 
 void UAVObjectField::setDouble(double value, quint32 index)
 {
-    setValue(QVariant(value), index);
+    if (isNumeric()) {
+        set<double>(index, value);
+    } else {
+        setValue(QVariant(value), index);
+    }
+}
+
+template<typename T> T UAVObjectField::get(quint32 index)
+{
+    QMutexLocker locker(obj->getMutex());
+
+    // Check that index is not out of bounds
+    if (index >= numElements) {
+        return T();
+    }
+    const quint8 *element = &data[offset + numBytesPerElement * index];
+    switch (type) {
+    case INT8:
+        return readAs<qint8, T>(element);
+
+    case INT16:
+        return readAs<qint16, T>(element);
+
+    case INT32:
+        return readAs<qint32, T>(element);
+
+    case UINT8:
+    case ENUM:
+        return readAs<quint8, T>(element);
+
+    case UINT16:
+        return readAs<quint16, T>(element);
+
+    case UINT32:
+        return readAs<quint32, T>(element);
+
+    case FLOAT32:
+        return readAs<float, T>(element);
+
+    case BITFIELD:
+        return static_cast<T>((data[offset + numBytesPerElement * (index / 8)] >> (index % 8)) & 1);
+
+    case STRING:
+        break;
+    }
+    return T();
+}
+
+template<typename T> void UAVObjectField::set(quint32 index, T value)
+{
+    QMutexLocker locker(obj->getMutex());
+
+    // Check that index is not out of bounds
+    if (index >= numElements) {
+        return;
+    }
+    // Update value if the access mode permits
+    if (UAVObject::GetGcsAccess(obj->getMetadata()) != UAVObject::ACCESS_READWRITE) {
+        return;
+    }
+    quint8 *element = &data[offset + numBytesPerElement * index];
+    switch (type) {
+    case INT8:
+        writeAs<qint8>(element, value);
+        break;
+    case INT16:
+        writeAs<qint16>(element, value);
+        break;
+    case INT32:
+        writeAs<qint32>(element, value);
+        break;
+    case UINT8:
+        writeAs<quint8>(element, value);
+        break;
+    case UINT16:
+        writeAs<quint16>(element, value);
+        break;
+    case UINT32:
+        writeAs<quint32>(element, value);
+        break;
+    case FLOAT32:
+        writeAs<float>(element, value);
+        break;
+    case ENUM:
+    {
+        qint64 option = toInteger(value);
+        // Default to 0 on invalid values.
+        writeAs<quint8>(element, (option >= 0 && option < options.length()) ? option : 0);
+        break;
+    }
+    case BITFIELD:
+    {
+        quint8 *bits = &data[offset + numBytesPerElement * (index / 8)];
+        *bits = (*bits & ~(1 << (index % 8))) | ((value != 0 ? 1 : 0) << (index % 8));
+        break;
+    }
+    case STRING:
+        break;
+    }
+}
+
+
+template double UAVObjectField::get<double>(quint32 index);
+template float UAVObjectField::get<float>(quint32 index);
+template qint32 UAVObjectField::get<qint32>(quint32 index);
+template quint32 UAVObjectField::get<quint32>(quint32 index);
+template void UAVObjectField::set<double>(quint32 index, double value);
+template void UAVObjectField::set<float>(quint32 index, float value);
+template void UAVObjectField::set<qint32>(quint32 index, qint32 value);
+template void UAVObjectField::set<quint32>(quint32 index, quint32 value);
+
+/**
+ * Convert all elements of a numeric field to doubles with a single lock of
+ * the object, enum fields are converted to their option index.
+ * Returns the number of elements written to out.
+ */
+quint32 UAVObjectField::copyElements(double *out)
+{
+    QMutexLocker locker(obj->getMutex());
+
+    const quint8 *elements = &data[offset];
+
+    switch (type) {
+    case INT8:
+        copyAs<qint8>(elements, numElements, out);
+        break;
+    case INT16:
+        copyAs<qint16>(elements, numElements, out);
+        break;
+    case INT32:
+        copyAs<qint32>(elements, numElements, out);
+        break;
+    case UINT8:
+    case ENUM:
+        copyAs<quint8>(elements, numElements, out);
+        break;
+    case UINT16:
+        copyAs<quint16>(elements, numElements, out);
+        break;
+    case UINT32:
+        copyAs<quint32>(elements, numElements, out);
+        break;
+    case FLOAT32:
+        copyAs<float>(elements, numElements, out);
+        break;
+    case BITFIELD:
+        for (quint32 index = 0; index < numElements; ++index) {
+            out[index] = (elements[index / 8] >> (index % 8)) & 1;
+        }
+        break;
+    case STRING:
+        return 0;
+    }
+    return numElements;
 }
@@ -73,6 +73,12 @@ public:
     void setValue(const QVariant & data, quint32 index = 0);
     double getDouble(quint32 index = 0);
     void setDouble(double value, quint32 index = 0);
+    // Typed accessors, without the QVariant boxing of getValue() and setValue()
+    // Enum fields are accessed by option index, string fields read as zero and ignore writes.
+    // Instantiated for double, float, qint32 and quint32.
+    template<typename T> T get(quint32 index = 0);
+    template<typename T> void set(quint32 index, T value);
+    quint32 copyElements(double *out);
     quint32 getDataOffset();
     quint32 getNumBytes();
     bool isNumeric();
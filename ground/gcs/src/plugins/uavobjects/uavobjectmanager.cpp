@@ -36,10 +36,12 @@
 UAVObjectManager::UAVObjectManager()
 {
     mutex = new QMutex(QMutex::Recursive);
+    lock  = new QReadWriteLock();
 }
 
 UAVObjectManager::~UAVObjectManager()
 {
+    delete lock;
     delete mutex;
 }
 
@@ -54,54 +56,54 @@ bool UAVObjectManager::registerObject(UAVDataObject *obj)
     QMutexLocker locker(mutex);
 
     // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx) {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0 && objects[objidx][0]->getObjID() == obj->getObjID()) {
-            // Check if this is a single instance object, if yes we can not add a new instance
-            if (obj->isSingleInstance()) {
-                return false;
-            }
-            // The object type has alredy been added, so now we need to initialize the new instance with the appropriate id
-            // There is a single metaobject for all object instances of this type, so no need to create a new one
-            // Get object type metaobject from existing instance
-            UAVDataObject *refObj = dynamic_cast<UAVDataObject *>(objects[objidx][0]);
-            if (refObj == NULL) {
-                return false;
-            }
-            UAVMetaObject *mobj = refObj->getMetaObject();
-            // If the instance ID is specified and not at the default value (0) then we need to make sure
-            // that there are no gaps in the instance list. If gaps are found then then additional instances
-            // will be created.
-            if ((obj->getInstID() > 0) && (obj->getInstID() < MAX_INSTANCES)) {
-                for (int instidx = 0; instidx < objects[objidx].length(); ++instidx) {
-                    if (objects[objidx][instidx]->getInstID() == obj->getInstID()) {
-                        // Instance conflict, do not add
-                        return false;
-                    }
-                }
-                // Check if there are any gaps between the requested instance ID and the ones in the list,
-                // if any then create the missing instances.
-                for (quint32 instidx = objects[objidx].length(); instidx < obj->getInstID(); ++instidx) {
-                    UAVDataObject *cobj = obj->clone(instidx);
-                    cobj->initialize(mobj);
-                    objects[objidx].append(cobj);
-                    getObject(cobj->getObjID())->emitNewInstance(cobj);
-                    emit newInstance(cobj);
+    // (objects is only modified by this thread while the mutex is held, no need to lock for reading)
+    int objidx = findObjectIndex(NULL, obj->getObjID());
+
+    if (objidx >= 0) {
+        // Check if this is a single instance object, if yes we can not add a new instance
+        if (obj->isSingleInstance()) {
+            return false;
+        }
+        // The object type has alredy been added, so now we need to initialize the new instance with the appropriate id
+        // There is a single metaobject for all object instances of this type, so no need to create a new one
+        // Get object type metaobject from existing instance
+        UAVDataObject *refObj = dynamic_cast<UAVDataObject *>(objects[objidx][0]);
+        if (refObj == NULL) {
+            return false;
+        }
+        UAVMetaObject *mobj = refObj->getMetaObject();
+        // If the instance ID is specified and not at the default value (0) then we need to make sure
+        // that there are no gaps in the instance list. If gaps are found then then additional instances
+        // will be created.
+        if ((obj->getInstID() > 0) && (obj->getInstID() < MAX_INSTANCES)) {
+            for (int instidx = 0; instidx < objects[objidx].length(); ++instidx) {
+                if (objects[objidx][instidx]->getInstID() == obj->getInstID()) {
+                    // Instance conflict, do not add
+                    return false;
                 }
-                // Finally, initialize the actual object instance
-                obj->initialize(mobj);
-            } else if (obj->getInstID() == 0) {
-                // Assign the next available ID and initialize the object instance
-                obj->initialize(objects[objidx].length(), mobj);
-            } else {
-                return false;
             }
-            // Add the actual object instance in the list
-            objects[objidx].append(obj);
-            getObject(obj->getObjID())->emitNewInstance(obj);
-            emit newInstance(obj);
-            return true;
+            // Check if there are any gaps between the requested instance ID and the ones in the list,
+            // if any then create the missing instances.
+            for (quint32 instidx = objects[objidx].length(); instidx < obj->getInstID(); ++instidx) {
+                UAVDataObject *cobj = obj->clone(instidx);
+                cobj->initialize(mobj);
+                addInstance(objidx, cobj);
+                refObj->emitNewInstance(cobj);
+                emit newInstance(cobj);
+            }
+            // Finally, initialize the actual object instance
+            obj->initialize(mobj);
+        } else if (obj->getInstID() == 0) {
+            // Assign the next available ID and initialize the object instance
+            obj->initialize(objects[objidx].length(), mobj);
+        } else {
+            return false;
         }
+        // Add the actual object instance in the list
+        addInstance(objidx, obj);
+        refObj->emitNewInstance(obj);
+        emit newInstance(obj);
+        return true;
     }
     // If this point is reached then this is the first time this object type (ID) is added in the list
     // create a new list of the instances, add in the object collection and create the object's metaobject
@@ -122,17 +124,42 @@ void UAVObjectManager::addObject(UAVObject *obj)
     // Add to list
     QList<UAVObject *> list;
     list.append(obj);
-    objects.append(list);
+    {
+        QWriteLocker locker(lock);
+        objectsById.insert(obj->getObjID(), objects.length());
+        objectsByName.insert(obj->getName(), objects.length());
+        objects.append(list);
+    }
     emit newObject(obj);
 }
 
+void UAVObjectManager::addInstance(int objidx, UAVObject *obj)
+{
+    QWriteLocker locker(lock);
+
+    objects[objidx].append(obj);
+}
+
+/**
+ * Find the position of an object type in the objects list, by name if \a name
+ * is not NULL or by object ID otherwise.
+ * @returns The index in the objects list or -1 if not found
+ */
+int UAVObjectManager::findObjectIndex(const QString *name, quint32 objId) const
+{
+    if (name != NULL) {
+        return objectsByName.value(*name, -1);
+    }
+    return objectsById.value(objId, -1);
+}
+
 /**
  * Get all objects. A two dimentional QList is returned. Objects are grouped by
  * instances of the same object type.
  */
 QList< QList<UAVObject *> > UAVObjectManager::getObjects()
 {
-    QMutexLocker locker(mutex);
+    QReadLocker locker(lock);
 
     return objects;
 }
@@ -142,7 +169,7 @@ QList< QList<UAVObject *> > UAVObjectManager::getObjects()
  */
 QList< QList<UAVDataObject *> > UAVObjectManager::getDataObjects()
 {
-    QMutexLocker locker(mutex);
+    QReadLocker locker(lock);
 
     QList< QList<UAVDataObject *> > dObjects;
 
@@ -175,7 +202,7 @@ QList< QList<UAVDataObject *> > UAVObjectManager::getDataObjects()
  */
 QList <QList<UAVMetaObject *> > UAVObjectManager::getMetaObjects()
 {
-    QMutexLocker locker(mutex);
+    QReadLocker locker(lock);
 
     QList< QList<UAVMetaObject *> > mObjects;
 
@@ -226,19 +253,20 @@ UAVObject *UAVObjectManager::getObject(quint32 objId, quint32 instId)
  */
 UAVObject *UAVObjectManager::getObject(const QString *name, quint32 objId, quint32 instId)
 {
-    QMutexLocker locker(mutex);
+    QReadLocker locker(lock);
 
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx) {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0) {
-            if ((name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId)) {
-                // Look for the requested instance ID
-                for (int instidx = 0; instidx < objects[objidx].length(); ++instidx) {
-                    if (objects[objidx][instidx]->getInstID() == instId) {
-                        return objects[objidx][instidx];
-                    }
-                }
+    int objidx = findObjectIndex(name, objId);
+
+    if (objidx >= 0) {
+        const QList<UAVObject *> &instances = objects.at(objidx);
+        // Instances are normally stored in instance ID order, try a direct access first
+        if (instId < (quint32)instances.length() && instances.at(instId)->getInstID() == instId) {
+            return instances.at(instId);
+        }
+        // Look for the requested instance ID
+        for (int instidx = 0; instidx < instances.length(); ++instidx) {
+            if (instances.at(instidx)->getInstID() == instId) {
+                return instances.at(instidx);
             }
         }
     }
@@ -268,16 +296,12 @@ QList<UAVObject *> UAVObjectManager::getObjectInstances(quint32 objId)
  */
 QList<UAVObject *> UAVObjectManager::getObjectInstances(const QString *name, quint32 objId)
 {
-    QMutexLocker locker(mutex);
+    QReadLocker locker(lock);
 
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx) {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0) {
-            if ((name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId)) {
-                return objects[objidx];
-            }
-        }
+    int objidx = findObjectIndex(name, objId);
+
+    if (objidx >= 0) {
+        return objects.at(objidx);
     }
     // If this point is reached then the requested object could not be found
     return QList<UAVObject *>();
@@ -362,16 +386,12 @@ void UAVObjectManager::fromJson(const QJsonObject &jsonObject, QList<UAVObject *
  */
 qint32 UAVObjectManager::getNumInstances(const QString *name, quint32 objId)
 {
-    QMutexLocker locker(mutex);
+    QReadLocker locker(lock);
 
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx) {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0) {
-            if ((name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId)) {
-                return objects[objidx].length();
-            }
-        }
+    int objidx = findObjectIndex(name, objId);
+
+    if (objidx >= 0) {
+        return objects.at(objidx).length();
     }
     // If this point is reached then the requested object could not be found
     return -1;
@@ -33,8 +33,10 @@
 #include "uavdataobject.h"
 #include "uavmetaobject.h"
 #include <QList>
+#include <QHash>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QReadWriteLock>
 #include <QJsonObject>
 
 class UAVOBJECTS_EXPORT UAVObjectManager : public QObject {
@@ -69,9 +71,17 @@ private:
     static const quint32 MAX_INSTANCES = 1000;
 
     QList< QList<UAVObject *> > objects;
+    // indices into objects, kept in sync by addObject()
+    QHash<quint32, int> objectsById;
+    QHash<QString, int> objectsByName;
+    // serializes writers, held while signals are emitted
     QMutex *mutex;
+    // protects objects and its indices, only held for the actual accesses
+    QReadWriteLock *lock;
 
     void addObject(UAVObject *obj);
+    void addInstance(int objidx, UAVObject *obj);
+    int findObjectIndex(const QString *name, quint32 objId) const;
     UAVObject *getObject(const QString *name, quint32 objId, quint32 instId);
     QList<UAVObject *> getObjectInstances(const QString *name, quint32 objId);
     qint32 getNumInstances(const QString *name, quint32 objId);
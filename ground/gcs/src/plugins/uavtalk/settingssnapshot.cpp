@@ -0,0 +1,179 @@
+/**
+ ******************************************************************************
+ *
+ * @file       settingssnapshot.cpp
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief On disk copy of the settings and metaobjects of a board
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "settingssnapshot.h"
+#include "utils/pathutils.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+SettingsSnapshot::SettingsSnapshot(UAVObjectManager *objMngr, const QByteArray &boardSerial) :
+    objMngr(objMngr),
+    fileName(Utils::GetStoragePath() + "settings" + QDir::separator() + boardSerial.toHex() + ".uavs")
+{}
+
+/**
+ * Only settings and metaobjects are kept, data objects can change at any time
+ */
+bool SettingsSnapshot::isCached(UAVObject *obj)
+{
+    UAVDataObject *dobj = dynamic_cast<UAVDataObject *>(obj);
+
+    return dynamic_cast<UAVMetaObject *>(obj) != NULL || (dobj != NULL && dobj->isSettingsObject());
+}
+
+/**
+ * Hash of one instance, the same as instanceHash() in flight/uavobjects/uavobjectmanager.c:
+ * FNV-1a of the object id, the instance id (little endian) and the packed data
+ */
+quint32 SettingsSnapshot::instanceHash(quint32 objId, quint16 instId, const QByteArray &data)
+{
+    const quint8 key[6] = {
+        (quint8)objId, (quint8)(objId >> 8), (quint8)(objId >> 16), (quint8)(objId >> 24),
+        (quint8)instId, (quint8)(instId >> 8)
+    };
+    quint32 hash = 2166136261u;
+
+    for (unsigned int i = 0; i < sizeof(key); i++) {
+        hash = (hash ^ key[i]) * 16777619u;
+    }
+    for (int i = 0; i < data.size(); i++) {
+        hash = (hash ^ (quint8)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Unpack the snapshot into the objects if it matches the settings hash of the board.
+ * Nothing is touched unless the whole snapshot is valid.
+ */
+bool SettingsSnapshot::load(quint32 settingsHash)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic, version, hash, count;
+    stream >> magic >> version >> hash >> count;
+    if (stream.status() != QDataStream::Ok || magic != MAGIC || version != VERSION || hash != settingsHash) {
+        return false;
+    }
+
+    QList<quint32> objIds;
+    QList<quint16> instIds;
+    QList<QByteArray> datas;
+    quint32 sum = 0;
+    for (quint32 n = 0; n < count; ++n) {
+        quint32 objId;
+        quint16 instId;
+        QByteArray data;
+        stream >> objId >> instId >> data;
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+        // the object definitions of this GCS must match the ones the snapshot was taken with
+        UAVObject *typeObj = objMngr->getObject(objId);
+        if (typeObj == NULL || typeObj->getNumBytes() != (quint32)data.size()) {
+            return false;
+        }
+        sum += instanceHash(objId, instId, data);
+        objIds << objId;
+        instIds << instId;
+        datas << data;
+    }
+    if (sum != settingsHash) {
+        qWarning() << "SettingsSnapshot - content does not match its hash" << fileName;
+        return false;
+    }
+
+    for (int n = 0; n < objIds.size(); ++n) {
+        UAVObject *obj = objMngr->getObject(objIds[n], instIds[n]);
+        if (obj == NULL) {
+            // create missing instances, like UAVTalk does when receiving them
+            UAVDataObject *dataObj = dynamic_cast<UAVDataObject *>(objMngr->getObject(objIds[n]));
+            if (dataObj == NULL) {
+                continue;
+            }
+            UAVDataObject *instObj = dataObj->clone(instIds[n]);
+            if (!objMngr->registerObject(instObj)) {
+                continue;
+            }
+            obj = instObj;
+        }
+        obj->unpack((const quint8 *)datas[n].constData());
+        obj->setIsKnown(true);
+    }
+    qDebug() << "SettingsSnapshot - loaded" << objIds.size() << "objects from" << fileName;
+    return true;
+}
+
+/**
+ * Save the settings and metaobjects known to the board, but only if they are
+ * exactly what the board has, i.e. they hash to the board's settings hash.
+ */
+bool SettingsSnapshot::save(quint32 settingsHash)
+{
+    QList<UAVObject *> objs;
+    QList<QByteArray> datas;
+    quint32 sum = 0;
+
+    foreach(QList<UAVObject *> instances, objMngr->getObjects()) {
+        foreach(UAVObject * obj, instances) {
+            if (!obj->isKnown() || !isCached(obj)) {
+                continue;
+            }
+            QByteArray data(obj->getNumBytes(), 0);
+            obj->pack((quint8 *)data.data());
+            sum += instanceHash(obj->getObjID(), obj->getInstID(), data);
+            objs << obj;
+            datas << data;
+        }
+    }
+    if (sum != settingsHash) {
+        qDebug() << "SettingsSnapshot - retrieved objects do not match the settings hash of the board, not saved";
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream << MAGIC << VERSION << settingsHash << (quint32)objs.size();
+    for (int n = 0; n < objs.size(); ++n) {
+        stream << objs[n]->getObjID() << (quint16)objs[n]->getInstID() << datas[n];
+    }
+    return file.commit();
+}
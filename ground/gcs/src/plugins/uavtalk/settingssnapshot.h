@@ -0,0 +1,59 @@
+/**
+ ******************************************************************************
+ *
+ * @file       settingssnapshot.h
+ * @author     The LibrePilot Project, http://www.librepilot.org Copyright (C) 2016.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief On disk copy of the settings and metaobjects of a board
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef SETTINGSSNAPSHOT_H
+#define SETTINGSSNAPSHOT_H
+
+#include <QByteArray>
+#include <QString>
+#include "uavobjectmanager.h"
+
+/**
+ * Keeps the settings and metaobjects retrieved from a board on disk, one
+ * file per board serial. The firmware publishes a hash of all its settings
+ * and metaobjects (FlightTelemetryStats.SettingsHash), a snapshot is only
+ * used when the same hash computed over its content matches it.
+ */
+class SettingsSnapshot {
+public:
+    SettingsSnapshot(UAVObjectManager *objMngr, const QByteArray &boardSerial);
+
+    bool load(quint32 settingsHash);
+    bool save(quint32 settingsHash);
+
+    static bool isCached(UAVObject *obj);
+    static quint32 instanceHash(quint32 objId, quint16 instId, const QByteArray &data);
+
+private:
+    static const quint32 MAGIC   = 0x55534E50; // "USNP"
+    static const quint32 VERSION = 1;
+
+    UAVObjectManager *objMngr;
+    QString fileName;
+};
+
+#endif // SETTINGSSNAPSHOT_H
@@ -32,7 +32,7 @@
 #include <coreplugin/icore.h>
 #include <coreplugin/threadmanager.h>
 
-TelemetryManager::TelemetryManager() : m_connectionState(TELEMETRY_DISCONNECTED)
+TelemetryManager::TelemetryManager() : m_connectionState(TELEMETRY_DISCONNECTED), m_connectTime(-1)
 {
     moveToThread(Core::ICore::instance()->threadManager()->getRealTimeThread());
     // Get UAVObjectManager instance
@@ -57,6 +57,11 @@ TelemetryManager::ConnectionState TelemetryManager::connectionState() const
     return m_connectionState;
 }
 
+int TelemetryManager::connectTime() const
+{
+    return m_connectTime;
+}
+
 void TelemetryManager::start(QIODevice *dev)
 {
     m_connectionState = TELEMETRY_CONNECTING;
@@ -102,6 +107,7 @@ void TelemetryManager::onStart()
     connect(m_telemetryMonitor, SIGNAL(connected()), this, SLOT(onConnect()));
     connect(m_telemetryMonitor, SIGNAL(disconnected()), this, SLOT(onDisconnect()));
     connect(m_telemetryMonitor, SIGNAL(telemetryUpdated(double, double)), this, SLOT(onTelemetryUpdate(double, double)));
+    connect(m_telemetryMonitor, SIGNAL(connectTimeMeasured(int)), this, SLOT(onConnectTimeMeasured(int)));
 }
 
 void TelemetryManager::stop()
@@ -142,6 +148,12 @@ void TelemetryManager::onTelemetryUpdate(double txRate, double rxRate)
     emit telemetryUpdated(txRate, rxRate);
 }
 
+void TelemetryManager::onConnectTimeMeasured(int msecs)
+{
+    m_connectTime = msecs;
+    emit connectTimeMeasured(msecs);
+}
+
 IODeviceReader::IODeviceReader(UAVTalk *uavTalk) : m_uavTalk(uavTalk)
 {}
 
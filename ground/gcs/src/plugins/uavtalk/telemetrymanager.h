@@ -55,6 +55,8 @@ public:
     void stop();
     bool isConnected() const;
     ConnectionState connectionState() const;
+    // Time the last connection took to complete in ms, -1 if none completed yet
+    int connectTime() const;
 
 signals:
     void connecting();
@@ -62,6 +64,7 @@ signals:
     void disconnecting();
     void disconnected();
     void telemetryUpdated(double txRate, double rxRate);
+    void connectTimeMeasured(int msecs);
     void myStart();
     void myStop();
 
@@ -69,6 +72,7 @@ private slots:
     void onConnect();
     void onDisconnect();
     void onTelemetryUpdate(double txRate, double rxRate);
+    void onConnectTimeMeasured(int msecs);
     void onStart();
     void onStop();
 
@@ -79,6 +83,7 @@ private:
     TelemetryMonitor *m_telemetryMonitor;
     QIODevice *m_telemetryDevice;
     ConnectionState m_connectionState;
+    int m_connectTime;
     QThread m_telemetryReaderThread;
 };
 
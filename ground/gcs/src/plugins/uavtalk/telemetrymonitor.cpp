@@ -26,6 +26,7 @@
  */
 
 #include "telemetrymonitor.h"
+#include "settingssnapshot.h"
 #include "coreplugin/connectionmanager.h"
 #include "coreplugin/icore.h"
 
@@ -39,9 +40,16 @@ TelemetryMonitor::TelemetryMonitor(UAVObjectManager *objMngr, Telemetry *tel) :
     flightStatsObj(FlightTelemetryStats::GetInstance(objMngr)),
     firmwareIAPObj(FirmwareIAPObj::GetInstance(objMngr)),
     statsTimer(new QTimer(this)),
-    objPending(NULL),
     mutex(new QMutex(QMutex::Recursive)),
-    connectionTimer(new QTime())
+    connectionTimer(new QTime()),
+    retrieveWindow(RETRIEVE_WINDOW_INITIAL),
+    retrieveWindowCompleted(0),
+    retrieveCount(0),
+    retrieveFailed(0),
+    retrieveRttMs(0),
+    settingsHash(0),
+    snapshotLookupPending(false),
+    snapshotCount(0)
 {
     // Listen for flight stats updates
     connect(flightStatsObj, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(flightStatsUpdated(UAVObject *)));
@@ -66,8 +74,8 @@ TelemetryMonitor::~TelemetryMonitor()
  */
 void TelemetryMonitor::startRetrievingObjects()
 {
-    // Clear object queue
-    queue.clear();
+    // Clear object queue and forget requests of a previous connection
+    stopRetrievingObjects();
     // Get all objects, add metaobjects, settings and data objects with OnChange update mode to the queue
     QList< QList<UAVObject *> > objs = objMngr->getObjects();
     for (int n = 0; n < objs.length(); ++n) {
@@ -87,47 +95,122 @@ void TelemetryMonitor::startRetrievingObjects()
             }
         }
     }
-    // Start retrieving
+    // Start retrieving, requests for distinct objects can be in flight at the same time
     qDebug() << tr("Starting to retrieve meta and settings objects from the autopilot (%1 objects)")
         .arg(queue.length());
+    retrieveFailed = 0;
+    retrieveRttMs  = 0;
+    // start over, the link may not be the one of the previous connection
+    retrieveWindow = RETRIEVE_WINDOW_INITIAL;
+    retrieveWindowCompleted = 0;
+    retrievalTimer.start();
+
+    // Settings and metaobjects may be available from a snapshot of an earlier
+    // connection, the board serial is needed to find it so get that first
+    settingsHash  = flightStatsObj->getData().SettingsHash;
+    snapshotCount = 0;
+    snapshotLookupPending = settingsHash != 0;
+    if (snapshotLookupPending) {
+        queue.removeAll(firmwareIAPObj);
+        queue.prepend(firmwareIAPObj);
+    }
+    retrieveCount = queue.length();
     retrieveNextObject();
 }
 
+/**
+ * Serial number of the board, empty if not known
+ */
+QByteArray TelemetryMonitor::boardSerial()
+{
+    FirmwareIAPObj::DataFields firmwareIapData = firmwareIAPObj->getData();
+    QByteArray serial((const char *)firmwareIapData.CPUSerial, FirmwareIAPObj::CPUSERIAL_NUMELEM);
+
+    return serial.count('\0') == serial.size() ? QByteArray() : serial;
+}
+
+/**
+ * Load the settings snapshot of the board if its settings did not change
+ * since it was taken and drop settings and metaobjects from the queue
+ */
+void TelemetryMonitor::loadSettingsSnapshot()
+{
+    QByteArray serial = boardSerial();
+
+    if (serial.isEmpty() || !SettingsSnapshot(objMngr, serial).load(settingsHash)) {
+        return;
+    }
+    QQueue<UAVObject *> remaining;
+    foreach(UAVObject * obj, queue) {
+        if (SettingsSnapshot::isCached(obj)) {
+            ++snapshotCount;
+        } else {
+            remaining.enqueue(obj);
+        }
+    }
+    queue = remaining;
+}
+
 /**
  * Cancel the object retrieval
  */
 void TelemetryMonitor::stopRetrievingObjects()
 {
-    qDebug("Object retrieval has been cancelled");
+    if (!queue.isEmpty() || !objPending.isEmpty()) {
+        qDebug("Object retrieval has been cancelled");
+    }
     queue.clear();
+    foreach(UAVObject * obj, objPending.keys()) {
+        obj->disconnect(this);
+    }
+    objPending.clear();
 }
 
 /**
- * Retrieve the next object in the queue
+ * Retrieve objects from the queue until the request window is full
  */
 void TelemetryMonitor::retrieveNextObject()
 {
-    // If queue is empty return
-    if (queue.isEmpty()) {
-        qDebug("Object retrieval completed");
+    // If all objects have been retrieved return
+    if (queue.isEmpty() && objPending.isEmpty()) {
+        qDebug() << tr("Object retrieval completed in %1 ms (%2 objects, %3 from snapshot, %4 failed, window %5, rtt %6 ms)")
+            .arg(retrievalTimer.elapsed()).arg(retrieveCount).arg(snapshotCount).arg(retrieveFailed).arg(retrieveWindow).arg(retrieveRttMs);
+        if (settingsHash && !snapshotCount && !boardSerial().isEmpty()) {
+            SettingsSnapshot(objMngr, boardSerial()).save(settingsHash);
+        }
         if (firmwareIAPObj->getBoardType()) {
-            emit connected();
+            reportConnected();
         } else {
             connect(firmwareIAPObj, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(firmwareIAPUpdated(UAVObject *)));
         }
         return;
     }
 
-    // Get next object from the queue
-    UAVObject *obj = queue.dequeue();
-    // qDebug( tr("Retrieving object: %1").arg(obj->getName()) );
+    // Nothing else is requested until the snapshot lookup is done
+    while (!queue.isEmpty() && objPending.size() < (snapshotLookupPending ? 1 : retrieveWindow)) {
+        // Get next object from the queue
+        UAVObject *obj = queue.dequeue();
+        // qDebug( tr("Retrieving object: %1").arg(obj->getName()) );
 
-    // Connect to object
-    connect(obj, SIGNAL(transactionCompleted(UAVObject *, bool)), this, SLOT(transactionCompleted(UAVObject *, bool)));
+        // Connect to object
+        connect(obj, SIGNAL(transactionCompleted(UAVObject *, bool)), this, SLOT(transactionCompleted(UAVObject *, bool)));
 
-    // Request update
-    obj->requestUpdate();
-    objPending = obj;
+        // Request update, the reply may arrive before requestUpdate() returns
+        objPending.insert(obj, retrievalTimer.elapsed());
+        obj->requestUpdate();
+    }
+}
+
+/**
+ * Emit connected() and report how long it took since the handshake started
+ */
+void TelemetryMonitor::reportConnected()
+{
+    int msecs = connectTimer.elapsed();
+
+    qDebug() << tr("Connection with the autopilot completed in %1 ms").arg(msecs);
+    emit connectTimeMeasured(msecs);
+    emit connected();
 }
 
 /**
@@ -135,17 +218,41 @@ void TelemetryMonitor::retrieveNextObject()
  */
 void TelemetryMonitor::transactionCompleted(UAVObject *obj, bool success)
 {
-    Q_UNUSED(success);
     QMutexLocker locker(mutex);
 
-    if (obj == objPending) {
+    if (objPending.contains(obj)) {
         // Disconnect from sending object
         obj->disconnect(this);
-        objPending = NULL;
+        qint64 rtt = retrievalTimer.elapsed() - objPending.take(obj);
+
+        // Adapt the number of requests in flight: halve it on failures, shrink it
+        // when replies queue up close to the request timeout, grow it by one
+        // after each window of quick replies
+        if (!success) {
+            ++retrieveFailed;
+            retrieveWindow = qMax(retrieveWindow / 2, (int)RETRIEVE_WINDOW_MIN);
+            retrieveWindowCompleted = 0;
+        } else {
+            retrieveRttMs = retrieveRttMs ? (7 * retrieveRttMs + rtt) / 8 : rtt;
+            if (rtt > RETRIEVE_RTT_LIMIT_MS) {
+                retrieveWindow = qMax(retrieveWindow - 1, (int)RETRIEVE_WINDOW_MIN);
+                retrieveWindowCompleted = 0;
+            } else if (++retrieveWindowCompleted >= retrieveWindow) {
+                retrieveWindow = qMin(retrieveWindow + 1, (int)RETRIEVE_WINDOW_MAX);
+                retrieveWindowCompleted = 0;
+            }
+        }
+
         // Process next object if telemetry is still available
         GCSTelemetryStats::DataFields gcsStats = gcsStatsObj->getData();
 
         if (gcsStats.Status == GCSTelemetryStats::STATUS_CONNECTED) {
+            if (obj == firmwareIAPObj && snapshotLookupPending) {
+                snapshotLookupPending = false;
+                if (success) {
+                    loadSettingsSnapshot();
+                }
+            }
             retrieveNextObject();
         } else {
             stopRetrievingObjects();
@@ -180,7 +287,7 @@ void TelemetryMonitor::firmwareIAPUpdated(UAVObject *obj)
 
     if (firmwareIAPObj->getBoardType() != 0) {
         disconnect(firmwareIAPObj);
-        emit connected();
+        reportConnected();
     }
 }
 
@@ -226,6 +333,7 @@ void TelemetryMonitor::processStatsUpdates()
     if (gcsStats.Status == GCSTelemetryStats::STATUS_DISCONNECTED) {
         // Request connection
         gcsStats.Status = GCSTelemetryStats::STATUS_HANDSHAKEREQ;
+        connectTimer.start();
     } else if (gcsStats.Status == GCSTelemetryStats::STATUS_HANDSHAKEREQ) {
         // Check for connection acknowledge
         if (flightStats.Status == FlightTelemetryStats::STATUS_HANDSHAKEACK) {
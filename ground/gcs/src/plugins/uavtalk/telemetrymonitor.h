@@ -30,6 +30,8 @@
 
 #include <QObject>
 #include <QQueue>
+#include <QHash>
+#include <QElapsedTimer>
 #include <QTimer>
 #include <QTime>
 #include <QMutex>
@@ -52,6 +54,8 @@ signals:
     void connected();
     void disconnected();
     void telemetryUpdated(double txRate, double rxRate);
+    // emitted before connected(), with the time the handshake and object retrieval took
+    void connectTimeMeasured(int msecs);
 
 public slots:
     void transactionCompleted(UAVObject *obj, bool success);
@@ -63,6 +67,13 @@ private:
     static const int STATS_UPDATE_PERIOD_MS  = 4000;
     static const int STATS_CONNECT_PERIOD_MS = 2000;
     static const int CONNECTION_TIMEOUT_MS   = 8000;
+    // Number of object requests kept in flight while retrieving objects,
+    // the window shrinks when round trips approach the telemetry request
+    // timeout (250ms) or requests fail, and grows while they do not
+    static const int RETRIEVE_WINDOW_MIN     = 1;
+    static const int RETRIEVE_WINDOW_INITIAL = 2;
+    static const int RETRIEVE_WINDOW_MAX     = 8;
+    static const int RETRIEVE_RTT_LIMIT_MS   = 150;
 
     UAVObjectManager *objMngr;
     Telemetry *tel;
@@ -71,13 +82,26 @@ private:
     FlightTelemetryStats *flightStatsObj;
     FirmwareIAPObj *firmwareIAPObj;
     QTimer *statsTimer;
-    UAVObject *objPending;
+    QHash<UAVObject *, qint64> objPending; // request time, see retrievalTimer
     QMutex *mutex;
     QTime *connectionTimer;
+    QElapsedTimer retrievalTimer;
+    QElapsedTimer connectTimer;
+    int retrieveWindow;
+    int retrieveWindowCompleted;
+    int retrieveCount;
+    int retrieveFailed;
+    qint64 retrieveRttMs;
+    quint32 settingsHash; // of the board, 0 if its firmware does not provide one
+    bool snapshotLookupPending;
+    int snapshotCount;
 
     void startRetrievingObjects();
     void retrieveNextObject();
     void stopRetrievingObjects();
+    QByteArray boardSerial();
+    void loadSettingsSnapshot();
+    void reportConnected();
 };
 
 #endif // TELEMETRYMONITOR_H
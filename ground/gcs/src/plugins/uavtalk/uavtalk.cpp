@@ -51,6 +51,7 @@ using namespace Utils;
  */
 UAVTalk::UAVTalk(QIODevice *iodev, UAVObjectManager *objMngr) : io(iodev), objMngr(objMngr), mutex(QMutex::Recursive)
 {
+    packetSource = dynamic_cast<Utils::PacketSource *>(iodev);
     rxState = STATE_SYNC;
     rxPacketLength = 0;
 
@@ -58,7 +59,8 @@ UAVTalk::UAVTalk(QIODevice *iodev, UAVObjectManager *objMngr) : io(iodev), objMn
 
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     Core::Internal::GeneralSettings *settings = pm->getObject<Core::Internal::GeneralSettings>();
-    useUDPMirror = settings->useUDPMirror();
+    // tools running UAVTalk without the Core plugin have no settings
+    useUDPMirror = settings && settings->useUDPMirror();
     qDebug() << "USE UDP:::::::::::." << useUDPMirror;
     if (useUDPMirror) {
         udpSocketTx = new QUdpSocket(this);
@@ -208,36 +210,112 @@ bool UAVTalk::objectTransaction(quint8 type, quint32 objId, quint16 instId, UAVO
  */
 void UAVTalk::processInputStream()
 {
-    quint8 tmp;
-
     if (io && io->isReadable()) {
         while (io->bytesAvailable() > 0) {
-            int ret = io->read((char *)&tmp, 1);
-            if (ret != -1) {
-                processInputByte(tmp);
+            // drain everything available in one read and parse it as a block
+            rxStreamBuffer.resize(io->bytesAvailable());
+            qint64 ret = io->read(rxStreamBuffer.data(), rxStreamBuffer.size());
+            if (ret <= 0) {
+                break;
+            }
+            processInputData((const quint8 *)rxStreamBuffer.constData(), (qint32)ret);
+        }
+
+        // devices like a mapped log replay hand out their packets in place
+        if (packetSource) {
+            const char *packet;
+            qint64 size;
+            packetSource->lockPackets();
+            while (packetSource->nextPacket(packet, size)) {
+                processInputData((const quint8 *)packet, (qint32)size);
+            }
+            packetSource->unlockPackets();
+        }
+    }
+}
+
+/**
+ * Parse received bytes and process every packet completed by them
+ */
+void UAVTalk::processInputData(const quint8 *data, qint32 length)
+{
+    while (length > 0) {
+        qint32 count = processInputBlock(data, length);
+        data   += count;
+        length -= count;
+        if (rxState == STATE_COMPLETE) {
+            mutex.lock();
+            if (receiveObject(rxType, rxObjId, rxInstId, rxBuffer, rxLength)) {
+                stats.rxObjectBytes += rxLength;
+                stats.rxObjects++;
             } else {
-                // TODOD
+                // TODO...
             }
-            if (rxState == STATE_COMPLETE) {
-                mutex.lock();
-                if (receiveObject(rxType, rxObjId, rxInstId, rxBuffer, rxLength)) {
-                    stats.rxObjectBytes += rxLength;
-                    stats.rxObjects++;
-                } else {
-                    // TODO...
-                }
-                mutex.unlock();
+            mutex.unlock();
 
-                if (useUDPMirror) {
-                    // it is safe to do this outside of the above critical section as the rxDataArray is
-                    // accessed from this thread only
-                    udpSocketTx->writeDatagram(rxDataArray, QHostAddress::LocalHost, udpSocketRx->localPort());
-                }
+            if (useUDPMirror) {
+                // it is safe to do this outside of the above critical section as the rxDataArray is
+                // accessed from this thread only
+                udpSocketTx->writeDatagram(rxDataArray, QHostAddress::LocalHost, udpSocketRx->localPort());
             }
         }
     }
 }
 
+/**
+ * Process a block of bytes from the telemetry stream.
+ * Inter packet garbage and object payloads are consumed as whole spans (sync search,
+ * block CRC and copy), the packet header is fed through processInputByte().
+ * Processing stops at the end of a packet so the caller can handle it.
+ * \param[in] data Received bytes
+ * \param[in] length Number of bytes in \a data, must be greater than zero
+ * \return Number of bytes consumed
+ */
+qint32 UAVTalk::processInputBlock(const quint8 *data, qint32 length)
+{
+    if (rxState == STATE_COMPLETE || rxState == STATE_ERROR) {
+        rxState = STATE_SYNC;
+
+        if (useUDPMirror) {
+            rxDataArray.clear();
+        }
+    }
+
+    qint32 count = 0;
+    if (rxState == STATE_SYNC) {
+        // skip everything up to the next sync byte
+        const quint8 *sync = (const quint8 *)memchr(data, SYNC_VAL, length);
+        count = sync ? (qint32)(sync - data) : length;
+        stats.rxSyncErrors += count;
+    } else if (rxState == STATE_DATA) {
+        // copy as much of the payload as is available
+        count = qMin(length, (qint32)rxLength - rxCount);
+        rxCS  = Crc::updateCRC(rxCS, data, count);
+        memcpy(&rxBuffer[rxCount], data, count);
+        rxCount += count;
+        if (rxCount >= rxLength) {
+            rxCount = 0;
+            rxState = STATE_CS;
+        }
+    }
+
+    if (count == 0) {
+        // header, checksum or sync byte
+        processInputByte(*data);
+        return 1;
+    }
+
+    // Update stats
+    stats.rxBytes  += count;
+    rxPacketLength += count;
+
+    if (useUDPMirror) {
+        rxDataArray.append((const char *)data, count);
+    }
+
+    return count;
+}
+
 /**
  * Process an byte from the telemetry stream.
  * \param[in] rxbyte Received byte
@@ -29,6 +29,7 @@
 
 #include "uavobjectmanager.h"
 #include "uavtalk_global.h"
+#include <utils/packetsource.h>
 
 #include <QtCore>
 #include <QIODevice>
@@ -112,6 +113,8 @@ private:
 
     // Variables
     QPointer<QIODevice> io;
+    // io when it hands out whole packets, only used while io is alive
+    Utils::PacketSource *packetSource;
 
     UAVObjectManager *objMngr;
 
@@ -145,9 +148,14 @@ private:
     QUdpSocket *udpSocketRx;
     QByteArray rxDataArray;
 
+    // block read from the io device
+    QByteArray rxStreamBuffer;
+
     // Methods
     bool objectTransaction(quint8 type, quint32 objId, quint16 instId, UAVObject *obj);
     bool processInputByte(quint8 rxbyte);
+    qint32 processInputBlock(const quint8 *data, qint32 length);
+    void processInputData(const quint8 *data, qint32 length);
     bool receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *data, qint32 length);
     UAVObject *updateObject(quint32 objId, quint16 instId, quint8 *data);
     void updateAck(quint8 type, quint32 objId, quint16 instId, UAVObject *obj);
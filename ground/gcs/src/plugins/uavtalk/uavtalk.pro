@@ -15,6 +15,7 @@ HEADERS += \
     uavtalk.h \
     uavtalkplugin.h \
     telemetrymonitor.h \
+    settingssnapshot.h \
     telemetrymanager.h \
     uavtalk_global.h \
     telemetry.h
@@ -23,6 +24,7 @@ SOURCES += \
     uavtalk.cpp \
     uavtalkplugin.cpp \
     telemetrymonitor.cpp \
+    settingssnapshot.cpp \
     telemetrymanager.cpp \
     telemetry.cpp
 
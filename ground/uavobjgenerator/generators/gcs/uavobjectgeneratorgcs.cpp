@@ -77,6 +77,8 @@ struct FieldContext {
     // field
     QString   fieldName;
     QString   fieldType;
+    // member of DataFields holding the value (field or field element)
+    QString   dataRef;
     // property
     QString   propName;
     QString   ucPropName;
@@ -219,6 +221,7 @@ QString generate(Context &ctxt, FieldContext &fieldCtxt, const QString &fragment
 
     str.replace(":fieldName", fieldCtxt.fieldName);
     str.replace(":fieldType", fieldCtxt.fieldType);
+    str.replace(":dataRef", fieldCtxt.dataRef);
     str.replace(":fieldDesc", fieldCtxt.field->description);
     str.replace(":fieldUnits", fieldCtxt.field->units);
     str.replace(":fieldLimitValues", fieldCtxt.field->limitValues);
@@ -379,8 +382,12 @@ void generateBaseProperty(Context &ctxt, FieldContext &fieldCtxt)
     ctxt.getters           += generate(ctxt, fieldCtxt, "    :propType :propName() const;\n");
     ctxt.setters           += generate(ctxt, fieldCtxt, "    void set:PropName(const :propRefType value);\n");
 
-    ctxt.notifications     += generate(ctxt, fieldCtxt, "    void :propNameChanged(const :propRefType value);\n");
-    ctxt.notificationsImpl += generate(ctxt, fieldCtxt, "    emit :propNameChanged(:propName());\n");
+    ctxt.notifications += generate(ctxt, fieldCtxt, "    void :propNameChanged(const :propRefType value);\n");
+
+    // only notify when the bytes of the value differ from the last notified data
+    QString notificationImpl = generate(ctxt, fieldCtxt,
+                                        "    if (memcmp(&previous.:dataRef, &current.:dataRef, sizeof(current.:dataRef)) != 0) {\n"
+                                        "        emit :propNameChanged(static_cast<:propType>(current.:dataRef));\n");
 
     if (DEPRECATED) {
         // generate deprecated property for retro compatibility
@@ -400,10 +407,12 @@ void generateBaseProperty(Context &ctxt, FieldContext &fieldCtxt)
             ctxt.notifications     += generate(ctxt, fieldCtxt,
                                                "    /*DEPRECATED*/ void :fieldNameChanged(:fieldType value);\n");
 
-            ctxt.notificationsImpl += generate(ctxt, fieldCtxt,
-                                               "    /*DEPRECATED*/ emit :fieldNameChanged(get:fieldName());\n");
+            notificationImpl += generate(ctxt, fieldCtxt,
+                                         "        /*DEPRECATED*/ emit :fieldNameChanged(current.:dataRef);\n");
         }
     }
+
+    ctxt.notificationsImpl += notificationImpl + "    }\n";
 }
 
 void generateSimpleProperty(Context &ctxt, FieldContext &fieldCtxt)
@@ -511,6 +520,7 @@ void generateIndexedProperty(Context &ctxt, FieldContext &fieldCtxt)
         elementCtxt.field       = fieldCtxt.field;
         elementCtxt.fieldName   = fieldCtxt.fieldName + "_" + elementName;
         elementCtxt.fieldType   = fieldCtxt.fieldType;
+        elementCtxt.dataRef     = QString("%1[%2]").arg(fieldCtxt.fieldName).arg(elementIndex);
         elementCtxt.propName    = fieldCtxt.propName + sep + elementName;
         elementCtxt.ucPropName  = fieldCtxt.ucPropName + sep + elementName;
         elementCtxt.propType    = fieldCtxt.propType;
@@ -640,6 +650,7 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo *object)
         // field properties
         fieldCtxt.fieldName  = field->name;
         fieldCtxt.fieldType  = fieldTypeStrCPP(field->type);
+        fieldCtxt.dataRef    = field->name;
 
         fieldCtxt.ucPropName = toPropertyName(field->name);
         fieldCtxt.propName   = toLowerCamelCase(fieldCtxt.ucPropName);